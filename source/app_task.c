@@ -60,6 +60,7 @@
 
 #ifdef GESTURE_MODEL
 #include "radar.h"
+#include "preproc_profile.h"
 #else
 #include "audio.h"
 #endif
@@ -235,6 +236,10 @@ static void on_command(IotclC2dEventData data) {
     const char * const DEMO_MODE_CMD = "demo-mode";
     const char * const SET_REPORTING_INTERVAL = "set-reporting-interval "; // with a space
     const char * const SET_LINGER_INTERVAL = "set-linger-interval "; // with a space
+#if defined(GESTURE_MODEL) && defined(PREPROC_PROFILING)
+    const char * const PREPROC_PROFILE_CMD = "preproc-profile";
+    const char * const PREPROC_BENCH_RANGE_FFT_CMD = "preproc-bench-range-fft";
+#endif
 
     bool command_success = false;
     const char * message = NULL;
@@ -277,6 +282,16 @@ static void on_command(IotclC2dEventData data) {
         		message = "Linger interval set";
         		command_success =  true;
         	}
+#if defined(GESTURE_MODEL) && defined(PREPROC_PROFILING)
+        } else if (0 == strcmp(PREPROC_PROFILE_CMD, command)) {
+            preproc_profile_print();
+            message = "Preprocessing profile printed";
+            command_success = true;
+        } else if (0 == strcmp(PREPROC_BENCH_RANGE_FFT_CMD, command)) {
+            radar_bench_range_fft(20);
+            message = "Range FFT benchmark printed";
+            command_success = true;
+#endif
         } else {
             printf("Unknown command \"%s\"\n", command);
             message = "Unknown command";
@@ -305,6 +320,49 @@ static cy_rslt_t publish_telemetry(void) {
     iotcl_telemetry_set_string(msg, "version", APP_VERSION);
     iotcl_telemetry_set_number(msg, "random", rand() % 100); // test some random numbers
     iotcl_telemetry_set_string(msg, "class", previous_detected_label ? previous_detected_label : "not-detected");    
+#if defined(GESTURE_MODEL) && defined(PREPROC_PROFILING)
+    // per-stage timing of the gesture feature extraction, in microseconds
+    uint32_t ticks_per_us = preproc_profile_ticks_per_us();
+    for (int stage = 0; stage < PROFILE_N_STAGES; stage++) {
+        profile_stats stats;
+        char name[40];
+        if (!preproc_profile_get_stats((profile_stage) stage, &stats)) {
+            continue;
+        }
+        snprintf(name, sizeof(name), "prof_%s_mean_us", preproc_profile_stage_name((profile_stage) stage));
+        iotcl_telemetry_set_number(msg, name, stats.mean / ticks_per_us);
+        snprintf(name, sizeof(name), "prof_%s_p99_us", preproc_profile_stage_name((profile_stage) stage));
+        iotcl_telemetry_set_number(msg, name, stats.p99 / ticks_per_us);
+    }
+#endif
+#if defined(GESTURE_MODEL) && defined(MOTION_GATE)
+    // frames skipped (hits) and fully processed (misses) by the motion gate
+    uint32_t gate_hits, gate_misses;
+    radar_get_motion_gate_stats(&gate_hits, &gate_misses);
+    iotcl_telemetry_set_number(msg, "gate_hits", gate_hits);
+    iotcl_telemetry_set_number(msg, "gate_misses", gate_misses);
+#endif
+#if defined(GESTURE_MODEL) && defined(RADAR_ASYNC_ACQUISITION)
+    // FIFO readout latency and the time spent in its interrupts
+    radar_acquisition_stats_s acq_stats;
+    radar_get_acquisition_stats(&acq_stats);
+    iotcl_telemetry_set_number(msg, "acq_latency_max_us", acq_stats.latency_max_us);
+    iotcl_telemetry_set_number(msg, "acq_isr_max_us", acq_stats.isr_max_us);
+    iotcl_telemetry_set_number(msg, "acq_overruns", acq_stats.overruns);
+    iotcl_telemetry_set_number(msg, "acq_drops", acq_stats.drops);
+#endif
+#if defined(GESTURE_MODEL) && defined(RDM_TELEMETRY)
+    // radar data manager losses and the current fill level / ring depth
+    radar_data_manager_stats_s rdm_stats;
+    radar_get_rdm_stats(&rdm_stats);
+    iotcl_telemetry_set_number(msg, "rdm_buffer_full", rdm_stats.buffer_full);
+    iotcl_telemetry_set_number(msg, "rdm_fifo_resets", rdm_stats.fifo_resets);
+    iotcl_telemetry_set_number(msg, "rdm_overruns", rdm_stats.overruns);
+    iotcl_telemetry_set_number(msg, "rdm_short_reads", rdm_stats.short_reads);
+    iotcl_telemetry_set_number(msg, "rdm_read_errors", rdm_stats.read_errors);
+    iotcl_telemetry_set_number(msg, "rdm_fill_level", rdm_stats.fill_level);
+    iotcl_telemetry_set_number(msg, "rdm_depth", rdm_stats.depth);
+#endif
     iotcl_mqtt_send_telemetry(msg, false);
     iotcl_telemetry_destroy(msg);
     return CY_RSLT_SUCCESS;
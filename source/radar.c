@@ -44,17 +44,27 @@
 #include "task.h"
 #include "queue.h"
 #include "timers.h"
+#include "semphr.h"
 
 #include "resource_map.h"
 
 #include "xensiv_bgt60trxx_mtb.h"
 #include "xensiv_radar_gestures.h"
 #include "xensiv_radar_data_management.h"
+#ifdef RADAR_ASYNC_ACQUISITION
+#include "radar_acquisition.h"
+#endif
 #define XENSIV_BGT60TRXX_CONF_IMPL
 #include "radar_settings.h"
 #include "gesture_lib.h"
 #include "preprocess.h"
 #include "octobertech.h"
+#include "frame_geometry.h"
+#include "scratch_arena.h"
+#include "preproc_profile.h"
+#ifdef SLIM_ALGO_FIXED_POINT
+#include "octobertech_q15.h"
+#endif
 
 /*******************************************************************************
 * Macros
@@ -68,6 +78,47 @@
 #define NUM_CHIRPS_PER_FRAME                XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME
 #define NUM_SAMPLES_PER_CHIRP               XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP
 
+/* With RADAR_CHIRP_STREAMING the FIFO interrupt fires every
+*  RADAR_CHIRPS_PER_GROUP chirps and the range FFT runs as the chirps arrive,
+*  otherwise it fires once per frame. */
+#ifdef RADAR_CHIRP_STREAMING
+#ifndef RADAR_CHIRPS_PER_GROUP
+#define RADAR_CHIRPS_PER_GROUP              (8)
+#endif
+#if (NUM_CHIRPS_PER_FRAME % RADAR_CHIRPS_PER_GROUP) != 0
+#error "RADAR_CHIRPS_PER_GROUP must divide the number of chirps per frame"
+#endif
+#define NUM_SAMPLES_PER_READ                (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP *\
+                                            RADAR_CHIRPS_PER_GROUP *\
+                                            XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
+#else
+#define NUM_SAMPLES_PER_READ                NUM_SAMPLES_PER_FRAME
+#endif
+
+/* The radar data manager ring holds at least RADAR_RDM_SLOTS readouts, two
+*  frames by default. Its storage is static and can be placed in a specific
+*  memory section (e.g. DMA reachable SRAM) by defining RADAR_RDM_SECTION. */
+#ifndef RADAR_RDM_SLOTS
+#define RADAR_RDM_SLOTS                     (2 * NUM_SAMPLES_PER_FRAME / NUM_SAMPLES_PER_READ)
+#endif
+#define RADAR_RDM_STORAGE_SIZE              RDM_STORAGE_SIZE(NUM_SAMPLES_PER_READ * 2, RADAR_RDM_SLOTS)
+
+/* With MOTION_GATE the hand features are only extracted for frames with
+*  motion in the range profile. Idle frames come out with the features of an
+*  empty scene (zero Doppler, no target), which are fed to the model if
+*  MOTION_GATE_IDLE_FEED is 1, or the model is skipped altogether. */
+#ifdef MOTION_GATE
+#if defined(SLIM_ALGO_FIXED_POINT)
+#error "MOTION_GATE is only available for the floating point slim_algo"
+#endif
+#define MOTION_GATE_THRESHOLD               (3.0f)
+#define MOTION_GATE_HOLD_FRAMES             (33)  /* ~1 s at 33 frames/s */
+#define MOTION_GATE_WARMUP_FRAMES           (33)
+#ifndef MOTION_GATE_IDLE_FEED
+#define MOTION_GATE_IDLE_FEED               (1)
+#endif
+#endif
+
 /* RTOS tasks */
 #define RADAR_TASK_NAME                     "radar_task"
 #define RADAR_TASK_STACK_SIZE               (configMINIMAL_STACK_SIZE * 10)
@@ -79,6 +130,15 @@
 /* Interrupt priorities */
 #define GPIO_INTERRUPT_PRIORITY             (6)
 
+#ifdef RADAR_ASYNC_ACQUISITION
+/* The FIFO readout runs as an SPI/DMA transfer, its completion interrupt has
+*  the priority of the FIFO interrupt so neither preempts the other */
+#define SPI_INTERRUPT_PRIORITY              GPIO_INTERRUPT_PRIORITY
+/* Burst read command of the FIFO (address 0x60 in bits 23:17, read,
+*  unbounded burst length), see the BGT60TR13C datasheet */
+#define XENSIV_BGT60TRXX_FIFO_BURST_CMD     {0xFFU, 0xC0U, 0x00U, 0x00U}
+#endif
+
 #define GESTURE_HOLD_TIME                   (10) /* count value used to hold gesture before evaluating new one */
 #define GESTURE_DETECTION_THRESHOLD         (0)
 
@@ -90,6 +150,9 @@ static void processing_task(void *pvParameters);
 
 static int32_t radar_init(void);
 static void xensiv_bgt60trxx_interrupt_handler(void* args, cyhal_gpio_event_t event);
+#ifdef RADAR_ASYNC_ACQUISITION
+static int32_t radar_acquisition_init_spi(void);
+#endif
 
 void get_time_from_millisec_radar(unsigned long milliseconds, char* output);
 
@@ -115,24 +178,67 @@ static xensiv_bgt60trxx_mtb_t bgt60_obj;
 static TaskHandle_t radar_task_handler;
 static TaskHandle_t processing_task_handle;
 radar_data_manager_s mgr;
-
-float32_t gesture_frame[NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS];
-
+#ifdef RADAR_RDM_SECTION
+CY_SECTION(RADAR_RDM_SECTION)
+#endif
+CY_ALIGN(RDM_STORAGE_ALIGN) static uint8_t rdm_storage[RADAR_RDM_STORAGE_SIZE];
+/* Taken by radar_task before it writes the range images of a frame (before
+*  the first chirp group with RADAR_CHIRP_STREAMING), given back by
+*  processing_task once it is done with them */
+static SemaphoreHandle_t range_image_free;
+
+#ifdef SLIM_ALGO_FIXED_POINT
+preproc_octobertech_q15_work_arrays work_arrays;
+#else
 preproc_octobertech_work_arrays work_arrays;
+#endif
+#ifdef PREPROC_STATIC_GEOMETRY
+frame_cfg f_cfg = FRAME_CFG_INIT;
+#else
 frame_cfg f_cfg = {
         .n_channels = 3,
         .n_chirps = 32,
         .n_samples = 64,
         .n_range_bins = 32};
+#endif
+
+#ifdef MOTION_GATE
+static motion_gate gate;
+#endif
 
 ce_state_s ce_app_state;
 volatile bool is_settings_mode = false;
-cyhal_lptimer_t lptimer_obj;
-uint32_t before;
-uint32_t after;
 
 static int last_detected_gesture_index = 0;
 
+#ifdef RDM_TELEMETRY
+/* Readout and overflow statistics of the radar data manager */
+void radar_get_rdm_stats(radar_data_manager_stats_s *stats) {
+    mgr.get_buffer_stats(stats);
+}
+#endif
+
+#ifdef MOTION_GATE
+/* Frames short-circuited by the motion gate (hits) and fully processed
+*  (misses) since start-up */
+void radar_get_motion_gate_stats(uint32_t *hits, uint32_t *misses) {
+    *hits = gate.hits;
+    *misses = gate.misses;
+}
+#endif
+
+#ifdef PREPROC_PROFILING
+/* Runs `preproc_profile_bench_range_fft()` on the frame geometry while no
+*  frame is processed: holding the range images keeps radar_task from starting
+*  the next frame, so the benchmark and the profiled frame timings do not skew
+*  each other. Readouts meanwhile wait in the radar data manager ring. */
+void radar_bench_range_fft(uint16_t n_runs) {
+    xSemaphoreTake(range_image_free, portMAX_DELAY);
+    preproc_profile_bench_range_fft(NUM_SAMPLES_PER_CHIRP, NUM_CHIRPS_PER_FRAME, n_runs);
+    xSemaphoreGive(range_image_free);
+}
+#endif
+
 const char* get_last_detected_label(void) {
     const char* class_map[] = IMAI_SYMBOL_MAP;
     const char* ret = last_detected_gesture_index > 0 ? class_map[last_detected_gesture_index] : NULL;
@@ -153,56 +259,33 @@ const char* get_last_detected_label(void) {
 *  samples_ub: maximum number of samples to be copied at a time from owner task/caller
 *
 * Return:
-*  int32_t: 0 if success
+*  int32_t: 0 if success, -2 if samples_ub leaves no room for a read, -3
+*  (RDM_EIO) if the radar FIFO could not be read
 *
 *******************************************************************************/
 int32_t read_radar_data(uint16_t* data, uint32_t *num_samples, uint32_t samples_ub)
 {
+    if (samples_ub < NUM_SAMPLES_PER_READ *2)
+    {
+        /* Software buffer full, drop the data in the radar FIFO */
+        *num_samples = 0;
+        xensiv_bgt60trxx_soft_reset(&bgt60_obj.dev, XENSIV_BGT60TRXX_RESET_FIFO);
+        mgr.report(RDM_EVENT_FIFO_RESET);
+        return -2;
+    }
+
+    *num_samples = 0;
     if (xensiv_bgt60trxx_get_fifo_data(&bgt60_obj.dev,
             data,
-            NUM_SAMPLES_PER_FRAME) == XENSIV_BGT60TRXX_STATUS_OK)
+            NUM_SAMPLES_PER_READ) != XENSIV_BGT60TRXX_STATUS_OK)
     {
-        *num_samples = NUM_SAMPLES_PER_FRAME *2; /* in bytes */
-
-        if (samples_ub < NUM_SAMPLES_PER_FRAME *2)
-        {
-            xensiv_bgt60trxx_soft_reset(&bgt60_obj.dev, XENSIV_BGT60TRXX_RESET_FIFO);
-        }
+        /* Counted as read error by the radar data manager */
+        return RDM_EIO;
     }
 
-    return 0;
-}
-
-
-/*******************************************************************************
-* Function Name: deinterleave_antennas
-********************************************************************************
-* Summary:
-* This function de-interleaves multiple antennas data from single radar HW FIFO
-*
-* Parameters:
-*  void
-*
-* Return:
-*  none
-*
-*******************************************************************************/
-void deinterleave_antennas(uint16_t * buffer_ptr)
-{
-    uint8_t antenna = 0;
-    int32_t index = 0;
-    static const float norm_factor = 1.0f;
+    *num_samples = NUM_SAMPLES_PER_READ *2; /* in bytes */
 
-    for (int i = 0; i < (NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS); ++i)
-    {
-        gesture_frame[index + antenna * NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME] = buffer_ptr[i] * norm_factor;
-        antenna++;
-        if (antenna == XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
-        {
-            antenna = 0;
-            index++;
-        }
-    }
+    return 0;
 }
 
 
@@ -216,10 +299,13 @@ void deinterleave_antennas(uint16_t * buffer_ptr)
 *    3. Initializes gesture library
 *    4. In an infinite loop
 *       - Waits for interrupt from radar device indicating availability of data
-*       - Read from software buffer the raw radar frame
-*       - De-interleaves the radar data frame
+*       - Waits until processing task is done with the previous range images
+*       - Read from software buffer the raw radar frame (or chirp group with
+*         RADAR_CHIRP_STREAMING), unpacked here from the 12-bit FIFO words
+*         with RADAR_ASYNC_ACQUISITION as the only subscriber
+*       - Builds the range images directly from the raw data
 *       - Acknowledges the radar data manager the consumption of read data
-*       - Sends notification to processing task
+*       - Sends notification to processing task once the frame is complete
 * Parameters:
 *  pvParameters: unused
 *
@@ -233,6 +319,16 @@ void radar_task(void *pvParameters)
     uint32_t sz;
 
     uint16_t *data_buff = NULL;
+#ifdef RADAR_CHIRP_STREAMING
+    uint16_t first_chirp = 0;
+#endif
+
+    range_image_free = xSemaphoreCreateBinary();
+    if (range_image_free == NULL)
+    {
+        CY_ASSERT(0);
+    }
+    xSemaphoreGive(range_image_free);
 
     if (xTaskCreate(processing_task, PROCESSING_TASK_NAME, PROCESSING_TASK_STACK_SIZE, NULL, PROCESSING_TASK_PRIORITY, &processing_task_handle) != pdPASS)
     {
@@ -261,22 +357,86 @@ void radar_task(void *pvParameters)
     /* Init Imagimob AI model */
     IMAI_RED_init();
     /* Init preprocessing */
-    work_arrays = new_preproc_octobertech_work_arrays(&f_cfg);
+#ifdef PREPROC_PROFILING
+    preproc_profile_init();
+    /* The float FFT plans of radar_bench_range_fft(), also needed with the
+    *  fixed-point slim_algo */
+    init_fft_plans(&f_cfg);
+#endif
+#ifdef SLIM_ALGO_FIXED_POINT
+    work_arrays = new_preproc_octobertech_q15_work_arrays(&f_cfg);
+#else
+    /* Only slim_algo runs on target, plan the work arrays for it alone */
+    work_arrays = new_preproc_octobertech_work_arrays_for(&f_cfg, PREPROC_VARIANT_SLIM);
+    printf("Preprocessing memory: %lu bytes\r\n",
+           (unsigned long)preproc_octobertech_peak_bytes(&f_cfg, PREPROC_VARIANT_SLIM));
+#endif
+#ifdef MOTION_GATE
+    gate = new_motion_gate(MOTION_GATE_THRESHOLD, MOTION_GATE_HOLD_FRAMES, MOTION_GATE_WARMUP_FRAMES);
+#endif
 
     for(;;)
     {
+#ifdef RADAR_CHIRP_STREAMING
+        /* Wait for the GPIO interrupt to indicate that another chirp group is
+        *  available, consume the notifications one by one so no group is lost */
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+        if (first_chirp == 0)
+        {
+            /* Do not overwrite range images still used by processing_task */
+            xSemaphoreTake(range_image_free, portMAX_DELAY);
+        }
+
+        mgr.read_from_buffer(1, &data_buff, &sz);
+#ifdef RADAR_ASYNC_ACQUISITION
+        radar_acquisition_unpack12((const uint8_t *)data_buff, data_buff, NUM_SAMPLES_PER_READ);
+#endif
+
+        /* De-interleave, normalize, window and range FFT of the chirp group */
+        PREPROC_PROFILE_BEGIN(t_range_fft);
+#ifdef SLIM_ALGO_FIXED_POINT
+        slim_algo_q15_push_chirps(data_buff, first_chirp, RADAR_CHIRPS_PER_GROUP, &f_cfg, &work_arrays);
+#else
+        slim_algo_push_chirps(data_buff, first_chirp, RADAR_CHIRPS_PER_GROUP, &f_cfg, &work_arrays);
+#endif
+        PREPROC_PROFILE_END(PROFILE_STAGE_RANGE_FFT, t_range_fft);
+
+        mgr.ack_data_read(1);
+
+        first_chirp += RADAR_CHIRPS_PER_GROUP;
+        if (first_chirp == NUM_CHIRPS_PER_FRAME)
+        {
+            first_chirp = 0;
+            /* Tell processing task to take over */
+            xTaskNotifyGive(processing_task_handle);
+        }
+#else
         /* Wait for the GPIO interrupt to indicate that another slice is available */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
+        /* Do not overwrite range images still used by processing_task */
+        xSemaphoreTake(range_image_free, portMAX_DELAY);
+
         mgr.read_from_buffer(1, &data_buff, &sz);
+#ifdef RADAR_ASYNC_ACQUISITION
+        radar_acquisition_unpack12((const uint8_t *)data_buff, data_buff, NUM_SAMPLES_PER_READ);
+#endif
 
-        deinterleave_antennas(data_buff);
+        /* De-interleave, normalize, window and range FFT in one pass */
+        PREPROC_PROFILE_BEGIN(t_range_fft);
+#ifdef SLIM_ALGO_FIXED_POINT
+        slim_algo_q15_load_raw_frame(data_buff, &f_cfg, &work_arrays);
+#else
+        slim_algo_load_raw_frame(data_buff, &f_cfg, &work_arrays);
+#endif
+        PREPROC_PROFILE_END(PROFILE_STAGE_RANGE_FFT, t_range_fft);
 
         mgr.ack_data_read(1);
 
         /* Tell processing task to take over */
         xTaskNotifyGive(processing_task_handle);
-
+#endif
     }
 }
 
@@ -311,24 +471,56 @@ void processing_task(void *pvParameters)
     {
         /* Wait for frame data available to process */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        /* pass on the de-interleaved data on to Algorithmic kernel */
+        /* pass on the range images on to Algorithmic kernel */
+        PREPROC_PROFILE_BEGIN(t_frame);
 
         float model_in[IMAI_DATA_IN_COUNT];
         uint16_t min_range_bin = 3;
         slim_algo_output res;
-        slim_algo(&res, gesture_frame, &f_cfg, min_range_bin, &work_arrays);
+#ifdef PREPROC_HEAP_DEBUG
+        uint32_t heap_calls = preproc_get_heap_calls();
+#endif
+#ifdef SLIM_ALGO_FIXED_POINT
+        slim_algo_q15_from_range_image(&res, &f_cfg, min_range_bin, &work_arrays);
+#elif defined(MOTION_GATE)
+        bool motion = slim_algo_gated_from_range_image(&res, &f_cfg, min_range_bin, &work_arrays, &gate);
+#else
+        slim_algo_from_range_image(&res, &f_cfg, min_range_bin, &work_arrays);
+#endif
+        xSemaphoreGive(range_image_free);
+        /* All frame temporaries are dropped, the arena stays reserved */
+        scratch_reset();
+#ifdef PREPROC_HEAP_DEBUG
+        /* Steady-state frames must not use the heap */
+        CY_ASSERT(preproc_get_heap_calls() == heap_calls);
+#endif
         model_in[0] = ((float)res.detection.range_bin - norm_mean[0]) / norm_scale[0];
         model_in[1] = ((float)res.detection.doppler_bin - norm_mean[1]) / norm_scale[1];
         model_in[2] = ((float)res.detection.azimuth - norm_mean[2]) / norm_scale[2];
         model_in[3] = ((float)res.detection.elevation - norm_mean[3]) / norm_scale[3];
         model_in[4] = ((float)res.detection.value - norm_mean[4]) / norm_scale[4];
 
+#if defined(MOTION_GATE) && MOTION_GATE_IDLE_FEED
+        (void)motion;
+#elif defined(MOTION_GATE)
+        if (!motion)
+        {
+            /* Idle frame, the model is not run */
+            PREPROC_PROFILE_END(PROFILE_STAGE_FRAME, t_frame);
+            taskYIELD();
+            continue;
+        }
+#endif
+
+        PREPROC_PROFILE_BEGIN(t_model);
         int imai_result_enqueue = IMAI_RED_enqueue(model_in);
         if (IMAI_RET_SUCCESS != imai_result_enqueue)
         {
             printf("Insufficient memory to enqueue sensor data. Inferencing is not keeping up.\n");
         }
         int imai_result = IMAI_RED_dequeue(model_out);
+        PREPROC_PROFILE_END(PROFILE_STAGE_MODEL, t_model);
+        PREPROC_PROFILE_END(PROFILE_STAGE_FRAME, t_frame);
         int pred_idx = 0;
 
         switch (imai_result)
@@ -432,7 +624,7 @@ static int32_t radar_init(void)
     }
 
     if (xensiv_bgt60trxx_mtb_interrupt_init(&bgt60_obj,
-                                            NUM_SAMPLES_PER_FRAME*2,
+                                            NUM_SAMPLES_PER_READ*2,
                                             PIN_XENSIV_BGT60TRXX_IRQ,
                                             GPIO_INTERRUPT_PRIORITY,
                                             xensiv_bgt60trxx_interrupt_handler,
@@ -442,6 +634,14 @@ static int32_t radar_init(void)
         return -1;
     }
 
+#ifdef RADAR_ASYNC_ACQUISITION
+    if (radar_acquisition_init_spi() != 0)
+    {
+        printf("[MSG] ERROR: radar_acquisition_init_spi failed\n");
+        return -1;
+    }
+#endif
+
     return 0;
 }
 
@@ -470,9 +670,126 @@ static void xensiv_bgt60trxx_interrupt_handler(void *args, cyhal_gpio_irq_event_
     CY_UNUSED_PARAMETER(args);
     CY_UNUSED_PARAMETER(event);
 
+#ifdef RADAR_ASYNC_ACQUISITION
+    radar_acquisition_fifo_irq();
+#else
     mgr.run(true);
+#endif
 }
 
+#ifdef RADAR_ASYNC_ACQUISITION
+/*******************************************************************************
+* Function Name: radar_spi_start_read
+********************************************************************************
+* Summary:
+* Starts the burst read of n_bytes of packed FIFO data. Only the 4-byte burst
+* command is sent synchronously, the data phase is an asynchronous DMA
+* transfer that ends in radar_spi_event_handler().
+*
+*******************************************************************************/
+static int32_t radar_spi_start_read(void *ctx, uint8_t *rx, uint32_t n_bytes)
+{
+    static const uint8_t burst_cmd[] = XENSIV_BGT60TRXX_FIFO_BURST_CMD;
+    CY_UNUSED_PARAMETER(ctx);
+
+    cyhal_gpio_write(PIN_XENSIV_BGT60TRXX_SPI_CSN, false);
+
+    if ((cyhal_spi_transfer(&spi_obj, burst_cmd, sizeof(burst_cmd), NULL, 0, 0xFF) != CY_RSLT_SUCCESS) ||
+        (cyhal_spi_transfer_async(&spi_obj, NULL, 0, rx, n_bytes) != CY_RSLT_SUCCESS))
+    {
+        cyhal_gpio_write(PIN_XENSIV_BGT60TRXX_SPI_CSN, true);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void radar_spi_reset_fifo(void *ctx)
+{
+    CY_UNUSED_PARAMETER(ctx);
+    xensiv_bgt60trxx_soft_reset(&bgt60_obj.dev, XENSIV_BGT60TRXX_RESET_FIFO);
+    mgr.report(RDM_EVENT_FIFO_RESET);
+}
+
+static void radar_spi_overrun(void)
+{
+    mgr.report(RDM_EVENT_OVERRUN);
+}
+
+static uint32_t radar_spi_now(void *ctx)
+{
+    CY_UNUSED_PARAMETER(ctx);
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: radar_spi_event_handler
+********************************************************************************
+* Summary:
+* SPI interrupt at the end of the FIFO data transfer. Releases the chip
+* select and hands the samples over to the radar data manager.
+*
+*******************************************************************************/
+static void radar_spi_event_handler(void *callback_arg, cyhal_spi_event_t event)
+{
+    CY_UNUSED_PARAMETER(callback_arg);
+
+    if ((event & (CYHAL_SPI_IRQ_DONE | CYHAL_SPI_IRQ_ERROR)) != 0)
+    {
+        cyhal_gpio_write(PIN_XENSIV_BGT60TRXX_SPI_CSN, true);
+        radar_acquisition_transfer_done((event & CYHAL_SPI_IRQ_ERROR) == 0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_init_spi
+********************************************************************************
+* Summary:
+* Switches the SPI to DMA transfers and connects the asynchronous readout to
+* the radar data manager.
+*
+* Return:
+*  Success or error
+*
+*******************************************************************************/
+static int32_t radar_acquisition_init_spi(void)
+{
+    const radar_acquisition_backend_s backend = {
+        .start_read = radar_spi_start_read,
+        .reset_fifo = radar_spi_reset_fifo,
+        .now = radar_spi_now,
+        .ticks_per_us = SystemCoreClock / 1000000U,
+        .ctx = NULL
+    };
+    const radar_acquisition_sink_s sink = {
+        .reserve = mgr.reserve,
+        .commit = mgr.commit,
+        .overrun = radar_spi_overrun
+    };
+
+    /* Cycle counter for the latency statistics */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    if (cyhal_spi_set_async_mode(&spi_obj, CYHAL_ASYNC_DMA, CYHAL_DMA_PRIORITY_DEFAULT) != CY_RSLT_SUCCESS)
+    {
+        printf("[MSG] ERROR: cyhal_spi_set_async_mode failed\n");
+        return -1;
+    }
+
+    cyhal_spi_register_callback(&spi_obj, radar_spi_event_handler, NULL);
+    cyhal_spi_enable_event(&spi_obj, (cyhal_spi_event_t)(CYHAL_SPI_IRQ_DONE | CYHAL_SPI_IRQ_ERROR),
+                           SPI_INTERRUPT_PRIORITY, true);
+
+    return radar_acquisition_init(&backend, &sink, NUM_SAMPLES_PER_READ);
+}
+
+/* Statistics of the asynchronous FIFO readout */
+void radar_get_acquisition_stats(radar_acquisition_stats_s *stats) {
+    radar_acquisition_get_stats(stats);
+}
+#endif
+
 /*******************************************************************************
  * Function Name: create_radar_task
  ********************************************************************************
@@ -493,8 +810,11 @@ cy_rslt_t create_radar_task(void)
     printf("****************** IMAGIMOB Ready Model Gesture Code Example ****************** \r\n\n");
 
     mgr.in_read_radar_data = read_radar_data;
-    radar_data_manager_init(&mgr, NUM_SAMPLES_PER_FRAME *6, NUM_SAMPLES_PER_FRAME *2);
-    radar_data_manager_set_malloc_free(pvPortMalloc, vPortFree);
+    if (radar_data_manager_init_static(&mgr, rdm_storage, sizeof(rdm_storage),
+                                       NUM_SAMPLES_PER_READ *2) != 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
 
     /* Create the RTOS task */
     status = xTaskCreate(radar_task, RADAR_TASK_NAME,
@@ -48,11 +48,29 @@
 #include "cyhal.h"
 #include "cy_result.h"
 #include "stdio.h"
+#ifdef RDM_TELEMETRY
+#include "xensiv_radar_data_management.h"
+#endif
+#ifdef RADAR_ASYNC_ACQUISITION
+#include "radar_acquisition.h"
+#endif
 
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
 cy_rslt_t create_radar_task(void);
 const char* get_last_detected_label(void);
+#ifdef RDM_TELEMETRY
+void radar_get_rdm_stats(radar_data_manager_stats_s *stats);
+#endif
+#ifdef MOTION_GATE
+void radar_get_motion_gate_stats(uint32_t *hits, uint32_t *misses);
+#endif
+#ifdef PREPROC_PROFILING
+void radar_bench_range_fft(uint16_t n_runs);
+#endif
+#ifdef RADAR_ASYNC_ACQUISITION
+void radar_get_acquisition_stats(radar_acquisition_stats_s *stats);
+#endif
 
 #endif /* RADAR_H_ */
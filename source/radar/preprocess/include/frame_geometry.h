@@ -0,0 +1,100 @@
+
+/******************************************************************************
+* File Name:   frame_geometry.h
+*
+* Description: This file contains the frame geometry accessors used by the
+*   preprocessing kernels. With PREPROC_STATIC_GEOMETRY the geometry is taken
+*   from radar_settings.h at compile time, otherwise from `frame_cfg`.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef IFXGESTURE_PREPROCESS_FRAME_GEOMETRY_H_
+#define IFXGESTURE_PREPROCESS_FRAME_GEOMETRY_H_
+
+#include "preprocess.h"
+
+#if defined(PREPROC_STATIC_GEOMETRY)
+
+#include "radar_settings.h"
+
+/* The radar configuration is the single source of the frame geometry. The
+*  kernels below see constant trip counts and the `frame_cfg` passed at run
+*  time is only checked against it by `frame_cfg_check()`. */
+#define FRAME_CHANNELS      (XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
+#define FRAME_CHIRPS        (XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME)
+#define FRAME_SAMPLES       (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP)
+#define FRAME_RANGE_BINS    (FRAME_SAMPLES / 2)
+
+#define FRAME_IS_POW2(n)    (((n) > 0) && (((n) & ((n) - 1)) == 0))
+
+_Static_assert(FRAME_CHANNELS == 3,
+    "slim_algo monopulse needs exactly three receive antennas");
+_Static_assert(FRAME_IS_POW2(FRAME_SAMPLES) && (FRAME_SAMPLES >= 32) &&
+    (FRAME_SAMPLES <= 4096), "range FFT length not supported by CMSIS rfft");
+_Static_assert(FRAME_IS_POW2(FRAME_CHIRPS) && (FRAME_CHIRPS >= 16) &&
+    (FRAME_CHIRPS <= 4096), "Doppler FFT length not supported by CMSIS cfft");
+_Static_assert(FRAME_CHIRPS <= RDI_MAX_CHIRPS,
+    "Doppler column does not fit the range-Doppler stack buffer");
+_Static_assert(FRAME_CHIRPS <= PEAK_ENGINE_MAX_BINS,
+    "Doppler profile does not fit the peak engine buffers");
+
+#define FRAME_N_CHANNELS(cfg)   ((void)(cfg), (uint16_t)FRAME_CHANNELS)
+#define FRAME_N_CHIRPS(cfg)     ((void)(cfg), (uint16_t)FRAME_CHIRPS)
+#define FRAME_N_SAMPLES(cfg)    ((void)(cfg), (uint16_t)FRAME_SAMPLES)
+#define FRAME_N_RANGE_BINS(cfg) ((void)(cfg), (uint16_t)FRAME_RANGE_BINS)
+
+/* Initializer of the `frame_cfg` matching the compiled geometry. */
+#define FRAME_CFG_INIT {                \
+        .n_channels = FRAME_CHANNELS,   \
+        .n_chirps = FRAME_CHIRPS,       \
+        .n_samples = FRAME_SAMPLES,     \
+        .n_range_bins = FRAME_RANGE_BINS}
+
+#else
+
+#define FRAME_N_CHANNELS(cfg)   ((cfg)->n_channels)
+#define FRAME_N_CHIRPS(cfg)     ((cfg)->n_chirps)
+#define FRAME_N_SAMPLES(cfg)    ((cfg)->n_samples)
+#define FRAME_N_RANGE_BINS(cfg) ((cfg)->n_range_bins)
+
+#endif
+
+/* Aborts if `f_cfg` does not match the compiled geometry. No-op for the
+*  generic runtime geometry. */
+void frame_cfg_check(const frame_cfg *f_cfg);
+
+#endif
@@ -42,7 +42,9 @@
 
 #ifndef IFXGESTURE_PREPROCESS_OCTOBERTECH_H_
 #define IFXGESTURE_PREPROCESS_OCTOBERTECH_H_
+#ifndef max
 #define max(x,y) (((x) >= (y)) ? (x) : (y))
+#endif
 
 #include "preprocess.h"
 
@@ -72,33 +74,74 @@ typedef struct {
     bool success;
     super_slim_algo_detection detection;
 } super_slim_algo_output;
+/* Noise floor adaptation rates of the motion gate, for frames below and
+*  above the floor */
+#define MOTION_GATE_ALPHA_DOWN  (0.1f)
+#define MOTION_GATE_ALPHA_UP    (0.005f)
+
+/* Early exit of `slim_algo_gated_from_range_image()` on frames without
+*  motion. Use `new_motion_gate()` to create an instance. */
+typedef struct {
+    float threshold;
+    float alpha_down;
+    float alpha_up;
+    uint16_t hold_frames;
+    uint16_t warmup_frames;
+    /* Range profile energy of an idle frame and of the last frame */
+    float noise_floor;
+    float energy;
+    uint16_t hold;
+    uint16_t n_frames;
+    /* Frames short-circuited (hits) and fully processed (misses) */
+    uint32_t hits;
+    uint32_t misses;
+} motion_gate;
+
+/* Algorithm variants the work arrays are planned for (bit mask). The full
+*  RDI `algo()` uses the scratch arena only, it is listed for the memory
+*  report of `preproc_octobertech_peak_bytes()`. */
+#define PREPROC_VARIANT_SLIM        (1u << 0)
+#define PREPROC_VARIANT_SUPER_SLIM  (1u << 1)
+#define PREPROC_VARIANT_RDI         (1u << 2)
+
 /*Structure to hold intermediate arrays for the octobertech slim_algo 
 * processing. Use `new_preproc_octobertech_work_arrays()` to create an
 * instance, and `free_preproc_octobertech_work_arrays()` to free up the
-* arrays. */
+* arrays. Arrays with disjoint lifetimes share storage, arrays not used by
+* the planned variants are NULL. */
 typedef struct {
     /* Half frame (hfr): n_channels * n_chirps * n_range_bins */
     ifx_cf64_t *x_range;
     ifx_cf64_t *x_range_keep;
-    ifx_f32_t *x_range_abs;
-    /* Image (img): n_chirps * n_range_bins */
-    ifx_f32_t *x_range_abs_mean;
+    /* Chan. x range bins (crb): n_channels * n_range_bins, sum over chirps
+    *  accumulated with the range FFT, valid if `x_range_sum_ready` */
+    ifx_cf64_t *x_range_sum;
+    bool x_range_sum_ready;
     /* Chan. x chirps (cch): n_channels * n_chirps */
-    ifx_cf64_t *x_range_slice;
     ifx_cf64_t *x_doppler;
-    ifx_f32_t *x_doppler_abs;
+    ifx_f32_t *phases;
     /* Chirps (chr): n_chirps */
-    ifx_f32_t *doppler_window;
     ifx_f32_t *doppler_profile;
     /* Range bins (rbn): n_range_bins */
     ifx_f32_t *range_profile;
-    /* Samples (smp): n_samples */
-    ifx_f32_t *range_window;
+    /* Windows in flash: Doppler (no table below 16 chirps) and range with
+    *  the ADC normalization folded in */
+    window_view doppler_window;
+    window_view range_window;
+    /* The arrays above alias into one block, laid out for `variants` */
+    void *block;
+    uint32_t block_size;
+    uint32_t variants;
 } preproc_octobertech_work_arrays;
 
 preproc_octobertech_work_arrays
 new_preproc_octobertech_work_arrays(frame_cfg *f_cfg);
 
+preproc_octobertech_work_arrays
+new_preproc_octobertech_work_arrays_for(frame_cfg *f_cfg, uint32_t variants);
+
+uint32_t preproc_octobertech_peak_bytes(const frame_cfg *f_cfg, uint32_t variants);
+
 void free_preproc_octobertech_work_arrays(
     preproc_octobertech_work_arrays *arrays
 );
@@ -107,6 +150,30 @@ void slim_algo(
     slim_algo_output *out, ifx_f32_t *x_frame, frame_cfg *f_cfg,
     uint16_t min_range_bin, preproc_octobertech_work_arrays *arr
 );
+void slim_algo_load_raw_frame(
+    const uint16_t *raw_frame, frame_cfg *f_cfg,
+    preproc_octobertech_work_arrays *arr
+);
+
+void slim_algo_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_work_arrays *arr
+);
+
+motion_gate new_motion_gate(float threshold, uint16_t hold_frames, uint16_t warmup_frames);
+
+bool slim_algo_gated_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_work_arrays *arr, motion_gate *gate
+);
+
+void slim_algo_push_chirps(
+    const uint16_t *raw_chirps, uint16_t first_chirp, uint16_t n_group_chirps,
+    frame_cfg *f_cfg, preproc_octobertech_work_arrays *arr
+);
+
+uint32_t slim_algo_scratch_size(const frame_cfg *f_cfg);
+
 uint32_t filter_range_profile(ifx_f32_t *range_profile, int32_t len, uint32_t peak_range);
 
 void super_slim_algo(
@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name:   octobertech_q15.h
+*
+* Description: This file contains the function prototypes and constants used
+*   in octobertech_q15.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef IFXGESTURE_PREPROCESS_OCTOBERTECH_Q15_H_
+#define IFXGESTURE_PREPROCESS_OCTOBERTECH_Q15_H_
+
+#include "octobertech.h"
+
+/* Fixed-point variant of `slim_algo`.
+*
+* The range FFT runs in q31 and the range images are stored in q15, the
+* Doppler FFT of the selected range bin runs in q31. All scaling factors are
+* tracked so that `slim_algo_output` is reported in the same units as the
+* float32 pipeline.
+*
+* Error bound versus the float32 `slim_algo` (12 bit ADC, 64 samples, Hann
+* range window, 32 chirps, Kaiser Doppler window):
+*  - One q15 LSB of the range image corresponds to 1.6e-5 in float units, so
+*    `detection.value` and the range profile differ by less than 3e-5
+*    (absolute).
+*  - `range_bin` and `doppler_bin` are identical unless two candidates in the
+*    profile are closer than that bound.
+*  - `azimuth` and `elevation` differ by less than 1e-3 rad for detections
+*    with `value` > 0.01.
+*/
+
+/* The bound above, checked by test/q15_accuracy.c */
+#define Q15_BOUND_VALUE (3e-5f)
+#define Q15_BOUND_ANGLE (1e-3f)
+#define Q15_BOUND_MIN_VALUE (0.01f)
+
+/* Extra gain applied to the range FFT output before it is stored as q15. The
+*  q31 range FFT is scaled by 1/n_samples, a full-scale windowed chirp stays
+*  below 1/8 of the q15 range, so 2 bits keep headroom for the mean removal. */
+#define Q15_RANGE_HEADROOM_SHIFT (2)
+
+/*Structure to hold intermediate arrays and FFT instances for the fixed-point
+* `slim_algo`. Use `new_preproc_octobertech_q15_work_arrays()` to create an
+* instance, and `free_preproc_octobertech_q15_work_arrays()` to free up the
+* arrays. */
+typedef struct {
+    /* Half frame (hfr): n_channels * n_chirps * n_range_bins, complex q15 */
+    q15_t *x_range;
+    /* Chan. x range bins (crb): n_channels * n_range_bins, complex sum over
+    *  chirps */
+    int32_t *range_sum;
+    /* Chan. x chirps (cch): n_channels * n_chirps, complex q31 */
+    q31_t *x_doppler;
+    /* Chirps (chr): n_chirps */
+    q31_t *doppler_window;
+    q31_t *x_doppler_abs;
+    ifx_f32_t *doppler_profile;
+    /* Range bins (rbn): n_range_bins */
+    q15_t *x_range_abs;
+    int32_t *range_acc;
+    ifx_f32_t *range_profile;
+    /* Samples (smp): n_samples, chirp FFT output is 2 * n_samples */
+    q31_t *range_window;
+    q31_t *chirp_buffer;
+    q31_t *chirp_fft;
+    /* FFT instances, built once */
+    arm_rfft_instance_q31 range_fft;
+    arm_cfft_instance_q31 doppler_fft;
+    /* Scaling of the fixed-point data relative to the float32 pipeline */
+    int32_t sample_gain;
+    ifx_f32_t range_scale;
+    ifx_f32_t doppler_scale;
+} preproc_octobertech_q15_work_arrays;
+
+preproc_octobertech_q15_work_arrays
+new_preproc_octobertech_q15_work_arrays(frame_cfg *f_cfg);
+
+void free_preproc_octobertech_q15_work_arrays(
+    preproc_octobertech_q15_work_arrays *arrays
+);
+
+void slim_algo_q15_load_raw_frame(
+    const uint16_t *raw_frame, frame_cfg *f_cfg,
+    preproc_octobertech_q15_work_arrays *arr
+);
+
+void slim_algo_q15_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_q15_work_arrays *arr
+);
+
+void slim_algo_q15_push_chirps(
+    const uint16_t *raw_chirps, uint16_t first_chirp, uint16_t n_group_chirps,
+    frame_cfg *f_cfg, preproc_octobertech_q15_work_arrays *arr
+);
+
+#endif
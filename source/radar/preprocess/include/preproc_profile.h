@@ -0,0 +1,106 @@
+
+/******************************************************************************
+* File Name:   preproc_profile.h
+*
+* Description: This file contains the function prototypes and constants used
+*   in preproc_profile.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef IFXGESTURE_PREPROCESS_PROFILE_H_
+#define IFXGESTURE_PREPROCESS_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Stages of the gesture feature extraction that are timed when
+*  PREPROC_PROFILING is defined. */
+typedef enum {
+    PROFILE_STAGE_RANGE_FFT,
+    PROFILE_STAGE_REMOVE_MEAN,
+    PROFILE_STAGE_RANGE_PROFILE,
+    PROFILE_STAGE_FILTER_RANGE_PROFILE,
+    PROFILE_STAGE_DOPPLER,
+    PROFILE_STAGE_ANGLE,
+    PROFILE_STAGE_MODEL,
+    PROFILE_STAGE_FRAME,
+    PROFILE_N_STAGES
+} profile_stage;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t mean;
+    uint32_t max;
+    uint32_t p99;
+} profile_stats;
+
+#ifdef PREPROC_PROFILING
+
+/* Number of most recent samples kept per stage for the statistics */
+#ifndef PREPROC_PROFILE_RING_SIZE
+#define PREPROC_PROFILE_RING_SIZE (128)
+#endif
+
+void preproc_profile_init(void);
+
+uint32_t preproc_profile_now(void);
+
+uint32_t preproc_profile_ticks_per_us(void);
+
+void preproc_profile_record(profile_stage stage, uint32_t ticks);
+
+bool preproc_profile_get_stats(profile_stage stage, profile_stats *stats);
+
+const char *preproc_profile_stage_name(profile_stage stage);
+
+void preproc_profile_print(void);
+
+void preproc_profile_bench_range_fft(uint16_t n_samples, uint16_t n_chirps, uint16_t n_runs);
+
+#define PREPROC_PROFILE_BEGIN(start) uint32_t start = preproc_profile_now()
+#define PREPROC_PROFILE_END(stage, start) \
+    preproc_profile_record((stage), preproc_profile_now() - (start))
+
+#else
+
+#define PREPROC_PROFILE_BEGIN(start)
+#define PREPROC_PROFILE_END(stage, start)
+
+#endif /* PREPROC_PROFILING */
+
+#endif
@@ -44,6 +44,7 @@
 #define IFXGESTURE_PREPROCESS_H_
 
 #include "ifx_sensor_dsp.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 #define ADC_RESOLUTION (12ul)
@@ -66,11 +67,66 @@ typedef struct {
     uint16_t n_range_bins;
 } frame_cfg;
 
+/* Zero-copy view of a symmetric window kept as its first half (`size / 2`
+*  elements) in flash, see `get_window_view()`. */
+typedef struct {
+    const ifx_f32_t *half;
+    uint16_t size;
+} window_view;
+
+/* Phase corrections of the monopulse azimuth and elevation in radians, 8 and
+*  24 degrees based on Signify measurements */
+#define MONOPULSE_AZIMUTH_CORRECTION   ((float)(8.0f * PI / 180.0))
+#define MONOPULSE_ELEVATION_CORRECTION ((float)(24.0f * PI / 180.0))
+
+/* Maximum number of distinct FFT plans (kind x size) kept by the FFT plan
+*  registry. `init_fft_plans()` creates three plans per frame geometry. */
+#define FFT_PLAN_REGISTRY_SIZE (4)
+
+/* Largest number of chirps of `range_doppler_image_f32()`, which keeps one
+*  Doppler column on the stack. */
+#define RDI_MAX_CHIRPS (128)
+
+/* Batched range FFT: `range_transform()` hands `RANGE_FFT_BATCH` chirps at a
+*  time to `range_fft_batch_f32()`, which keeps the bins of the whole batch in
+*  a stack buffer of `RANGE_FFT_BATCH_BINS` complex elements. Longer chirps
+*  use smaller batches, `RANGE_FFT_MAX_SAMPLES` chirps a batch of one. */
+#ifndef RANGE_FFT_BATCH
+#define RANGE_FFT_BATCH (4)
+#endif
+#define RANGE_FFT_BATCH_BINS (128)
+#define RANGE_FFT_MAX_SAMPLES (2 * RANGE_FFT_BATCH_BINS)
+
+typedef enum {
+    FFT_PLAN_REAL,
+    FFT_PLAN_COMPLEX,
+    FFT_PLAN_REAL_BATCH
+} fft_plan_kind;
+
+/* Tables of the batched real FFT of `n_samples` samples, computed as a
+*  complex FFT of `n_samples / 2` bins */
+typedef struct {
+    /* cos and -sin of 2 pi k / n_samples, k < n_samples / 2 */
+    const float32_t *twiddle;
+    /* Bit reversed index of each of the `n_samples / 2` bins */
+    const uint8_t *bit_rev;
+} range_fft_batch_instance;
+
+typedef struct {
+    fft_plan_kind kind;
+    uint16_t n_samples;
+    union {
+        arm_rfft_fast_instance_f32 rfft;
+        arm_cfft_instance_f32 cfft;
+        range_fft_batch_instance batch;
+    } instance;
+} fft_plan;
+
 typedef struct {
     uint16_t n_chirps;
     uint16_t n_samples;
     bool remove_mean;
-    ifx_f32_t *window;
+    const window_view *window;
 } range_transform_cfg;
 
 typedef struct {
@@ -78,8 +134,8 @@ typedef struct {
     uint16_t n_samples;
     bool range_remove_mean;
     bool doppler_remove_mean;
-    ifx_f32_t *range_window;
-    ifx_f32_t *doppler_window;
+    const window_view *range_window;
+    const window_view *doppler_window;
 } range_doppler_transform_cfg;
 
 typedef struct {
@@ -95,6 +151,12 @@ typedef struct {
     uint16_t col_end;
 } region;
 
+/* Largest Doppler profile handled by the peak selection and clustering in
+*  `detect_hand()`, which keeps its buffers on the stack. */
+#define PEAK_ENGINE_MAX_BINS (128)
+#define PEAK_ENGINE_MAX_PEAKS (PEAK_ENGINE_MAX_BINS / 5 + 1)
+#define PEAK_NO_CLUSTER (0xFF)
+
 typedef struct {
     uint16_t n_elements;
     uint16_t *elements;
@@ -113,6 +175,46 @@ typedef enum {
     * DETECTION_MODE_STRONGEST */
 } detection_mode;
 
+/* Background estimate the hand detections are compared against (times
+*  `threshold`) */
+typedef enum {
+    /* Median of the positive cells of the masked image, one level per frame */
+    CFAR_MODE_MEDIAN,
+    /* Cell averaging CFAR: mean of the positive training cells */
+    CFAR_MODE_CA,
+    /* Ordered statistic CFAR: quantile of the positive training cells */
+    CFAR_MODE_OS
+} cfar_mode;
+
+/* Largest number of training cells of an OS-CFAR window, which are kept on
+*  the stack */
+#define CFAR_MAX_TRAINING_CELLS (256)
+
+/* CFAR window around the cell under test: `guard_*` cells on each side are
+*  skipped, the next `train_*` cells on each side are the training cells. A
+*  zero-initialized configuration selects the median background. */
+typedef struct {
+    cfar_mode mode;
+    uint16_t guard_range;
+    uint16_t guard_doppler;
+    uint16_t train_range;
+    uint16_t train_doppler;
+    /* CFAR_MODE_OS: quantile of the training cells used as noise level */
+    float os_quantile;
+} cfar_cfg;
+
+/* Noise level source of one frame, see `cfar_prepare()` */
+typedef struct {
+    const cfar_cfg *cfg;
+    const ifx_f32_t *image;
+    uint16_t n_range_bins;
+    region valid;
+    /* CFAR_MODE_CA: integral images over `valid` of the positive cells and of
+    *  their count, [rows + 1][cols + 1] */
+    float *sum;
+    uint16_t *count;
+} cfar_map;
+
 typedef struct {
     detection detection;
     float azimuth;
@@ -120,6 +222,12 @@ typedef struct {
     float bg_level;
 } hand_features;
 
+typedef struct {
+    float doppler;
+    float azimuth;
+    float elevation;
+} monopulse_features;
+
 typedef struct {
     bool success;
     ifx_f32_t human_position;
@@ -148,14 +256,35 @@ void slice_3d_col_cf64(
     uint16_t n_rows, uint16_t n_cols
 );
 
+const fft_plan *get_fft_plan(fft_plan_kind kind, uint16_t n_samples);
+
+void init_fft_plans(const frame_cfg *f_cfg);
+
 void rfft_f32(ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_samples);
 
 void cfft_f32(ifx_cf64_t *x, uint16_t n_samples);
 
 void fftshift_cf64(ifx_cf64_t *in, uint32_t len);
 
+uint16_t range_fft_max_batch(uint16_t n_samples);
+
+void range_fft_batch_f32(
+    const ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_batch, uint16_t n_samples,
+    bool remove_mean, const window_view *window
+);
+
 void range_transform(
-    ifx_f32_t *frame_raw, ifx_cf64_t *out, range_transform_cfg *cfg
+    const ifx_f32_t *frame_raw, ifx_cf64_t *out, range_transform_cfg *cfg
+);
+
+void doppler_column_f32(
+    const ifx_cf64_t *in, uint32_t stride, ifx_cf64_t *out, bool remove_mean,
+    const window_view *window, uint16_t n_chirps
+);
+
+void range_doppler_image_f32(
+    ifx_cf64_t *x, bool remove_mean, const window_view *window,
+    uint16_t n_range_bins, uint16_t n_chirps
 );
 
 void range_doppler_transform(
@@ -163,7 +292,23 @@ void range_doppler_transform(
 );
 
 void build_complex_range_image(
-    ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg, ifx_f32_t *window
+    const ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg,
+    const window_view *adc_window
+);
+
+void build_complex_range_image_u16(
+    const uint16_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg,
+    const window_view *adc_window
+);
+
+void build_complex_range_chirps_u16(
+    const uint16_t *raw_chirps, ifx_cf64_t *out, frame_cfg *f_cfg,
+    uint16_t first_chirp, uint16_t n_group_chirps,
+    const window_view *adc_window, ifx_cf64_t *bin_sum
+);
+
+void remove_mean_chirps_cf64(
+    ifx_cf64_t *x_range, ifx_cf64_t *bin_sum, const frame_cfg *f_cfg
 );
 
 void build_complex_rdi(
@@ -174,6 +319,11 @@ void mean_rdi_channel_f32(
     ifx_f32_t *abs_rdi, ifx_f32_t *mean, frame_cfg *f_cfg
 );
 
+void cmplx_mag_accumulate_rows_f32(
+    const ifx_cf64_t *x, uint32_t row_stride, uint16_t n_rows, uint16_t n_cols,
+    ifx_f32_t *acc
+);
+
 ifx_status cmplx_image_transpose(
     ifx_cf64_t *src, ifx_cf64_t *dst, uint16_t num_rows, uint16_t num_cols
 );
@@ -208,6 +358,11 @@ float get_background_level(
     const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg
 );
 
+float get_background_level_roi(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    const region *search_region
+);
+
 void make_doppler_profile(
     const ifx_f32_t *mean_abs_rdi, ifx_f32_t *profile,
     const region *search_region, const frame_cfg *f_cfg
@@ -224,7 +379,8 @@ void cluster_peaks(
 uint16_t suggest_hand_detections(
     const ifx_f32_t *masked_mean_abs_rdi, uint16_t n_peaks, detection *detections,
     const frame_cfg *f_cfg, const region *search_region,
-    const peak_cluster *clusters, float threshold, float bg_level
+    const peak_cluster *clusters, float threshold, float bg_level,
+    const cfar_map *cfar
 );
 
 ifx_status angle(ifx_f32_t re, ifx_f32_t im, float *out);
@@ -232,13 +388,35 @@ ifx_status angle(ifx_f32_t re, ifx_f32_t im, float *out);
 detection detect_hand(
     const ifx_f32_t *masked_mean_abs_rdi, const region *search_region,
     const frame_cfg *f_cfg, float bg_level, detection_mode det_mode,
-    float threshold
+    float threshold, const cfar_map *cfar
+);
+
+uint32_t cfar_scratch_size(const frame_cfg *f_cfg);
+
+void cfar_prepare(
+    cfar_map *map, const ifx_f32_t *image, const frame_cfg *f_cfg,
+    const region *valid, const cfar_cfg *cfg
+);
+
+float cfar_noise_level(
+    const cfar_map *map, uint16_t doppler_bin, uint16_t range_bin
 );
 
 float get_phase_difference(float phase0, float phase1);
 
 float phase_monopulse(float phase0, float phase1);
 
+ifx_status angle_batch_cf64(
+    const ifx_cf64_t *x, uint32_t channel_stride, uint32_t chirp_stride,
+    uint16_t n_channels, uint16_t n_chirps, float *phases
+);
+
+ifx_status monopulse_batch_cf64(
+    const ifx_cf64_t *x, uint32_t channel_stride, uint32_t chirp_stride,
+    uint16_t n_channels, uint16_t n_chirps, float *phases,
+    monopulse_features *out
+);
+
 float deg2rad(float deg);
 
 float rad2deg(float rad);
@@ -248,11 +426,22 @@ void remove_mean_3d_cf64(
     uint16_t n_cols
 );
 
+uint32_t algo_scratch_size(const frame_cfg *f_cfg);
+
 void algo(
     algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
     estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
     uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
-    uint16_t guard_doppler, detection_mode det_mode, float threshold
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    const cfar_cfg *cfar
+);
+
+void algo_roi(
+    algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
+    estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
+    uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    const cfar_cfg *cfar
 );
 
 #endif
@@ -0,0 +1,96 @@
+
+/******************************************************************************
+* File Name:   scratch_arena.h
+*
+* Description: This file contains the function prototypes and constants used
+*   in scratch_arena.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef IFXGESTURE_PREPROCESS_SCRATCH_ARENA_H_
+#define IFXGESTURE_PREPROCESS_SCRATCH_ARENA_H_
+
+#include "preprocess.h"
+#include <stdlib.h>
+
+/* Alignment of every scratch allocation (complex float data). */
+#define SCRATCH_ALIGN (8u)
+#define SCRATCH_ALIGN_SIZE(size) \
+    (((uint32_t)(size) + SCRATCH_ALIGN - 1u) & ~(SCRATCH_ALIGN - 1u))
+
+/* Bump-pointer arena for the temporaries of one frame. The library keeps a
+*  single arena, used from the processing context only: it is reserved once
+*  (grown, never shrunk, by `scratch_arena_reserve()`), functions take
+*  memory with `scratch_alloc()` and give it back with `scratch_release()`,
+*  and `scratch_reset()` drops everything at the end of a frame. */
+typedef struct {
+    uint8_t *base;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t high_water;
+} scratch_arena;
+
+typedef uint32_t scratch_mark;
+
+void scratch_arena_reserve(uint32_t capacity);
+
+void scratch_arena_free(void);
+
+void *scratch_alloc(uint32_t size);
+
+scratch_mark scratch_get_mark(void);
+
+void scratch_release(scratch_mark mark);
+
+void scratch_reset(void);
+
+const scratch_arena *scratch_get_arena(void);
+
+/* Heap calls of the library. With PREPROC_HEAP_DEBUG they are counted, so a
+*  caller can check that a steady-state frame does not touch the heap. */
+#if defined(PREPROC_HEAP_DEBUG)
+extern volatile uint32_t preproc_heap_calls;
+#define PREPROC_MALLOC(size)    (preproc_heap_calls++, malloc(size))
+#define PREPROC_FREE(ptr)       do { preproc_heap_calls++; free(ptr); } while (0)
+#else
+#define PREPROC_MALLOC(size)    malloc(size)
+#define PREPROC_FREE(ptr)       free(ptr)
+#endif
+
+uint32_t preproc_get_heap_calls(void);
+
+#endif
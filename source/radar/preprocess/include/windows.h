@@ -45,21 +45,35 @@
 
 #include "preprocess.h"
 
+/* Symmetric windows stored as their first half: coefficient `i` of the
+*  window of `size` elements is `s<size>[i]` for `i < size / 2` and
+*  `s<size>[size - 1 - i]` otherwise. The tables are pre-scaled, `gain` holds
+*  the factor applied to each size (16, 32, ..., 256). */
 typedef struct {
-    ifx_f32_t s16[16];
-    ifx_f32_t s32[32];
-    ifx_f32_t s64[64];
-    ifx_f32_t s128[128];
-    ifx_f32_t s256[256];
+    ifx_f32_t s16[8];
+    ifx_f32_t s32[16];
+    ifx_f32_t s64[32];
+    ifx_f32_t s128[64];
+    ifx_f32_t s256[128];
+    ifx_f32_t gain[5];
 } sized_windows;
 
 typedef struct {
-    sized_windows hann;
+    /* Hann normalized by its sum and by ADC_NORMALIZATION: range window
+    *  applied directly to raw ADC codes */
+    sized_windows hann_adc;
+    /* Kaiser (beta = 25) normalized by its sum: Doppler window */
     sized_windows kaiser_b25;
 } namespace_windows;
 
 extern const namespace_windows WINDOWS;
 
+window_view get_window_view(const sized_windows *sw, uint16_t size);
+
+void apply_window_f32(ifx_f32_t *x, const window_view *window);
+
 void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size);
 
+ifx_f32_t get_window_q31(const sized_windows *sw, q31_t *out, uint16_t size);
+
 #endif
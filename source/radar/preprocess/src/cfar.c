@@ -0,0 +1,297 @@
+/******************************************************************************
+* File Name:   cfar.c
+*
+* Description: This file implements the CFAR noise level estimation used by
+*   the hand detection.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "preprocess.h"
+#include "frame_geometry.h"
+#include "scratch_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+* Function Name: cfar_scratch_size
+********************************************************************************
+* Summary:
+* Scratch arena bytes taken by `cfar_prepare()` for the largest valid region,
+* the whole image.
+*
+* Parameters:
+*  f_cfg : Frame configuration.
+*
+* Return:
+*  Size in bytes.
+*
+*******************************************************************************/
+uint32_t cfar_scratch_size(const frame_cfg *f_cfg)
+{
+    uint32_t len = (FRAME_N_CHIRPS(f_cfg) + 1) * (FRAME_N_RANGE_BINS(f_cfg) + 1);
+    return SCRATCH_ALIGN_SIZE(sizeof(float) * len) +
+           SCRATCH_ALIGN_SIZE(sizeof(uint16_t) * len);
+}
+
+/*******************************************************************************
+* Function Name: cfar_prepare
+********************************************************************************
+* Summary:
+* Prepares the noise level estimation of one frame. Only the positive cells
+* of `valid` are used as training cells, so masked (zero) cells and cells
+* outside the region never contribute, as in `get_background_level()`.
+* For CFAR_MODE_CA the integral images of the positive cells and of their
+* count are built in one pass over the region, after which the mean over any
+* window costs four lookups. The integral images come from the scratch arena
+* and are given back with the caller's mark.
+*
+* Parameters:
+*  map   : out Noise level source.
+*  image : Channel-combined magnitude image [n_chirps][n_range_bins].
+*  f_cfg : Frame configuration.
+*  valid : Region of `image` that is valid.
+*  cfg   : CFAR configuration. An OS-CFAR window with more than
+*  `CFAR_MAX_TRAINING_CELLS` cells is a fatal configuration error.
+*
+*******************************************************************************/
+void cfar_prepare(
+    cfar_map *map, const ifx_f32_t *image, const frame_cfg *f_cfg,
+    const region *valid, const cfar_cfg *cfg
+)
+{
+    map->cfg = cfg;
+    map->image = image;
+    map->n_range_bins = FRAME_N_RANGE_BINS(f_cfg);
+    map->valid = *valid;
+    map->sum = NULL;
+    map->count = NULL;
+
+    if (cfg->mode == CFAR_MODE_OS)
+    {
+        uint32_t outer = (2u * (cfg->guard_range + cfg->train_range) + 1u) *
+                         (2u * (cfg->guard_doppler + cfg->train_doppler) + 1u);
+        uint32_t inner = (2u * cfg->guard_range + 1u) * (2u * cfg->guard_doppler + 1u);
+        if (outer - inner > CFAR_MAX_TRAINING_CELLS)
+        {
+            abort();
+        }
+        return;
+    }
+    if (cfg->mode != CFAR_MODE_CA)
+    {
+        return;
+    }
+
+    uint16_t n_rows = (valid->row_end > valid->row_start) ? valid->row_end - valid->row_start : 0;
+    uint16_t n_cols = (valid->col_end > valid->col_start) ? valid->col_end - valid->col_start : 0;
+    uint32_t stride = n_cols + 1u;
+    float *sum = (float *)scratch_alloc(sizeof(float) * (n_rows + 1u) * stride);
+    uint16_t *count = (uint16_t *)scratch_alloc(sizeof(uint16_t) * (n_rows + 1u) * stride);
+
+    memset(sum, 0, sizeof(float) * stride);
+    memset(count, 0, sizeof(uint16_t) * stride);
+    for (uint16_t row = 0; row < n_rows; ++row)
+    {
+        const ifx_f32_t *src = image + (valid->row_start + row) * map->n_range_bins +
+                               valid->col_start;
+        const float *sum_above = sum + row * stride;
+        const uint16_t *count_above = count + row * stride;
+        float *sum_row = sum + (row + 1u) * stride;
+        uint16_t *count_row = count + (row + 1u) * stride;
+        float row_sum = 0.0f;
+        uint16_t row_count = 0;
+        sum_row[0] = 0.0f;
+        count_row[0] = 0;
+        for (uint16_t col = 0; col < n_cols; ++col)
+        {
+            if (src[col] > 0.0f)
+            {
+                row_sum += src[col];
+                row_count++;
+            }
+            sum_row[col + 1] = sum_above[col + 1] + row_sum;
+            count_row[col + 1] = count_above[col + 1] + row_count;
+        }
+    }
+    map->sum = sum;
+    map->count = count;
+}
+
+/* Window of the local (region) cell `row`, `col` extended by `d_row` and
+*  `d_col` cells on each side, clipped to the region of `map`. */
+static region _cfar_window(
+    const cfar_map *map, int32_t row, int32_t col, int32_t d_row, int32_t d_col
+)
+{
+    int32_t n_rows = map->valid.row_end - map->valid.row_start;
+    int32_t n_cols = map->valid.col_end - map->valid.col_start;
+    region w = {
+        .row_start = (uint16_t)((row - d_row > 0) ? row - d_row : 0),
+        .row_end = (uint16_t)((row + d_row + 1 < n_rows) ? row + d_row + 1 : n_rows),
+        .col_start = (uint16_t)((col - d_col > 0) ? col - d_col : 0),
+        .col_end = (uint16_t)((col + d_col + 1 < n_cols) ? col + d_col + 1 : n_cols)
+    };
+    return w;
+}
+
+/* Sum and number of positive cells of a local window from the integral
+*  images */
+static void _cfar_box(const cfar_map *map, const region *w, float *sum, int32_t *count)
+{
+    uint32_t stride = map->valid.col_end - map->valid.col_start + 1u;
+    uint32_t a = w->row_start * stride + w->col_start;
+    uint32_t b = w->row_start * stride + w->col_end;
+    uint32_t c = w->row_end * stride + w->col_start;
+    uint32_t d = w->row_end * stride + w->col_end;
+    *sum = (map->sum[d] - map->sum[b]) - (map->sum[c] - map->sum[a]);
+    *count = ((int32_t)map->count[d] - map->count[b]) - ((int32_t)map->count[c] - map->count[a]);
+}
+
+/* k-th smallest element (0-based) of `x`, reorders `x` */
+static float _cfar_select(float *x, int32_t n, int32_t k)
+{
+    int32_t lo = 0;
+    int32_t hi = n - 1;
+    while (lo < hi)
+    {
+        float pivot = x[(lo + hi) / 2];
+        int32_t i = lo;
+        int32_t j = hi;
+        while (i <= j)
+        {
+            while (x[i] < pivot)
+            {
+                i++;
+            }
+            while (x[j] > pivot)
+            {
+                j--;
+            }
+            if (i <= j)
+            {
+                float tmp = x[i];
+                x[i] = x[j];
+                x[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j)
+        {
+            hi = j;
+        }
+        else if (k >= i)
+        {
+            lo = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return x[k];
+}
+
+/*******************************************************************************
+* Function Name: cfar_noise_level
+********************************************************************************
+* Summary:
+* Noise level of a cell under test: the mean (CA) or the `os_quantile`
+* quantile (OS) of the positive training cells around it. Training windows are
+* clipped to the valid region, there is no wrap around in Doppler.
+*
+* Parameters:
+*  map         : Noise level source from `cfar_prepare()`.
+*  doppler_bin : Row of the cell under test (frame coordinates), inside the
+*  valid region.
+*  range_bin   : Column of the cell under test (frame coordinates), inside
+*  the valid region.
+*
+* Return:
+*  Noise level, 0 if there is no positive training cell.
+*
+*******************************************************************************/
+float cfar_noise_level(
+    const cfar_map *map, uint16_t doppler_bin, uint16_t range_bin
+)
+{
+    const cfar_cfg *cfg = map->cfg;
+    int32_t row = doppler_bin - map->valid.row_start;
+    int32_t col = range_bin - map->valid.col_start;
+    region outer = _cfar_window(
+        map, row, col, cfg->guard_doppler + cfg->train_doppler,
+        cfg->guard_range + cfg->train_range
+    );
+    region inner = _cfar_window(map, row, col, cfg->guard_doppler, cfg->guard_range);
+
+    if (cfg->mode == CFAR_MODE_CA)
+    {
+        float outer_sum, inner_sum;
+        int32_t outer_count, inner_count;
+        _cfar_box(map, &outer, &outer_sum, &outer_count);
+        _cfar_box(map, &inner, &inner_sum, &inner_count);
+        int32_t n = outer_count - inner_count;
+        return (n > 0) ? (outer_sum - inner_sum) / n : 0.0f;
+    }
+
+    /* CFAR_MODE_OS */
+    float cells[CFAR_MAX_TRAINING_CELLS];
+    int32_t n = 0;
+    for (int32_t r = outer.row_start; r < outer.row_end; ++r)
+    {
+        const ifx_f32_t *src = map->image + (map->valid.row_start + r) * map->n_range_bins +
+                               map->valid.col_start;
+        bool in_guard_rows = (r >= inner.row_start) && (r < inner.row_end);
+        for (int32_t c = outer.col_start; c < outer.col_end; ++c)
+        {
+            if (in_guard_rows && (c >= inner.col_start) && (c < inner.col_end))
+            {
+                continue;
+            }
+            if (src[c] > 0.0f)
+            {
+                cells[n++] = src[c];
+            }
+        }
+    }
+    if (n == 0)
+    {
+        return 0.0f;
+    }
+    return _cfar_select(cells, n, (int32_t)(cfg->os_quantile * (n - 1)));
+}
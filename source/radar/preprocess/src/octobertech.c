@@ -43,75 +43,288 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
 #include "octobertech.h"
 #include "preprocess.h"
+#include "frame_geometry.h"
 #include "windows.h"
+#include "scratch_arena.h"
+#include "preproc_profile.h"
 #include "math.h"
 #ifdef __cplusplus
 }
 #endif
 
+/* Processing steps seen by the work-array planner. A buffer is live in every
+*  step from its first write to its last read; buffers that are never live in
+*  the same step may share storage. */
+enum {
+    STEP_SLIM_RANGE = 0,    /* range images (load/push chirps, slim_algo) */
+    STEP_SLIM_REMOVE_MEAN,
+    STEP_SLIM_RANGE_PROFILE,
+    STEP_SLIM_FILTER,
+    STEP_SLIM_DOPPLER,
+    STEP_SLIM_ANGLE,
+    STEP_SUPER_RANGE,
+    STEP_SUPER_REMOVE_MEAN, /* includes the copy to `x_range_keep` */
+    STEP_SUPER_RANGE_PROFILE,
+    STEP_SUPER_FILTER,
+    STEP_SUPER_MONOPULSE
+};
+
+#define STEPS(first, last) \
+    ((((uint32_t)1 << ((last) + 1)) - 1u) & ~(((uint32_t)1 << (first)) - 1u))
+#define STEPS_SLIM  STEPS(STEP_SLIM_RANGE, STEP_SLIM_ANGLE)
+#define STEPS_SUPER STEPS(STEP_SUPER_RANGE, STEP_SUPER_MONOPULSE)
+
+#define WORK_ALIGN (8u)
+
+typedef enum {
+    WB_X_RANGE,
+    WB_X_RANGE_KEEP,
+    WB_X_RANGE_SUM,
+    WB_X_DOPPLER,
+    WB_PHASES,
+    WB_DOPPLER_PROFILE,
+    WB_RANGE_PROFILE,
+    WB_COUNT
+} work_buffer;
+
+typedef struct {
+    uint32_t size;
+    uint32_t live;
+    uint32_t offset;
+} work_buffer_plan;
+
 /*******************************************************************************
-* Function Name: new_preproc_octobertech_work_arrays
+* Function Name: _plan_work_arrays
 ********************************************************************************
 * Summary:
-* Instantiates a new struct of intermediate arrays and FFT windows for
-*  the `slim_algo`.
+* Lays out the work arrays of the selected variants in one block. Buffers are
+* placed largest first at the lowest aligned offset that does not overlap a
+* placed buffer live in a common step.
+*
+* `x_range_sum` is written by the radar task while either algorithm may be
+* running, so it is live in every step and never shares storage.
 *
 * Parameters:
-*  f_cfg  : Frame configuration.
+*  f_cfg    : Frame configuration.
+*  variants : PREPROC_VARIANT_* mask.
+*  plan     : out Size, liveness and offset of every buffer (size 0: unused).
 *
 * Return:
-* structure with pre-allocated arrays
+*  Size of the block in bytes.
 *
 *******************************************************************************/
-preproc_octobertech_work_arrays
-new_preproc_octobertech_work_arrays(frame_cfg *f_cfg)
+static uint32_t _plan_work_arrays(
+    const frame_cfg *f_cfg, uint32_t variants, work_buffer_plan *plan
+)
 {
-    uint32_t len_hfr = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
-    uint32_t len_img = f_cfg->n_chirps * f_cfg->n_range_bins;
-    uint32_t len_cch = f_cfg->n_channels * f_cfg->n_chirps;
+    uint32_t len_hfr = FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    uint32_t len_cch = FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg);
+    uint32_t len_crb = FRAME_N_CHANNELS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
     uint32_t sz_f = sizeof(ifx_f32_t);
     uint32_t sz_c = sizeof(ifx_cf64_t);
+    const work_buffer_plan buffers[WB_COUNT] = {
+        [WB_X_RANGE] = {sz_c * len_hfr,
+            STEPS(STEP_SLIM_RANGE, STEP_SLIM_DOPPLER) |
+            STEPS(STEP_SUPER_RANGE, STEP_SUPER_RANGE_PROFILE)},
+        [WB_X_RANGE_KEEP] = {sz_c * len_hfr,
+            STEPS(STEP_SUPER_REMOVE_MEAN, STEP_SUPER_MONOPULSE)},
+        [WB_X_RANGE_SUM] = {sz_c * len_crb, STEPS_SLIM | STEPS_SUPER},
+        [WB_X_DOPPLER] = {sz_c * len_cch,
+            STEPS(STEP_SLIM_DOPPLER, STEP_SLIM_ANGLE)},
+        [WB_PHASES] = {sz_f * len_cch,
+            STEPS(STEP_SUPER_MONOPULSE, STEP_SUPER_MONOPULSE)},
+        [WB_DOPPLER_PROFILE] = {sz_f * FRAME_N_CHIRPS(f_cfg),
+            STEPS(STEP_SLIM_DOPPLER, STEP_SLIM_ANGLE)},
+        [WB_RANGE_PROFILE] = {sz_f * FRAME_N_RANGE_BINS(f_cfg),
+            STEPS(STEP_SLIM_RANGE_PROFILE, STEP_SLIM_FILTER) |
+            STEPS(STEP_SUPER_RANGE_PROFILE, STEP_SUPER_FILTER)},
+    };
+    uint32_t steps = ((variants & PREPROC_VARIANT_SLIM) ? STEPS_SLIM : 0u) |
+                     ((variants & PREPROC_VARIANT_SUPER_SLIM) ? STEPS_SUPER : 0u);
+
+    uint8_t order[WB_COUNT];
+    uint16_t n_used = 0;
+    for (int b = 0; b < WB_COUNT; ++b)
+    {
+        plan[b] = buffers[b];
+        plan[b].live &= steps;
+        plan[b].size = (plan[b].live != 0) ? (plan[b].size + WORK_ALIGN - 1) & ~(WORK_ALIGN - 1) : 0;
+        plan[b].offset = 0;
+        if (plan[b].size == 0)
+        {
+            continue;
+        }
+        /* Insertion sort, largest first */
+        int pos = n_used++;
+        while ((pos > 0) && (plan[order[pos - 1]].size < plan[b].size))
+        {
+            order[pos] = order[pos - 1];
+            --pos;
+        }
+        order[pos] = b;
+    }
+
+    uint32_t block_size = 0;
+    for (int i = 0; i < n_used; ++i)
+    {
+        work_buffer_plan *buf = &plan[order[i]];
+        /* Raise the offset past every conflicting buffer it overlaps until it
+        *  fits; placed buffers are few, so rescanning is cheap */
+        bool moved = true;
+        while (moved)
+        {
+            moved = false;
+            for (int j = 0; j < i; ++j)
+            {
+                const work_buffer_plan *other = &plan[order[j]];
+                if (((buf->live & other->live) != 0) &&
+                    (buf->offset < other->offset + other->size) &&
+                    (other->offset < buf->offset + buf->size))
+                {
+                    buf->offset = other->offset + other->size;
+                    moved = true;
+                }
+            }
+        }
+        if (buf->offset + buf->size > block_size)
+        {
+            block_size = buf->offset + buf->size;
+        }
+    }
+
+    /* No two buffers live in a common step may overlap */
+    for (int a = 0; a < WB_COUNT; ++a)
+    {
+        for (int b = a + 1; b < WB_COUNT; ++b)
+        {
+            if ((plan[a].size != 0) && (plan[b].size != 0) &&
+                ((plan[a].live & plan[b].live) != 0) &&
+                (plan[a].offset < plan[b].offset + plan[b].size) &&
+                (plan[b].offset < plan[a].offset + plan[a].size))
+            {
+                abort();
+            }
+        }
+    }
+    return block_size;
+}
+
+/*******************************************************************************
+* Function Name: preproc_octobertech_peak_bytes
+********************************************************************************
+* Summary:
+* Peak preprocessing memory of the selected variants: the planned work-array
+* block plus the scratch arena they need.
+*
+* Parameters:
+*  f_cfg    : Frame configuration.
+*  variants : PREPROC_VARIANT_* mask.
+*
+* Return:
+*  Size in bytes.
+*
+*******************************************************************************/
+uint32_t preproc_octobertech_peak_bytes(const frame_cfg *f_cfg, uint32_t variants)
+{
+    work_buffer_plan plan[WB_COUNT];
+    uint32_t scratch = 0;
+    if (variants & (PREPROC_VARIANT_SLIM | PREPROC_VARIANT_SUPER_SLIM))
+    {
+        scratch = slim_algo_scratch_size(f_cfg);
+    }
+    if (variants & PREPROC_VARIANT_RDI)
+    {
+        scratch = max(scratch, algo_scratch_size(f_cfg));
+    }
+    return _plan_work_arrays(f_cfg, variants, plan) + scratch;
+}
+
+/*******************************************************************************
+* Function Name: new_preproc_octobertech_work_arrays_for
+********************************************************************************
+* Summary:
+* Instantiates a new struct of intermediate arrays and FFT windows for the
+* selected algorithm variants. All arrays live in one block laid out by
+* `_plan_work_arrays()`.
+*
+* Parameters:
+*  f_cfg    : Frame configuration.
+*  variants : PREPROC_VARIANT_* mask of the algorithms that will be run.
+*
+* Return:
+* structure with pre-allocated arrays
+*
+*******************************************************************************/
+preproc_octobertech_work_arrays
+new_preproc_octobertech_work_arrays_for(frame_cfg *f_cfg, uint32_t variants)
+{
+    frame_cfg_check(f_cfg);
+
+    work_buffer_plan plan[WB_COUNT];
+    uint32_t block_size = _plan_work_arrays(f_cfg, variants, plan);
+    uint8_t *block = (uint8_t *)PREPROC_MALLOC(block_size);
+#define WORK_ARRAY(id) ((plan[id].size != 0) ? (void *)(block + plan[id].offset) : NULL)
     preproc_octobertech_work_arrays arrays = {
-        .x_range = (ifx_cf64_t *)malloc(sz_c * len_hfr),
-        .x_range_keep = (ifx_cf64_t *)malloc(sz_c * len_hfr),
-        .x_range_abs = (ifx_f32_t *)malloc(sz_f * len_hfr),
-        .x_range_abs_mean = (ifx_f32_t *)malloc(sz_f * len_img),
-        .x_range_slice = (ifx_cf64_t *)malloc(sz_c * len_cch),
-        .x_doppler = (ifx_cf64_t *)malloc(sz_c * len_cch),
-        .x_doppler_abs = (ifx_f32_t *)malloc(sz_f * len_cch),
-        .doppler_profile = (ifx_f32_t *)malloc(sz_f * f_cfg->n_chirps),
-        .doppler_window = (ifx_f32_t *)malloc(sz_f * f_cfg->n_chirps),
-        .range_profile = (ifx_f32_t *)malloc(sz_f * f_cfg->n_range_bins),
-        .range_window = (ifx_f32_t *)malloc(sz_f * f_cfg->n_samples)
+        .x_range = (ifx_cf64_t *)WORK_ARRAY(WB_X_RANGE),
+        .x_range_keep = (ifx_cf64_t *)WORK_ARRAY(WB_X_RANGE_KEEP),
+        .x_range_sum = (ifx_cf64_t *)WORK_ARRAY(WB_X_RANGE_SUM),
+        .x_doppler = (ifx_cf64_t *)WORK_ARRAY(WB_X_DOPPLER),
+        .phases = (ifx_f32_t *)WORK_ARRAY(WB_PHASES),
+        .doppler_profile = (ifx_f32_t *)WORK_ARRAY(WB_DOPPLER_PROFILE),
+        .range_profile = (ifx_f32_t *)WORK_ARRAY(WB_RANGE_PROFILE),
+        .x_range_sum_ready = false,
+        .block = block,
+        .block_size = block_size,
+        .variants = variants
     };
-    if  (f_cfg->n_chirps>=16)
+#undef WORK_ARRAY
+    if  (FRAME_N_CHIRPS(f_cfg)>=16)
     {
-        get_window(&WINDOWS.kaiser_b25, arrays.doppler_window, f_cfg->n_chirps);
+        arrays.doppler_window =
+            get_window_view(&WINDOWS.kaiser_b25, FRAME_N_CHIRPS(f_cfg));
     }
-    get_window(&WINDOWS.hann, arrays.range_window, f_cfg->n_samples);
+    arrays.range_window = get_window_view(&WINDOWS.hann_adc, FRAME_N_SAMPLES(f_cfg));
+    init_fft_plans(f_cfg);
+    scratch_arena_reserve(slim_algo_scratch_size(f_cfg));
     return arrays;
 }
 
+/*******************************************************************************
+* Function Name: new_preproc_octobertech_work_arrays
+********************************************************************************
+* Summary:
+* Instantiates a new struct of intermediate arrays and FFT windows for
+*  the `slim_algo` and the `super_slim_algo`.
+*
+* Parameters:
+*  f_cfg  : Frame configuration.
+*
+* Return:
+* structure with pre-allocated arrays
+*
+*******************************************************************************/
+preproc_octobertech_work_arrays
+new_preproc_octobertech_work_arrays(frame_cfg *f_cfg)
+{
+    return new_preproc_octobertech_work_arrays_for(
+        f_cfg, PREPROC_VARIANT_SLIM | PREPROC_VARIANT_SUPER_SLIM
+    );
+}
+
 /* Frees the intermediate `slim_algo` arrays. */
 void free_preproc_octobertech_work_arrays(
     preproc_octobertech_work_arrays *arrays
 )
 {
-    free(arrays->x_range);
-    free(arrays->x_range_abs);
-    free(arrays->x_range_abs_mean);
-    free(arrays->x_range_slice);
-    free(arrays->x_doppler);
-    free(arrays->x_doppler_abs);
-    free(arrays->doppler_profile);
-    free(arrays->doppler_window);
-    free(arrays->range_profile);
-    free(arrays->range_window);
+    PREPROC_FREE(arrays->block);
+    arrays->block = NULL;
+    arrays->block_size = 0;
 }
 
 
@@ -134,18 +347,25 @@ static void _get_range_profile(
     uint16_t min_range_bin
 )
 {
-    uint16_t size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
-    arm_cmplx_mag_f32((float32_t *)x_range, (float32_t *)arr->x_range_abs, size);
-    mean_rdi_channel_f32(arr->x_range_abs, arr->x_range_abs_mean, f_cfg);
-    for (int idx_rb = min_range_bin; idx_rb < f_cfg->n_range_bins; ++idx_rb) {
-        ifx_f32_t sum = 0;
-        // 1st chirp is weird -- amplitudes look too high compared to other chirps.
-        // We ignore it for the range_profile calculation.
-        for (int idx_chirp = 1; idx_chirp < f_cfg->n_chirps; ++idx_chirp) {
-            sum += arr->x_range_abs_mean[(idx_chirp * f_cfg->n_range_bins) + idx_rb];
-        }
-        arr->range_profile[idx_rb - min_range_bin] = sum / (f_cfg->n_chirps - 1);
+    /* Mean magnitude over channels and chirps in one pass, straight from the
+    *  complex range images.
+    *  1st chirp is weird -- amplitudes look too high compared to other chirps.
+    *  We ignore it for the range_profile calculation. */
+    uint16_t n_bins = FRAME_N_RANGE_BINS(f_cfg) - min_range_bin;
+    uint16_t len_img = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    arm_fill_f32(0, arr->range_profile, n_bins);
+    for (int idx_ch = 0; idx_ch < FRAME_N_CHANNELS(f_cfg); ++idx_ch) {
+        cmplx_mag_accumulate_rows_f32(
+            x_range + idx_ch * len_img + FRAME_N_RANGE_BINS(f_cfg) + min_range_bin,
+            FRAME_N_RANGE_BINS(f_cfg), FRAME_N_CHIRPS(f_cfg) - 1, n_bins,
+            arr->range_profile
+        );
     }
+    arm_scale_f32(
+        arr->range_profile,
+        1.0f / (FRAME_N_CHANNELS(f_cfg) * (FRAME_N_CHIRPS(f_cfg) - 1)),
+        arr->range_profile, n_bins
+    );
 }
 
 /*******************************************************************************
@@ -167,24 +387,28 @@ void _get_range_profile_super_slim(
     uint16_t min_range_bin
 )
 {
-    uint16_t size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
-    arm_cmplx_mag_f32((float32_t *)x_range, (float32_t *)arr->x_range_abs, size);
-    mean_rdi_channel_f32(arr->x_range_abs, arr->x_range_abs_mean, f_cfg);
-    arm_fill_f32(0,arr->range_profile,f_cfg->n_range_bins);
-    for (int idx_rb = min_range_bin; idx_rb < f_cfg->n_range_bins; ++idx_rb) {
-        ifx_f32_t sum = 0;
-        for (int idx_chirp = 0; idx_chirp < f_cfg->n_chirps; ++idx_chirp) {
-            sum += arr->x_range_abs_mean[(idx_chirp * f_cfg->n_range_bins) + idx_rb];
-        }
-        arr->range_profile[idx_rb - min_range_bin] = sum / (f_cfg->n_chirps);
+    /* Mean magnitude over channels and all chirps in one pass */
+    uint16_t n_bins = FRAME_N_RANGE_BINS(f_cfg) - min_range_bin;
+    uint16_t len_img = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    arm_fill_f32(0,arr->range_profile,FRAME_N_RANGE_BINS(f_cfg));
+    for (int idx_ch = 0; idx_ch < FRAME_N_CHANNELS(f_cfg); ++idx_ch) {
+        cmplx_mag_accumulate_rows_f32(
+            x_range + idx_ch * len_img + min_range_bin, FRAME_N_RANGE_BINS(f_cfg),
+            FRAME_N_CHIRPS(f_cfg), n_bins, arr->range_profile
+        );
     }
+    arm_scale_f32(
+        arr->range_profile, 1.0f / (FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg)),
+        arr->range_profile, n_bins
+    );
 }
 
 /*******************************************************************************
 * Function Name: _get_single_range_bin_doppler
 ********************************************************************************
 * Summary:
-* Computes a doppler FFT on for a single range bin.
+* Computes a doppler FFT on for a single range bin, straight from the range
+* images, with the zero Doppler bin in the centre.
 *
 * Parameters:
 *  x_range       : Range images (per channel).
@@ -199,17 +423,13 @@ static void _get_single_range_bin_doppler(
     frame_cfg *f_cfg
 )
 {
-    slice_3d_col_cf64(
-        x_range, arr->x_range_slice, range_bin, f_cfg->n_channels, f_cfg->n_chirps,
-        f_cfg->n_range_bins
-    );
-    for (uint16_t idx_ch = 0; idx_ch < f_cfg->n_channels; ++idx_ch) {
-        (void)ifx_doppler_cfft_f32(
-            (cfloat32_t *)(arr->x_range_slice + idx_ch * f_cfg->n_chirps),
-            (cfloat32_t *)(arr->x_doppler + idx_ch * f_cfg->n_chirps), false,
-            arr->doppler_window, 1, f_cfg->n_chirps
+    for (uint16_t idx_ch = 0; idx_ch < FRAME_N_CHANNELS(f_cfg); ++idx_ch) {
+        doppler_column_f32(
+            x_range + idx_ch * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg) + range_bin,
+            FRAME_N_RANGE_BINS(f_cfg), arr->x_doppler + idx_ch * FRAME_N_CHIRPS(f_cfg), false,
+            (arr->doppler_window.half != NULL) ? &arr->doppler_window : NULL,
+            FRAME_N_CHIRPS(f_cfg)
         );
-        fftshift_cf64(arr->x_doppler + idx_ch * f_cfg->n_chirps, f_cfg->n_chirps);
     }
 }
 
@@ -229,17 +449,23 @@ static void _get_doppler_profile(
     ifx_cf64_t *x_doppler, preproc_octobertech_work_arrays *arr, frame_cfg *f_cfg
 )
 {
-    arm_cmplx_mag_f32(
-        (float32_t *)x_doppler, (float32_t *)arr->x_doppler_abs,
-        f_cfg->n_channels * f_cfg->n_chirps
+    /* Channels are the rows of the [n_channels][n_chirps] spectra */
+    arm_fill_f32(0, arr->doppler_profile, FRAME_N_CHIRPS(f_cfg));
+    cmplx_mag_accumulate_rows_f32(
+        x_doppler, FRAME_N_CHIRPS(f_cfg), FRAME_N_CHANNELS(f_cfg),
+        FRAME_N_CHIRPS(f_cfg), arr->doppler_profile
+    );
+    arm_scale_f32(
+        arr->doppler_profile, 1.0f / FRAME_N_CHANNELS(f_cfg),
+        arr->doppler_profile, FRAME_N_CHIRPS(f_cfg)
     );
-    for (uint16_t idx_chirp = 0; idx_chirp < f_cfg->n_chirps; ++idx_chirp) {
-        ifx_f32_t sum = 0;
-        for (int idx_ch = 0; idx_ch < f_cfg->n_channels; ++idx_ch) {
-            sum += arr->x_doppler_abs[idx_ch * f_cfg->n_chirps + idx_chirp];
-        }
-        arr->doppler_profile[idx_chirp] = sum / f_cfg->n_channels;
-    }
+}
+
+/* Scratch arena bytes needed by `slim_algo()` and `super_slim_algo()`: the
+*  convolution output of `filter_range_profile()`. */
+uint32_t slim_algo_scratch_size(const frame_cfg *f_cfg)
+{
+    return sizeof(float32_t) * (FRAME_N_RANGE_BINS(f_cfg) + 9 - 1);
 }
 
 uint32_t filter_range_profile(ifx_f32_t *range_profile, int32_t len, uint32_t peak_range)
@@ -249,7 +475,8 @@ uint32_t filter_range_profile(ifx_f32_t *range_profile, int32_t len, uint32_t pe
     float32_t weights [] = {1.33830625e-04, 4.43186162e-03, 5.39911274e-02, 2.41971446e-01, 3.98943469e-01, 2.41971446e-01, 5.39911274e-02, 4.43186162e-03, 1.33830625e-04};
     threshold = max(0.1*range_profile[peak_range], 1e-4);
 
-    float32_t* conv_out = malloc(sizeof(float32_t) * (len + 9 - 1));
+    scratch_mark mark = scratch_get_mark();
+    float32_t* conv_out = scratch_alloc(sizeof(float32_t) * (len + 9 - 1));
 
     arm_conv_f32(range_profile, (uint32_t)len, weights, 9, conv_out);
 
@@ -264,7 +491,7 @@ uint32_t filter_range_profile(ifx_f32_t *range_profile, int32_t len, uint32_t pe
         }
     }
 
-    free(conv_out);
+    scratch_release(mark);
 
     if (peak_idx>-1) {
         return (uint32_t)peak_idx;
@@ -296,45 +523,152 @@ void slim_algo(
     uint16_t min_range_bin, preproc_octobertech_work_arrays *arr
 )
 {
-    /* Build range images, suppress static targets, compute a range profile */
-    build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
-    remove_mean_3d_cf64(
-        arr->x_range, 1, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins
+    if (!(arr->variants & PREPROC_VARIANT_SLIM))
+    {
+        abort();
+    }
+    /* Build range images, then extract the features */
+    build_complex_range_image(x_frame, arr->x_range, f_cfg, &arr->range_window);
+    arr->x_range_sum_ready = false;
+    slim_algo_from_range_image(out, f_cfg, min_range_bin, arr);
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_load_raw_frame
+********************************************************************************
+* Summary:
+* Builds the range images of `slim_algo` directly from the raw (interleaved)
+* radar FIFO frame into `arr->x_range`, accumulating the sum over chirps of
+* every range bin on the way. Follow up with `slim_algo_from_range_image()` to
+* extract the hand features.
+*
+* Parameters:
+*  raw_frame : Raw radar frame as read from the radar data manager.
+*  f_cfg     : Frame configuration.
+*  arr       : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_load_raw_frame(
+    const uint16_t *raw_frame, frame_cfg *f_cfg,
+    preproc_octobertech_work_arrays *arr
+)
+{
+    slim_algo_push_chirps(raw_frame, 0, FRAME_N_CHIRPS(f_cfg), f_cfg, arr);
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_push_chirps
+********************************************************************************
+* Summary:
+* Streaming counterpart of `slim_algo_load_raw_frame()`. Computes the range
+* FFT of a group of chirps as soon as it arrives and keeps a running sum per
+* range bin, so that only the Doppler and angle steps are left once the last
+* chirp of the frame is in. Follow up with `slim_algo_from_range_image()`
+* after the last group.
+*
+* Parameters:
+*  raw_chirps     : Raw radar data of the chirp group as read from the radar
+*  data manager.
+*  first_chirp    : Index of the first chirp of the group within the frame.
+*  n_group_chirps : Number of chirps in the group.
+*  f_cfg          : Frame configuration.
+*  arr            : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_push_chirps(
+    const uint16_t *raw_chirps, uint16_t first_chirp, uint16_t n_group_chirps,
+    frame_cfg *f_cfg, preproc_octobertech_work_arrays *arr
+)
+{
+    if (!(arr->variants & PREPROC_VARIANT_SLIM))
+    {
+        abort();
+    }
+    build_complex_range_chirps_u16(
+        raw_chirps, arr->x_range, f_cfg, first_chirp, n_group_chirps,
+        &arr->range_window, arr->x_range_sum
     );
+    arr->x_range_sum_ready = (first_chirp + n_group_chirps == FRAME_N_CHIRPS(f_cfg));
+}
+
+/* Suppresses the static targets in `arr->x_range`, with the sums over chirps
+*  accumulated by the range FFT if they are available. */
+static void _slim_algo_remove_static(
+    frame_cfg *f_cfg, preproc_octobertech_work_arrays *arr
+)
+{
+    PREPROC_PROFILE_BEGIN(t_remove_mean);
+    if (arr->x_range_sum_ready)
+    {
+        remove_mean_chirps_cf64(arr->x_range, arr->x_range_sum, f_cfg);
+        arr->x_range_sum_ready = false;
+    }
+    else
+    {
+        remove_mean_3d_cf64(
+            arr->x_range, 1, FRAME_N_CHANNELS(f_cfg), FRAME_N_CHIRPS(f_cfg), FRAME_N_RANGE_BINS(f_cfg)
+        );
+    }
+    PREPROC_PROFILE_END(PROFILE_STAGE_REMOVE_MEAN, t_remove_mean);
+}
+
+/* Range profile of the range images in `arr->x_range` with the static
+*  targets already suppressed. */
+static void _slim_algo_range_profile(
+    frame_cfg *f_cfg, uint16_t min_range_bin, preproc_octobertech_work_arrays *arr
+)
+{
+    PREPROC_PROFILE_BEGIN(t_range_profile);
     _get_range_profile(arr->x_range, arr, f_cfg, min_range_bin);
+    PREPROC_PROFILE_END(PROFILE_STAGE_RANGE_PROFILE, t_range_profile);
+}
 
+/* Hand features from the range images in `arr->x_range` with the static
+*  targets already suppressed and their range profile in
+*  `arr->range_profile`. */
+static void _slim_algo_features(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_work_arrays *arr
+)
+{
     /* Find peak in the range profile - consider it as range to the hand */
     uint32_t idx_peak_range;
     ifx_f32_t val_peak_range;
     arm_max_f32(
-        arr->range_profile, f_cfg->n_range_bins - min_range_bin, &val_peak_range,
+        arr->range_profile, FRAME_N_RANGE_BINS(f_cfg) - min_range_bin, &val_peak_range,
         &idx_peak_range
     );
 
-    idx_peak_range = filter_range_profile(arr->range_profile, f_cfg->n_range_bins-min_range_bin, idx_peak_range);
+    PREPROC_PROFILE_BEGIN(t_filter);
+    idx_peak_range = filter_range_profile(arr->range_profile, FRAME_N_RANGE_BINS(f_cfg)-min_range_bin, idx_peak_range);
+    PREPROC_PROFILE_END(PROFILE_STAGE_FILTER_RANGE_PROFILE, t_filter);
 
     idx_peak_range += min_range_bin;
 
+    PREPROC_PROFILE_BEGIN(t_doppler);
     /* Compute Doppler spectrum for the peak range bin (for each channel), then
     *   make a Doppler profile.*/
     _get_single_range_bin_doppler(arr->x_range, arr, idx_peak_range, f_cfg);
     _get_doppler_profile(arr->x_doppler, arr, f_cfg);
 
+    PREPROC_PROFILE_END(PROFILE_STAGE_DOPPLER, t_doppler);
+
     /* Find peak in the Doppler profile - consider it as velocity of the hand */
     uint32_t idx_peak_doppler;
     ifx_f32_t val_peak_doppler;
     arm_max_f32(
-        arr->doppler_profile, f_cfg->n_chirps, &val_peak_doppler, &idx_peak_doppler
+        arr->doppler_profile, FRAME_N_CHIRPS(f_cfg), &val_peak_doppler, &idx_peak_doppler
     );
 
+    PREPROC_PROFILE_BEGIN(t_angle);
     /* Extract phases from Doppler spectrum of each channel */
     float phases[3];
     for (int i = 0; i < 3; ++i)
     {
         ifx_f32_t re =
-            arr->x_doppler[i * f_cfg->n_chirps + idx_peak_doppler].data[0];
+            arr->x_doppler[i * FRAME_N_CHIRPS(f_cfg) + idx_peak_doppler].data[0];
         ifx_f32_t im =
-            arr->x_doppler[i * f_cfg->n_chirps + idx_peak_doppler].data[1];
+            arr->x_doppler[i * FRAME_N_CHIRPS(f_cfg) + idx_peak_doppler].data[1];
         if (angle(re, im, phases + i) != ARM_MATH_SUCCESS) {
             out->success = false;
             return;
@@ -343,9 +677,10 @@ void slim_algo(
 
     float azimuth = phase_monopulse(phases[2], phases[0]);
     float elevation = phase_monopulse(phases[2], phases[1]);
-    /* Phase correction based on Signify measurements */
-    azimuth = azimuth + deg2rad(8.0);
-    elevation = elevation + deg2rad(24.0);
+    azimuth = azimuth + MONOPULSE_AZIMUTH_CORRECTION;
+    elevation = elevation + MONOPULSE_ELEVATION_CORRECTION;
+
+    PREPROC_PROFILE_END(PROFILE_STAGE_ANGLE, t_angle);
 
     out->success = true;
     out->detection = (slim_algo_detection
@@ -359,97 +694,219 @@ void slim_algo(
     };
 }
 
+/*******************************************************************************
+* Function Name: slim_algo_from_range_image
+********************************************************************************
+* Summary:
+* Extracts hand features for gesture recognition from the range images
+* already stored in `arr->x_range`. For range images built with
+* `slim_algo_load_raw_frame()` or `slim_algo_push_chirps()` the mean over
+* chirps comes from the sums accumulated with the range FFT and is removed in
+* one contiguous pass.
+*
+* Parameters:
+*  out           : out Preprocessing algorithm output containing detected hand
+*  features.
+*  f_cfg         : Frame configuration.
+*  min_range_bin : The closest range bin to use for hand detection.
+*  arr           : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_work_arrays *arr
+)
+{
+    _slim_algo_remove_static(f_cfg, arr);
+    _slim_algo_range_profile(f_cfg, min_range_bin, arr);
+    _slim_algo_features(out, f_cfg, min_range_bin, arr);
+}
+
+/*******************************************************************************
+* Function Name: new_motion_gate
+********************************************************************************
+* Summary:
+* Instantiates a motion gate for `slim_algo_gated_from_range_image()`. The
+* noise floor is learnt during the first `warmup_frames` frames, during which
+* the gate stays open.
+*
+* Parameters:
+*  threshold     : Motion if the range profile energy exceeds `threshold`
+*  times the noise floor.
+*  hold_frames   : Frames the gate stays open after the last motion frame, so
+*  the end of a gesture is not cut off.
+*  warmup_frames : Frames used to learn the noise floor.
+*
+* Return:
+*  Motion gate in the open state with cleared statistics.
+*
+*******************************************************************************/
+motion_gate new_motion_gate(float threshold, uint16_t hold_frames, uint16_t warmup_frames)
+{
+    motion_gate gate = {
+        .threshold = threshold,
+        .alpha_down = MOTION_GATE_ALPHA_DOWN,
+        .alpha_up = MOTION_GATE_ALPHA_UP,
+        .hold_frames = hold_frames,
+        .warmup_frames = warmup_frames,
+        .noise_floor = 0.0f,
+        .energy = 0.0f,
+        .hold = hold_frames,
+        .n_frames = 0,
+        .hits = 0,
+        .misses = 0
+    };
+    return gate;
+}
+
+/* Updates the gate with the range profile energy of a frame and returns
+*  whether the frame needs the full processing. */
+static bool _motion_gate_update(motion_gate *gate, float energy)
+{
+    gate->energy = energy;
+    if (gate->n_frames < gate->warmup_frames)
+    {
+        /* Running mean of the first frames */
+        gate->n_frames++;
+        gate->noise_floor += (energy - gate->noise_floor) / gate->n_frames;
+        gate->misses++;
+        return true;
+    }
+
+    bool motion = energy > gate->threshold * gate->noise_floor;
+    /* The floor follows drops quickly and rises slowly, so a gesture hardly
+    *  moves it but a changed scene is learnt within a few seconds */
+    float alpha = (energy < gate->noise_floor) ? gate->alpha_down : gate->alpha_up;
+    gate->noise_floor += alpha * (energy - gate->noise_floor);
+
+    if (motion)
+    {
+        gate->hold = gate->hold_frames;
+    }
+    else if (gate->hold > 0)
+    {
+        gate->hold--;
+        motion = true;
+    }
+
+    if (motion)
+    {
+        gate->misses++;
+    }
+    else
+    {
+        gate->hits++;
+    }
+    return motion;
+}
+
+/* Hand features of an empty scene, as `slim_algo_from_range_image()` finds
+*  them on noise only: no target, a peak in the middle of the searched range
+*  bins, zero Doppler (the centre bin) and the angles of zero phase
+*  difference, i.e. the phase corrections alone. */
+static slim_algo_detection _slim_algo_idle_detection(
+    const frame_cfg *f_cfg, uint16_t min_range_bin
+)
+{
+    return (slim_algo_detection)
+    {
+        .range_bin = (min_range_bin + FRAME_N_RANGE_BINS(f_cfg)) / 2,
+        .doppler_bin = FRAME_N_CHIRPS(f_cfg) / 2,
+        .azimuth = MONOPULSE_AZIMUTH_CORRECTION,
+        .elevation = MONOPULSE_ELEVATION_CORRECTION,
+        .value = 0.0f
+    };
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_gated_from_range_image
+********************************************************************************
+* Summary:
+* `slim_algo_from_range_image()` behind a motion gate. The static targets are
+* removed and the range profile is computed as usual. If its energy (beyond
+* `min_range_bin`) does not exceed the adaptive noise floor of `gate`, the
+* frame is idle and the Doppler, peak search and angle steps are skipped.
+*
+* Parameters:
+*  out           : out Hand features, `success` is false for an idle frame,
+*  which gets the features of an empty scene.
+*  f_cfg         : Frame configuration.
+*  min_range_bin : The closest range bin to use for hand detection.
+*  arr           : Intermediate pre-allocated arrays.
+*  gate          : Motion gate, see `new_motion_gate()`.
+*
+* Return:
+*  true if the frame was processed, false if it was short-circuited.
+*
+*******************************************************************************/
+bool slim_algo_gated_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_work_arrays *arr, motion_gate *gate
+)
+{
+    _slim_algo_remove_static(f_cfg, arr);
+    _slim_algo_range_profile(f_cfg, min_range_bin, arr);
+
+    float32_t energy;
+    arm_power_f32(arr->range_profile, FRAME_N_RANGE_BINS(f_cfg) - min_range_bin, &energy);
+    if (!_motion_gate_update(gate, energy))
+    {
+        out->success = false;
+        out->detection = _slim_algo_idle_detection(f_cfg, min_range_bin);
+        return false;
+    }
+    _slim_algo_features(out, f_cfg, min_range_bin, arr);
+    return true;
+}
+
 void super_slim_algo(
     super_slim_algo_output *out, ifx_f32_t *x_frame, frame_cfg *f_cfg,
     uint16_t min_range_bin, preproc_octobertech_work_arrays *arr
 )
 {
+    if (!(arr->variants & PREPROC_VARIANT_SUPER_SLIM))
+    {
+        abort();
+    }
     /* Build range images, suppress static targets, compute a range profile */
-    build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
-    memcpy(arr->x_range_keep, arr->x_range, f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins *sizeof(ifx_cf64_t));
+    build_complex_range_image(x_frame, arr->x_range, f_cfg, &arr->range_window);
+    memcpy(arr->x_range_keep, arr->x_range, FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg) *sizeof(ifx_cf64_t));
     remove_mean_3d_cf64(
-        arr->x_range, 1, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins
+        arr->x_range, 1, FRAME_N_CHANNELS(f_cfg), FRAME_N_CHIRPS(f_cfg), FRAME_N_RANGE_BINS(f_cfg)
     );
     _get_range_profile_super_slim(arr->x_range, arr, f_cfg, min_range_bin);
     /* Find peak in the range profile - consider it as range to the hand */
     uint32_t idx_peak_range;
     ifx_f32_t val_peak_range;
     arm_max_f32(
-        arr->range_profile, f_cfg->n_range_bins - min_range_bin, &val_peak_range,
+        arr->range_profile, FRAME_N_RANGE_BINS(f_cfg) - min_range_bin, &val_peak_range,
         &idx_peak_range
     );
     idx_peak_range = filter_range_profile(
-                         arr->range_profile, f_cfg->n_range_bins - min_range_bin, idx_peak_range
+                         arr->range_profile, FRAME_N_RANGE_BINS(f_cfg) - min_range_bin, idx_peak_range
                      );
 
     idx_peak_range += min_range_bin;
-    float** phases;
-    phases = (float**)malloc(f_cfg->n_channels * sizeof(float*));
-    for (int i = 0; i < f_cfg->n_channels; i++) {
-        phases[i] = (float*)malloc(f_cfg->n_chirps * sizeof(float));
-    }
-
-
-    for (int a = 0; a < f_cfg->n_channels; ++a)
+    monopulse_features features;
+    if (monopulse_batch_cf64(
+            arr->x_range_keep + idx_peak_range,
+            FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg), FRAME_N_RANGE_BINS(f_cfg),
+            FRAME_N_CHANNELS(f_cfg), FRAME_N_CHIRPS(f_cfg), arr->phases, &features
+        ) != ARM_MATH_SUCCESS)
     {
-        ifx_cf64_t *this_antena =
-            arr->x_range_keep + (f_cfg->n_range_bins * f_cfg->n_chirps * a);
-        for (int c = 0; c < f_cfg->n_chirps; ++c)
-        {
-            ifx_f32_t re = this_antena[c*f_cfg->n_range_bins + idx_peak_range].data[0];
-            ifx_f32_t im = this_antena[c*f_cfg->n_range_bins + idx_peak_range].data[1];
-            if (angle(re, im, &phases[a][c]) != ARM_MATH_SUCCESS)
-            {
-                out->success = false;
-
-                /* Free the memory for each row */
-                for (int i = 0; i < f_cfg->n_channels; i++)
-                {
-                    free(phases[i]);
-                }
-
-                /* Free the memory for the array itself */
-                free(phases);
-
-                return;
-            }
-        }
-    }
-    float doppler = 0;
-    for (int a = 0; a < f_cfg->n_channels; ++a)
-    {
-        doppler += get_phase_difference(phases[a][1], phases[a][0]);
-    }
-    doppler = doppler / f_cfg->n_channels;
-
-    float azimuth = 0;
-    float elevation = 0;
-    for (int c = 0; c < f_cfg->n_chirps; ++c)
-    {
-        azimuth += phase_monopulse(phases[2][c], phases[0][c]);
-        elevation += phase_monopulse(phases[2][c], phases[1][c]);
+        out->success = false;
+        return;
     }
-    azimuth = azimuth / f_cfg->n_chirps;
-    elevation = elevation / f_cfg->n_chirps;
 
     out->success = true;
     out->detection = (super_slim_algo_detection
     )
     {
         .range_bin = idx_peak_range,
-        .doppler_bin = doppler,
-        .azimuth = azimuth,
-        .elevation = elevation,
+        .doppler_bin = features.doppler,
+        .azimuth = features.azimuth,
+        .elevation = features.elevation,
         .value = val_peak_range
     };
-
-    /* Free the memory for each row */
-    for (int i = 0; i < f_cfg->n_channels; i++)
-    {
-        free(phases[i]);
-    }
-
-    /* Free the memory for the array itself */
-    free(phases);
 }
 
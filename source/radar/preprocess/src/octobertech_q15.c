@@ -0,0 +1,474 @@
+/******************************************************************************
+* File Name:   octobertech_q15.c
+*
+* Description: This file does fixed-point (q15/q31) feature extraction from the
+*   raw radar data.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "ifx_sensor_dsp.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "octobertech_q15.h"
+#include "preprocess.h"
+#include "frame_geometry.h"
+#include "windows.h"
+#include "scratch_arena.h"
+#include "preproc_profile.h"
+#include "math.h"
+#ifdef __cplusplus
+}
+#endif
+
+/*******************************************************************************
+* Function Name: new_preproc_octobertech_q15_work_arrays
+********************************************************************************
+* Summary:
+* Instantiates a new struct of intermediate arrays, FFT windows and FFT
+* instances for the fixed-point `slim_algo`.
+*
+* Parameters:
+*  f_cfg  : Frame configuration.
+*
+* Return:
+* structure with pre-allocated arrays
+*
+*******************************************************************************/
+preproc_octobertech_q15_work_arrays
+new_preproc_octobertech_q15_work_arrays(frame_cfg *f_cfg)
+{
+    frame_cfg_check(f_cfg);
+
+    uint32_t len_hfr = FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    uint32_t len_cch = FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg);
+    uint32_t len_crb = FRAME_N_CHANNELS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    preproc_octobertech_q15_work_arrays arrays = {
+        .x_range = (q15_t *)PREPROC_MALLOC(sizeof(q15_t) * 2 * len_hfr),
+        .range_sum = (int32_t *)PREPROC_MALLOC(sizeof(int32_t) * 2 * len_crb),
+        .x_doppler = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * 2 * len_cch),
+        .doppler_window = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * FRAME_N_CHIRPS(f_cfg)),
+        .x_doppler_abs = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * FRAME_N_CHIRPS(f_cfg)),
+        .doppler_profile = (ifx_f32_t *)PREPROC_MALLOC(sizeof(ifx_f32_t) * FRAME_N_CHIRPS(f_cfg)),
+        .x_range_abs = (q15_t *)PREPROC_MALLOC(sizeof(q15_t) * FRAME_N_RANGE_BINS(f_cfg)),
+        .range_acc = (int32_t *)PREPROC_MALLOC(sizeof(int32_t) * FRAME_N_RANGE_BINS(f_cfg)),
+        .range_profile = (ifx_f32_t *)PREPROC_MALLOC(sizeof(ifx_f32_t) * FRAME_N_RANGE_BINS(f_cfg)),
+        .range_window = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * FRAME_N_SAMPLES(f_cfg)),
+        .chirp_buffer = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * FRAME_N_SAMPLES(f_cfg)),
+        .chirp_fft = (q31_t *)PREPROC_MALLOC(sizeof(q31_t) * 2 * FRAME_N_SAMPLES(f_cfg))
+    };
+
+    if ((arm_rfft_init_q31(&arrays.range_fft, FRAME_N_SAMPLES(f_cfg), 0, 1) != ARM_MATH_SUCCESS) ||
+        (arm_cfft_init_q31(&arrays.doppler_fft, FRAME_N_CHIRPS(f_cfg)) != ARM_MATH_SUCCESS))
+    {
+        abort();
+    }
+
+    /* Raw samples are scaled to q31 as `(x - mean) / 2^ADC_RESOLUTION`. The
+    *  mean is removed as `(x * n_samples - sum) / n_samples`, so the
+    *  division by `n_samples` is folded into the gain. */
+    uint16_t log2_samples = 0;
+    while ((1u << log2_samples) < FRAME_N_SAMPLES(f_cfg))
+    {
+        log2_samples++;
+    }
+    arrays.sample_gain = (int32_t)1 << (31 - ADC_RESOLUTION - log2_samples);
+
+    ifx_f32_t range_window_sum =
+        get_window_q31(&WINDOWS.hann_adc, arrays.range_window, FRAME_N_SAMPLES(f_cfg));
+    ifx_f32_t doppler_window_sum;
+    if  (FRAME_N_CHIRPS(f_cfg)>=16)
+    {
+        doppler_window_sum = get_window_q31(
+            &WINDOWS.kaiser_b25, arrays.doppler_window, FRAME_N_CHIRPS(f_cfg)
+        );
+    }
+    else
+    {
+        for (int i = 0; i < FRAME_N_CHIRPS(f_cfg); ++i)
+        {
+            arrays.doppler_window[i] = INT32_MAX;
+        }
+        doppler_window_sum = FRAME_N_CHIRPS(f_cfg);
+    }
+
+    /* Gain of the q15 range image relative to the float32 range image, which
+    *  uses `1/ADC_NORMALIZATION` and a window normalized by its sum. */
+    ifx_f32_t range_gain = (ifx_f32_t)(1 << Q15_RANGE_HEADROOM_SHIFT) *
+                           (ifx_f32_t)ADC_NORMALIZATION * range_window_sum /
+                           ((ifx_f32_t)(1 << ADC_RESOLUTION) * FRAME_N_SAMPLES(f_cfg));
+    /* `arm_cmplx_mag_q15()` returns 2.14, `arm_cmplx_mag_q31()` 2.30 and the
+    *  q31 Doppler FFT is scaled by 1/n_chirps. */
+    arrays.range_scale = 2.0f / (32768.0f * range_gain);
+    arrays.doppler_scale = 2.0f * FRAME_N_CHIRPS(f_cfg) /
+                           (2147483648.0f * range_gain * doppler_window_sum);
+    scratch_arena_reserve(slim_algo_scratch_size(f_cfg));
+    return arrays;
+}
+
+/* Frees the intermediate fixed-point `slim_algo` arrays. */
+void free_preproc_octobertech_q15_work_arrays(
+    preproc_octobertech_q15_work_arrays *arrays
+)
+{
+    PREPROC_FREE(arrays->x_range);
+    PREPROC_FREE(arrays->range_sum);
+    PREPROC_FREE(arrays->x_doppler);
+    PREPROC_FREE(arrays->doppler_window);
+    PREPROC_FREE(arrays->x_doppler_abs);
+    PREPROC_FREE(arrays->doppler_profile);
+    PREPROC_FREE(arrays->x_range_abs);
+    PREPROC_FREE(arrays->range_acc);
+    PREPROC_FREE(arrays->range_profile);
+    PREPROC_FREE(arrays->range_window);
+    PREPROC_FREE(arrays->chirp_buffer);
+    PREPROC_FREE(arrays->chirp_fft);
+}
+
+/* q31 range FFT of a group of chirps into the q15 range images, accumulating
+*  the complex sum over chirps of every range bin. */
+static void _range_chirps_q15(
+    const uint16_t *raw_chirps, uint16_t first_chirp, uint16_t n_group_chirps,
+    frame_cfg *f_cfg, preproc_octobertech_q15_work_arrays *arr
+)
+{
+    const uint16_t out_shift = 16 - Q15_RANGE_HEADROOM_SHIFT;
+    const int32_t rounding = (int32_t)1 << (out_shift - 1);
+    uint16_t n_channels = FRAME_N_CHANNELS(f_cfg);
+    uint32_t chirp_stride = FRAME_N_SAMPLES(f_cfg) * n_channels;
+
+    if (first_chirp == 0)
+    {
+        memset(arr->range_sum, 0, sizeof(int32_t) * 2 * n_channels * FRAME_N_RANGE_BINS(f_cfg));
+    }
+
+    for (int ch = 0; ch < n_channels; ++ch)
+    {
+        int32_t *sum_out = arr->range_sum + 2 * ch * FRAME_N_RANGE_BINS(f_cfg);
+        for (int chirp = 0; chirp < n_group_chirps; ++chirp)
+        {
+            const uint16_t *src = raw_chirps + chirp * chirp_stride + ch;
+            q15_t *dst = arr->x_range + 2 * (ch * FRAME_N_CHIRPS(f_cfg) + first_chirp + chirp) *
+                                        FRAME_N_RANGE_BINS(f_cfg);
+
+            int32_t sum = 0;
+            for (int i = 0; i < FRAME_N_SAMPLES(f_cfg); ++i)
+            {
+                sum += src[i * n_channels];
+            }
+            for (int i = 0; i < FRAME_N_SAMPLES(f_cfg); ++i)
+            {
+                arr->chirp_buffer[i] =
+                    ((int32_t)src[i * n_channels] * FRAME_N_SAMPLES(f_cfg) - sum) *
+                    arr->sample_gain;
+            }
+            arm_mult_q31(
+                arr->chirp_buffer, arr->range_window, arr->chirp_buffer,
+                FRAME_N_SAMPLES(f_cfg)
+            );
+            arm_rfft_q31(&arr->range_fft, arr->chirp_buffer, arr->chirp_fft);
+
+            for (int i = 0; i < 2 * FRAME_N_RANGE_BINS(f_cfg); ++i)
+            {
+                dst[i] = (q15_t)__SSAT((arr->chirp_fft[i] + rounding) >> out_shift, 16);
+            }
+            dst[1] = 0;
+
+            for (int i = 0; i < 2 * FRAME_N_RANGE_BINS(f_cfg); ++i)
+            {
+                sum_out[i] += dst[i];
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_q15_load_raw_frame
+********************************************************************************
+* Summary:
+* Builds the q15 range images directly from the raw (interleaved) radar FIFO
+* frame into `arr->x_range`: mean removal, Hann window and q31 range FFT per
+* chirp, followed by a rounding conversion to q15.
+*
+* Parameters:
+*  raw_frame : Raw radar frame as read from the radar data manager.
+*  f_cfg     : Frame configuration.
+*  arr       : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_q15_load_raw_frame(
+    const uint16_t *raw_frame, frame_cfg *f_cfg,
+    preproc_octobertech_q15_work_arrays *arr
+)
+{
+    _range_chirps_q15(raw_frame, 0, FRAME_N_CHIRPS(f_cfg), f_cfg, arr);
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_q15_push_chirps
+********************************************************************************
+* Summary:
+* Streaming counterpart of `slim_algo_q15_load_raw_frame()`, see
+* `slim_algo_push_chirps()`. Follow up with `slim_algo_q15_from_range_image()`
+* after the last group.
+*
+* Parameters:
+*  raw_chirps     : Raw radar data of the chirp group as read from the radar
+*  data manager.
+*  first_chirp    : Index of the first chirp of the group within the frame.
+*  n_group_chirps : Number of chirps in the group.
+*  f_cfg          : Frame configuration.
+*  arr            : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_q15_push_chirps(
+    const uint16_t *raw_chirps, uint16_t first_chirp, uint16_t n_group_chirps,
+    frame_cfg *f_cfg, preproc_octobertech_q15_work_arrays *arr
+)
+{
+    _range_chirps_q15(raw_chirps, first_chirp, n_group_chirps, f_cfg, arr);
+}
+
+/* Removes the mean over chirps (slow time) of every range bin, given the sums
+*  in `arr->range_sum`. */
+static void _remove_mean_chirps_q15(
+    preproc_octobertech_q15_work_arrays *arr, frame_cfg *f_cfg
+)
+{
+    int32_t n_chirps = FRAME_N_CHIRPS(f_cfg);
+    uint32_t row = 2 * FRAME_N_RANGE_BINS(f_cfg);
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
+    {
+        q15_t *img = arr->x_range + ch * n_chirps * row;
+        int32_t *sum = arr->range_sum + ch * row;
+        for (uint32_t i = 0; i < row; ++i)
+        {
+            /* Rounded to nearest */
+            sum[i] = (sum[i] + ((sum[i] >= 0) ? n_chirps : -n_chirps) / 2) / n_chirps;
+        }
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            q15_t *el = img + chirp * row;
+            for (uint32_t i = 0; i < row; ++i)
+            {
+                el[i] = (q15_t)__SSAT(el[i] - sum[i], 16);
+            }
+        }
+    }
+}
+
+/* Range profile in float32 units, see `_get_range_profile()`. The magnitudes
+*  are accumulated per range bin without storing the magnitude cube. */
+static void _get_range_profile_q15(
+    preproc_octobertech_q15_work_arrays *arr, frame_cfg *f_cfg,
+    uint16_t min_range_bin
+)
+{
+    for (int idx_rb = 0; idx_rb < FRAME_N_RANGE_BINS(f_cfg); ++idx_rb)
+    {
+        arr->range_acc[idx_rb] = 0;
+    }
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
+    {
+        // 1st chirp is ignored, as in the float32 range profile.
+        for (int chirp = 1; chirp < FRAME_N_CHIRPS(f_cfg); ++chirp)
+        {
+            const q15_t *row = arr->x_range +
+                               2 * (ch * FRAME_N_CHIRPS(f_cfg) + chirp) * FRAME_N_RANGE_BINS(f_cfg);
+            arm_cmplx_mag_q15(row, arr->x_range_abs, FRAME_N_RANGE_BINS(f_cfg));
+            for (int idx_rb = min_range_bin; idx_rb < FRAME_N_RANGE_BINS(f_cfg); ++idx_rb)
+            {
+                arr->range_acc[idx_rb] += arr->x_range_abs[idx_rb];
+            }
+        }
+    }
+    ifx_f32_t scale = arr->range_scale /
+                      (ifx_f32_t)(FRAME_N_CHANNELS(f_cfg) * (FRAME_N_CHIRPS(f_cfg) - 1));
+    for (int idx_rb = min_range_bin; idx_rb < FRAME_N_RANGE_BINS(f_cfg); ++idx_rb)
+    {
+        arr->range_profile[idx_rb - min_range_bin] = arr->range_acc[idx_rb] * scale;
+    }
+}
+
+/* q31 Doppler FFT of a single range bin for every channel, followed by the
+*  channel-averaged (fft-shifted) Doppler profile in float32 units. */
+static void _get_single_range_bin_doppler_q15(
+    preproc_octobertech_q15_work_arrays *arr, uint32_t range_bin,
+    frame_cfg *f_cfg
+)
+{
+    uint16_t n_chirps = FRAME_N_CHIRPS(f_cfg);
+    uint16_t half = n_chirps / 2;
+
+    for (int idx_chirp = 0; idx_chirp < n_chirps; ++idx_chirp)
+    {
+        arr->doppler_profile[idx_chirp] = 0.0f;
+    }
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
+    {
+        q31_t *dst = arr->x_doppler + 2 * ch * n_chirps;
+        const q15_t *src = arr->x_range +
+                           2 * (ch * n_chirps * FRAME_N_RANGE_BINS(f_cfg) + range_bin);
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            dst[2 * chirp] = (q31_t)src[0] * 65536;
+            dst[2 * chirp + 1] = (q31_t)src[1] * 65536;
+            src += 2 * FRAME_N_RANGE_BINS(f_cfg);
+        }
+        arm_cmplx_mult_real_q31(dst, arr->doppler_window, dst, n_chirps);
+        arm_cfft_q31(&arr->doppler_fft, dst, 0, 1);
+
+        arm_cmplx_mag_q31(dst, arr->x_doppler_abs, n_chirps);
+        for (int idx_chirp = 0; idx_chirp < n_chirps; ++idx_chirp)
+        {
+            arr->doppler_profile[idx_chirp] +=
+                (ifx_f32_t)arr->x_doppler_abs[(idx_chirp + half) % n_chirps];
+        }
+    }
+    ifx_f32_t scale = arr->doppler_scale / FRAME_N_CHANNELS(f_cfg);
+    for (int idx_chirp = 0; idx_chirp < n_chirps; ++idx_chirp)
+    {
+        arr->doppler_profile[idx_chirp] *= scale;
+    }
+}
+
+/* Hand features from the q15 range images in `arr->x_range` with the static
+*  targets already suppressed. */
+static void _slim_algo_q15_features(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_q15_work_arrays *arr
+)
+{
+    /* Compute a range profile */
+    PREPROC_PROFILE_BEGIN(t_range_profile);
+    _get_range_profile_q15(arr, f_cfg, min_range_bin);
+    PREPROC_PROFILE_END(PROFILE_STAGE_RANGE_PROFILE, t_range_profile);
+
+    /* Find peak in the range profile - consider it as range to the hand */
+    uint32_t idx_peak_range;
+    ifx_f32_t val_peak_range;
+    arm_max_f32(
+        arr->range_profile, FRAME_N_RANGE_BINS(f_cfg) - min_range_bin, &val_peak_range,
+        &idx_peak_range
+    );
+
+    PREPROC_PROFILE_BEGIN(t_filter);
+    idx_peak_range = filter_range_profile(arr->range_profile, FRAME_N_RANGE_BINS(f_cfg)-min_range_bin, idx_peak_range);
+    PREPROC_PROFILE_END(PROFILE_STAGE_FILTER_RANGE_PROFILE, t_filter);
+
+    idx_peak_range += min_range_bin;
+
+    PREPROC_PROFILE_BEGIN(t_doppler);
+    /* Compute Doppler spectrum for the peak range bin (for each channel), then
+    *   make a Doppler profile.*/
+    _get_single_range_bin_doppler_q15(arr, idx_peak_range, f_cfg);
+
+    PREPROC_PROFILE_END(PROFILE_STAGE_DOPPLER, t_doppler);
+
+    /* Find peak in the Doppler profile - consider it as velocity of the hand */
+    uint32_t idx_peak_doppler;
+    ifx_f32_t val_peak_doppler;
+    arm_max_f32(
+        arr->doppler_profile, FRAME_N_CHIRPS(f_cfg), &val_peak_doppler, &idx_peak_doppler
+    );
+
+    PREPROC_PROFILE_BEGIN(t_angle);
+    /* Extract phases from Doppler spectrum of each channel */
+    uint32_t bin = (idx_peak_doppler + FRAME_N_CHIRPS(f_cfg) / 2) % FRAME_N_CHIRPS(f_cfg);
+    float phases[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        ifx_f32_t re = (ifx_f32_t)arr->x_doppler[2 * (i * FRAME_N_CHIRPS(f_cfg) + bin)];
+        ifx_f32_t im = (ifx_f32_t)arr->x_doppler[2 * (i * FRAME_N_CHIRPS(f_cfg) + bin) + 1];
+        if (angle(re, im, phases + i) != ARM_MATH_SUCCESS) {
+            out->success = false;
+            return;
+        }
+    }
+
+    float azimuth = phase_monopulse(phases[2], phases[0]);
+    float elevation = phase_monopulse(phases[2], phases[1]);
+    azimuth = azimuth + MONOPULSE_AZIMUTH_CORRECTION;
+    elevation = elevation + MONOPULSE_ELEVATION_CORRECTION;
+
+    PREPROC_PROFILE_END(PROFILE_STAGE_ANGLE, t_angle);
+
+    out->success = true;
+    out->detection = (slim_algo_detection
+    )
+    {
+        .range_bin = idx_peak_range,
+        .doppler_bin = idx_peak_doppler,
+        .azimuth = azimuth,
+        .elevation = elevation,
+        .value = val_peak_doppler
+    };
+}
+
+/*******************************************************************************
+* Function Name: slim_algo_q15_from_range_image
+********************************************************************************
+* Summary:
+* Fixed-point counterpart of `slim_algo_from_range_image()`. Extracts hand
+* features for gesture recognition from the q15 range images built by
+* `slim_algo_q15_load_raw_frame()` or `slim_algo_q15_push_chirps()`. See
+* `octobertech_q15.h` for the error bound relative to the float32
+* implementation.
+*
+* Parameters:
+*  out           : out Preprocessing algorithm output containing detected hand
+*  features.
+*  f_cfg         : Frame configuration.
+*  min_range_bin : The closest range bin to use for hand detection.
+*  arr           : Intermediate pre-allocated arrays.
+*
+*******************************************************************************/
+void slim_algo_q15_from_range_image(
+    slim_algo_output *out, frame_cfg *f_cfg, uint16_t min_range_bin,
+    preproc_octobertech_q15_work_arrays *arr
+)
+{
+    /* Suppress static targets */
+    PREPROC_PROFILE_BEGIN(t_remove_mean);
+    _remove_mean_chirps_q15(arr, f_cfg);
+    PREPROC_PROFILE_END(PROFILE_STAGE_REMOVE_MEAN, t_remove_mean);
+    _slim_algo_q15_features(out, f_cfg, min_range_bin, arr);
+}
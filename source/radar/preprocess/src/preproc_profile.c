@@ -0,0 +1,318 @@
+/******************************************************************************
+* File Name:   preproc_profile.c
+*
+* Description: This file implements the per-stage timing of the gesture feature
+*   extraction.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* clock_gettime() of the host build */
+#if !defined(__arm__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "preproc_profile.h"
+
+#ifdef PREPROC_PROFILING
+
+#include "preprocess.h"
+#include "scratch_arena.h"
+#include "windows.h"
+#include "dsp/basic_math_functions.h"
+#include "dsp/fast_math_functions.h"
+#include "dsp/statistics_functions.h"
+#include "dsp/transform_functions.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__arm__)
+#include "cy_device_headers.h"
+#else
+#include <time.h>
+#endif
+
+/* Single producer ring of the most recent samples of a stage. Every stage is
+*  recorded from one task only; readers take a snapshot without locking and
+*  drop the samples the producer may have overwritten meanwhile. */
+typedef struct {
+    atomic_uint_fast32_t head;
+    uint32_t samples[PREPROC_PROFILE_RING_SIZE];
+} profile_ring;
+
+static profile_ring rings[PROFILE_N_STAGES];
+
+static const char *const stage_names[PROFILE_N_STAGES] = {
+    [PROFILE_STAGE_RANGE_FFT] = "range_fft",
+    [PROFILE_STAGE_REMOVE_MEAN] = "remove_mean",
+    [PROFILE_STAGE_RANGE_PROFILE] = "range_profile",
+    [PROFILE_STAGE_FILTER_RANGE_PROFILE] = "filter_range",
+    [PROFILE_STAGE_DOPPLER] = "doppler",
+    [PROFILE_STAGE_ANGLE] = "angle",
+    [PROFILE_STAGE_MODEL] = "model",
+    [PROFILE_STAGE_FRAME] = "frame"
+};
+
+/* Starts the cycle counter (DWT on target) and clears all statistics. */
+void preproc_profile_init(void)
+{
+#if defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    for (int stage = 0; stage < PROFILE_N_STAGES; ++stage)
+    {
+        atomic_store(&rings[stage].head, 0);
+    }
+}
+
+/* Current time stamp, CPU cycles on target and nanoseconds on host. */
+uint32_t preproc_profile_now(void)
+{
+#if defined(__arm__)
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+uint32_t preproc_profile_ticks_per_us(void)
+{
+#if defined(__arm__)
+    return SystemCoreClock / 1000000u;
+#else
+    return 1000u;
+#endif
+}
+
+void preproc_profile_record(profile_stage stage, uint32_t ticks)
+{
+    profile_ring *ring = &rings[stage];
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ring->samples[head % PREPROC_PROFILE_RING_SIZE] = ticks;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: preproc_profile_get_stats
+********************************************************************************
+* Summary:
+* Statistics (in ticks, see `preproc_profile_ticks_per_us()`) over the most
+* recent `PREPROC_PROFILE_RING_SIZE` samples of a stage.
+*
+* Parameters:
+*  stage : Profiled stage.
+*  stats : out Number of samples used, min/mean/max and 99th percentile.
+*
+* Return:
+*  false if the stage has no samples yet.
+*
+*******************************************************************************/
+bool preproc_profile_get_stats(profile_stage stage, profile_stats *stats)
+{
+    profile_ring *ring = &rings[stage];
+    uint32_t sorted[PREPROC_PROFILE_RING_SIZE];
+
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t n = (head < PREPROC_PROFILE_RING_SIZE) ? head : PREPROC_PROFILE_RING_SIZE;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        sorted[i] = ring->samples[(head - n + i) % PREPROC_PROFILE_RING_SIZE];
+    }
+    /* Samples older than the ones written during the copy are still valid */
+    uint_fast32_t written = atomic_load_explicit(&ring->head, memory_order_acquire) - head;
+    uint32_t skip = (written < n) ? written : n;
+    n -= skip;
+    if (n == 0)
+    {
+        return false;
+    }
+
+    /* Insertion sort, the ring is small */
+    uint64_t sum = 0;
+    uint32_t *s = sorted + skip;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t el = s[i];
+        uint32_t j = i;
+        sum += el;
+        while ((j > 0) && (s[j - 1] > el))
+        {
+            s[j] = s[j - 1];
+            --j;
+        }
+        s[j] = el;
+    }
+
+    stats->count = n;
+    stats->min = s[0];
+    stats->mean = (uint32_t)(sum / n);
+    stats->max = s[n - 1];
+    stats->p99 = s[(n * 99 + 99) / 100 - 1];
+    return true;
+}
+
+const char *preproc_profile_stage_name(profile_stage stage)
+{
+    return stage_names[stage];
+}
+
+/* Prints the statistics of all stages in microseconds. */
+void preproc_profile_print(void)
+{
+    uint32_t ticks_per_us = preproc_profile_ticks_per_us();
+    profile_stats stats;
+
+    printf("%-14s %6s %8s %8s %8s %8s [us]\n", "stage", "n", "min", "mean", "max", "p99");
+    for (int stage = 0; stage < PROFILE_N_STAGES; ++stage)
+    {
+        if (!preproc_profile_get_stats((profile_stage)stage, &stats))
+        {
+            continue;
+        }
+        printf("%-14s %6lu %8lu %8lu %8lu %8lu\n", stage_names[stage],
+               (unsigned long)stats.count,
+               (unsigned long)(stats.min / ticks_per_us),
+               (unsigned long)(stats.mean / ticks_per_us),
+               (unsigned long)(stats.max / ticks_per_us),
+               (unsigned long)(stats.p99 / ticks_per_us));
+    }
+}
+
+/*******************************************************************************
+* Function Name: preproc_profile_bench_range_fft
+********************************************************************************
+* Summary:
+* Benchmark of the range FFT on synthetic chirps: the chirp by chirp
+* CMSIS-DSP real FFT (the former `range_transform()`) and
+* `range_fft_batch_f32()` with every batch size from 1 to
+* `range_fft_max_batch()`. Prints the best of `n_runs` runs in ticks per
+* chirp (CPU cycles on target, nanoseconds on host). Runs outside the frame
+* processing, it allocates its buffers from the heap and needs the real FFT
+* plan of `init_fft_plans()`.
+*
+* Parameters:
+*  n_samples : Samples per chirp.
+*  n_chirps  : Chirps per run.
+*  n_runs    : Number of runs per variant.
+*
+*******************************************************************************/
+void preproc_profile_bench_range_fft(uint16_t n_samples, uint16_t n_chirps, uint16_t n_runs)
+{
+    uint16_t n_bins = n_samples / 2;
+    ifx_f32_t *chirps = PREPROC_MALLOC(sizeof(ifx_f32_t) * n_samples * n_chirps);
+    ifx_f32_t *chirp_buffer = PREPROC_MALLOC(sizeof(ifx_f32_t) * n_samples);
+    ifx_cf64_t *out = PREPROC_MALLOC(sizeof(ifx_cf64_t) * n_bins * n_chirps);
+    if ((chirps == NULL) || (chirp_buffer == NULL) || (out == NULL))
+    {
+        PREPROC_FREE(chirps);
+        PREPROC_FREE(chirp_buffer);
+        PREPROC_FREE(out);
+        return;
+    }
+
+    /* Beat tone plus a fixed pseudo random ADC noise */
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < (uint32_t)n_samples * n_chirps; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        chirps[i] = 2048.0f + 1000.0f * arm_sin_f32(0.3f * (i % n_samples)) +
+                    (float32_t)(seed >> 24);
+    }
+    window_view window = get_window_view(&WINDOWS.hann_adc, n_samples);
+    const fft_plan *plan = get_fft_plan(FFT_PLAN_REAL, n_samples);
+    uint16_t max_batch = range_fft_max_batch(n_samples);
+
+    printf("range fft %u samples x %u chirps, best of %u [ticks/chirp, %lu ticks/us]\n",
+           n_samples, n_chirps, n_runs, (unsigned long)preproc_profile_ticks_per_us());
+
+    /* Batch size 0 stands for the chirp by chirp CMSIS-DSP real FFT */
+    for (uint16_t n_batch = 0; n_batch <= max_batch; n_batch = (n_batch == 0) ? 1 : 2 * n_batch)
+    {
+        uint32_t best = UINT32_MAX;
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            uint32_t start = preproc_profile_now();
+            if (n_batch == 0)
+            {
+                for (uint16_t chirp = 0; chirp < n_chirps; ++chirp)
+                {
+                    float32_t mean;
+                    arm_mean_f32(chirps + chirp * n_samples, n_samples, &mean);
+                    arm_offset_f32(chirps + chirp * n_samples, -mean, chirp_buffer, n_samples);
+                    apply_window_f32(chirp_buffer, &window);
+                    arm_rfft_fast_f32(
+                        &plan->instance.rfft, chirp_buffer,
+                        (float32_t *)(out + chirp * n_bins), 0
+                    );
+                    out[chirp * n_bins].data[1] = 0.0f;
+                }
+            }
+            else
+            {
+                for (uint16_t chirp = 0; chirp < n_chirps; chirp += n_batch)
+                {
+                    uint16_t n = n_chirps - chirp;
+                    range_fft_batch_f32(
+                        chirps + chirp * n_samples, out + chirp * n_bins,
+                        (n < n_batch) ? n : n_batch, n_samples, true, &window
+                    );
+                }
+            }
+            uint32_t ticks = preproc_profile_now() - start;
+            best = (ticks < best) ? ticks : best;
+        }
+        if (n_batch == 0)
+        {
+            printf("%-8s %8lu\n", "rfft", (unsigned long)(best / n_chirps));
+        }
+        else
+        {
+            printf("batch %-2u %8lu\n", n_batch, (unsigned long)(best / n_chirps));
+        }
+    }
+
+    PREPROC_FREE(chirps);
+    PREPROC_FREE(chirp_buffer);
+    PREPROC_FREE(out);
+}
+
+#endif /* PREPROC_PROFILING */
@@ -43,6 +43,7 @@
 extern "C" {
 #endif
 #include "preprocess.h"
+#include "frame_geometry.h"
 #ifdef __cplusplus
 }
 #endif
@@ -55,6 +56,7 @@ extern "C" {
 #include "dsp/transform_functions.h"
 #include "ifx_sensor_dsp.h"
 #include "windows.h"
+#include "scratch_arena.h"
 
 #include <assert.h>
 #include <math.h>
@@ -92,20 +94,200 @@ _Complex float  __divsc3(float a, float b, float c, float d) {
 #endif
 
 
+/* FFT plan registry. CMSIS-DSP FFT instances only depend on the transform
+*  kind and length, so each plan is initialized once by `init_fft_plans()`
+*  and reused for every frame. Plans are only added at initialization, before
+*  the processing tasks run, so lookups need no lock. */
+static fft_plan fft_plans[FFT_PLAN_REGISTRY_SIZE];
+static uint16_t n_fft_plans = 0;
+
+/* Tables of the batched real FFT plans, enough for two plans of the largest
+*  size */
+static float32_t fft_batch_twiddles[2 * RANGE_FFT_MAX_SAMPLES];
+static uint8_t fft_batch_bit_rev[RANGE_FFT_MAX_SAMPLES];
+static uint16_t n_fft_batch_twiddles = 0;
+static uint16_t n_fft_batch_bit_rev = 0;
+
+/*******************************************************************************
+* Function Name: _init_range_fft_batch
+********************************************************************************
+* Summary:
+* Computes the twiddle and bit reversal tables of a batched real FFT plan.
+*
+* Parameters:
+*  batch     : out Plan tables.
+*  n_samples : Power of two real FFT length, 4 to `RANGE_FFT_MAX_SAMPLES`.
+*
+* Return:
+*  ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR for an unsupported length.
+*
+*******************************************************************************/
+static arm_status _init_range_fft_batch(
+    range_fft_batch_instance *batch, uint16_t n_samples
+)
+{
+    uint16_t n_bins = n_samples / 2;
+    if ((n_samples < 4) || (n_samples > RANGE_FFT_MAX_SAMPLES) ||
+        ((n_samples & (n_samples - 1)) != 0) ||
+        (n_fft_batch_twiddles + n_samples > 2 * RANGE_FFT_MAX_SAMPLES) ||
+        (n_fft_batch_bit_rev + n_bins > RANGE_FFT_MAX_SAMPLES))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    float32_t *twiddle = fft_batch_twiddles + n_fft_batch_twiddles;
+    uint8_t *bit_rev = fft_batch_bit_rev + n_fft_batch_bit_rev;
+    uint16_t n_bits = 0;
+    while ((1u << n_bits) < n_bins)
+    {
+        n_bits++;
+    }
+    for (int k = 0; k < n_bins; ++k)
+    {
+        float32_t phi = 2.0f * PI * k / n_samples;
+        twiddle[2 * k] = cosf(phi);
+        twiddle[2 * k + 1] = -sinf(phi);
+
+        uint16_t rev = 0;
+        for (int bit = 0; bit < n_bits; ++bit)
+        {
+            rev |= ((k >> bit) & 1u) << (n_bits - 1 - bit);
+        }
+        bit_rev[k] = (uint8_t)rev;
+    }
+    n_fft_batch_twiddles += n_samples;
+    n_fft_batch_bit_rev += n_bins;
+
+    batch->twiddle = twiddle;
+    batch->bit_rev = bit_rev;
+    return ARM_MATH_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: _create_fft_plan
+********************************************************************************
+* Summary:
+* Adds the FFT plan for the given kind and size to the registry, unless it is
+* already there.
+*
+* Parameters:
+*  kind      : Real, batched real or complex transform.
+*  n_samples : Transform length.
+*
+*******************************************************************************/
+static void _create_fft_plan(fft_plan_kind kind, uint16_t n_samples)
+{
+    for (int i = 0; i < n_fft_plans; ++i)
+    {
+        if ((fft_plans[i].kind == kind) && (fft_plans[i].n_samples == n_samples))
+        {
+            return;
+        }
+    }
+
+    if (n_fft_plans == FFT_PLAN_REGISTRY_SIZE)
+    {
+        abort();
+    }
+
+    fft_plan *plan = &fft_plans[n_fft_plans];
+    arm_status status;
+    if (kind == FFT_PLAN_REAL)
+    {
+        status = arm_rfft_fast_init_f32(&plan->instance.rfft, n_samples);
+    }
+    else if (kind == FFT_PLAN_REAL_BATCH)
+    {
+        status = _init_range_fft_batch(&plan->instance.batch, n_samples);
+    }
+    else
+    {
+        status = arm_cfft_init_f32(&plan->instance.cfft, n_samples);
+    }
+    if (status != ARM_MATH_SUCCESS)
+    {
+        abort();
+    }
+    plan->kind = kind;
+    plan->n_samples = n_samples;
+    n_fft_plans++;
+}
+
+/*******************************************************************************
+* Function Name: get_fft_plan
+********************************************************************************
+* Summary:
+* Looks up the FFT plan for the given kind and size.
+*
+* Parameters:
+*  kind      : Real, batched real or complex transform.
+*  n_samples : Transform length.
+*
+* Return:
+*  Pointer to the cached plan. Aborts if `init_fft_plans()` did not create it.
+*
+*******************************************************************************/
+const fft_plan *get_fft_plan(fft_plan_kind kind, uint16_t n_samples)
+{
+    for (int i = 0; i < n_fft_plans; ++i)
+    {
+        if ((fft_plans[i].kind == kind) && (fft_plans[i].n_samples == n_samples))
+        {
+            return &fft_plans[i];
+        }
+    }
+    abort();
+}
+
+/* Builds the plans of the range and Doppler transforms of a frame, so that no
+*  plan is created inside the per-frame processing. Must be called before the
+*  tasks that process frames are started. */
+void init_fft_plans(const frame_cfg *f_cfg)
+{
+    _create_fft_plan(FFT_PLAN_REAL_BATCH, FRAME_N_SAMPLES(f_cfg));
+    _create_fft_plan(FFT_PLAN_REAL, FRAME_N_SAMPLES(f_cfg));
+    _create_fft_plan(FFT_PLAN_COMPLEX, FRAME_N_CHIRPS(f_cfg));
+}
+
+/*******************************************************************************
+* Function Name: frame_cfg_check
+********************************************************************************
+* Summary:
+* With PREPROC_STATIC_GEOMETRY the kernels ignore the run-time frame
+* configuration, so a `frame_cfg` that differs from radar_settings.h is a
+* fatal configuration error.
+*
+* Parameters:
+*  f_cfg : Frame configuration.
+*
+*******************************************************************************/
+void frame_cfg_check(const frame_cfg *f_cfg)
+{
+#if defined(PREPROC_STATIC_GEOMETRY)
+    if ((f_cfg->n_channels != FRAME_CHANNELS) ||
+        (f_cfg->n_chirps != FRAME_CHIRPS) ||
+        (f_cfg->n_samples != FRAME_SAMPLES) ||
+        (f_cfg->n_range_bins != FRAME_RANGE_BINS))
+    {
+        abort();
+    }
+#else
+    (void)f_cfg;
+#endif
+}
+
 void rfft_f32(ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_samples)
 {
     /* Real FFT. Input and output are different buffers. */ 
-    arm_rfft_fast_instance_f32 rfft = {0};
-    arm_rfft_fast_init_f32(&rfft, n_samples);
-    arm_rfft_fast_f32(&rfft, (float32_t *)x, (float32_t *)out, 0);
+    const fft_plan *plan = get_fft_plan(FFT_PLAN_REAL, n_samples);
+    arm_rfft_fast_f32(&plan->instance.rfft, (float32_t *)x, (float32_t *)out, 0);
 }
 
 void cfft_f32(ifx_cf64_t *x, uint16_t n_samples)
 {
     // Complex FFT. Inplace
-    arm_cfft_instance_f32 cfft = {0};
-    arm_cfft_init_f32(&cfft, n_samples);
-    arm_cfft_f32(&cfft, (float32_t *)x, 0, 1);
+    const fft_plan *plan = get_fft_plan(FFT_PLAN_COMPLEX, n_samples);
+    arm_cfft_f32(&plan->instance.cfft, (float32_t *)x, 0, 1);
 }
 
 /*******************************************************************************
@@ -134,20 +316,273 @@ void fftshift_cf64(ifx_cf64_t *in, uint32_t len)
     }
 }
 
-void range_transform(ifx_f32_t *x, ifx_cf64_t *out, range_transform_cfg *cfg)
+/* Batch buffer of `range_fft_batch_f32()`: the chirps are packed into complex
+*  sequences (even samples real, odd samples imaginary part) and bin `k` of
+*  chirp `chirp` is at `buf[2 * (k * n_batch + chirp)]`, so every butterfly
+*  runs over the whole batch with one twiddle. Samples are stored at their bit
+*  reversed bin, so the transform itself needs no reordering pass. */
+static inline void _range_fft_batch_store(
+    float32_t *buf, const range_fft_batch_instance *batch, uint16_t n_batch,
+    uint16_t chirp, uint16_t sample, float32_t value
+)
+{
+    buf[2 * (batch->bit_rev[sample >> 1] * n_batch + chirp) + (sample & 1u)] = value;
+}
+
+/* Radix-2 decimation in time complex FFT of `n_bins` bins of every chirp of
+*  the batch. The inner loop over the batch has independent butterflies, which
+*  keeps the FPU pipeline busy. */
+static void _range_fft_batch_execute(
+    float32_t *buf, const range_fft_batch_instance *batch, uint16_t n_bins,
+    uint16_t n_batch
+)
+{
+    for (uint16_t half = 1; half < n_bins; half *= 2)
+    {
+        /* W_{n_bins}^j = W_{n_samples}^{2 j} */
+        uint16_t tw_step = 2 * (n_bins / (2 * half));
+        for (uint16_t start = 0; start < n_bins; start += 2 * half)
+        {
+            for (uint16_t j = 0; j < half; ++j)
+            {
+                float32_t wr = batch->twiddle[2 * j * tw_step];
+                float32_t wi = batch->twiddle[2 * j * tw_step + 1];
+                float32_t *top = buf + 2 * (start + j) * n_batch;
+                float32_t *bot = top + 2 * half * n_batch;
+                for (uint16_t c = 0; c < 2 * n_batch; c += 2)
+                {
+                    float32_t tr = bot[c] * wr - bot[c + 1] * wi;
+                    float32_t ti = bot[c] * wi + bot[c + 1] * wr;
+                    bot[c] = top[c] - tr;
+                    bot[c + 1] = top[c + 1] - ti;
+                    top[c] += tr;
+                    top[c + 1] += ti;
+                }
+            }
+        }
+    }
+}
+
+/* Splits the packed spectrum of one chirp of the batch into the first
+*  `n_bins` bins of its real FFT. The DC bin is real, no Nyquist bin is
+*  packed into it. */
+static void _range_fft_batch_split(
+    const float32_t *buf, const range_fft_batch_instance *batch,
+    uint16_t n_bins, uint16_t n_batch, uint16_t chirp, ifx_cf64_t *out
+)
+{
+    const float32_t *z0 = buf + 2 * chirp;
+    out[0].data[0] = z0[0] + z0[1];
+    out[0].data[1] = 0.0f;
+
+    for (uint16_t k = 1; k < n_bins; ++k)
+    {
+        const float32_t *zk = buf + 2 * (k * n_batch + chirp);
+        const float32_t *zm = buf + 2 * ((n_bins - k) * n_batch + chirp);
+        /* Spectra of the even (e) and odd (o) samples */
+        float32_t er = 0.5f * (zk[0] + zm[0]);
+        float32_t ei = 0.5f * (zk[1] - zm[1]);
+        float32_t or_ = 0.5f * (zk[1] + zm[1]);
+        float32_t oi = 0.5f * (zm[0] - zk[0]);
+        float32_t wr = batch->twiddle[2 * k];
+        float32_t wi = batch->twiddle[2 * k + 1];
+        out[k].data[0] = er + wr * or_ - wi * oi;
+        out[k].data[1] = ei + wr * oi + wi * or_;
+    }
+}
+
+/*******************************************************************************
+* Function Name: range_fft_max_batch
+********************************************************************************
+* Summary:
+* Largest batch of `range_fft_batch_f32()` for the given chirp length, at most
+* `RANGE_FFT_BATCH`.
+*
+* Parameters:
+*  n_samples : Samples per chirp.
+*
+* Return:
+*  Number of chirps per batch, at least 1.
+*
+*******************************************************************************/
+uint16_t range_fft_max_batch(uint16_t n_samples)
+{
+    uint16_t n_bins = (n_samples > 2) ? n_samples / 2 : 1;
+    uint16_t n_batch = RANGE_FFT_BATCH_BINS / n_bins;
+    if (n_batch > RANGE_FFT_BATCH)
+    {
+        n_batch = RANGE_FFT_BATCH;
+    }
+    return (n_batch > 0) ? n_batch : 1;
+}
+
+/*******************************************************************************
+* Function Name: range_fft_batch_f32
+********************************************************************************
+* Summary:
+* Range FFT of a batch of consecutive chirps. Mean removal and windowing are
+* done while the samples are loaded into the batch buffer, the chirps are
+* transformed together and the DC bin is made real while the spectra are
+* written, so `x` is not modified. Gives the first `n_samples / 2` bins of the
+* real FFT, like `arm_rfft_fast_f32()` followed by clearing the imaginary part
+* of the DC bin.
+*
+* Parameters:
+*  x           : Chirps [n_batch][n_samples].
+*  out         : Range spectra [n_batch][n_samples / 2].
+*  n_batch     : Number of chirps, at most `range_fft_max_batch(n_samples)`.
+*  n_samples   : Samples per chirp, a power of two.
+*  remove_mean : Removes the mean of every chirp before windowing.
+*  window      : Range window of `n_samples` elements or NULL.
+*
+*******************************************************************************/
+void range_fft_batch_f32(
+    const ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_batch, uint16_t n_samples,
+    bool remove_mean, const window_view *window
+)
 {
-    uint32_t status = ifx_range_fft_f32(
-                          (float32_t *)x, (cfloat32_t *)out, cfg->remove_mean,
-                          (float32_t *)cfg->window, cfg->n_samples, cfg->n_chirps
-                      );
-    if (status == IFX_SENSOR_DSP_ARGUMENT_ERROR)
+    const range_fft_batch_instance *batch =
+        &get_fft_plan(FFT_PLAN_REAL_BATCH, n_samples)->instance.batch;
+    uint16_t n_bins = n_samples / 2;
+    float32_t buf[2 * RANGE_FFT_BATCH_BINS];
+
+    if (n_batch * n_bins > RANGE_FFT_BATCH_BINS)
     {
         abort();
     }
 
-    for (int chirp = 0; chirp < cfg->n_chirps; chirp++)
+    for (uint16_t chirp = 0; chirp < n_batch; ++chirp)
+    {
+        const float32_t *chirp_data = x + chirp * n_samples;
+        float32_t mean = 0.0f;
+        if (remove_mean)
+        {
+            arm_mean_f32(chirp_data, n_samples, &mean);
+        }
+        uint16_t last = n_samples - 1;
+        for (uint16_t i = 0; i < n_samples / 2; ++i)
+        {
+            float32_t w = (window != NULL) ? window->half[i] : 1.0f;
+            _range_fft_batch_store(buf, batch, n_batch, chirp, i, (chirp_data[i] - mean) * w);
+            _range_fft_batch_store(
+                buf, batch, n_batch, chirp, last - i, (chirp_data[last - i] - mean) * w
+            );
+        }
+    }
+
+    _range_fft_batch_execute(buf, batch, n_bins, n_batch);
+
+    for (uint16_t chirp = 0; chirp < n_batch; ++chirp)
+    {
+        _range_fft_batch_split(buf, batch, n_bins, n_batch, chirp, out + chirp * n_bins);
+    }
+}
+
+void range_transform(const ifx_f32_t *x, ifx_cf64_t *out, range_transform_cfg *cfg)
+{
+    /* Same processing as `ifx_range_fft_f32()`, `RANGE_FFT_BATCH` chirps at
+    *  a time */
+    uint16_t n_range_bins = cfg->n_samples / 2;
+    uint16_t n_batch = range_fft_max_batch(cfg->n_samples);
+
+    for (uint16_t chirp = 0; chirp < cfg->n_chirps; chirp += n_batch)
+    {
+        uint16_t n = cfg->n_chirps - chirp;
+        range_fft_batch_f32(
+            x + chirp * cfg->n_samples, out + chirp * n_range_bins,
+            (n < n_batch) ? n : n_batch, cfg->n_samples, cfg->remove_mean,
+            cfg->window
+        );
+    }
+}
+
+/*******************************************************************************
+* Function Name: doppler_column_f32
+********************************************************************************
+* Summary:
+* Doppler FFT over the chirps of a single range bin with the zero Doppler bin
+* in the centre (index `n_chirps / 2`), i.e. the same as an FFT followed by
+* `fftshift_cf64()`. The shift is done by modulating the window with
+* (-1)^chirp, so no extra pass over the spectrum is needed.
+*
+* Parameters:
+*  in           : First chirp of the range bin.
+*  stride       : Distance between chirps in `in` (in elements), e.g.
+*  `n_range_bins` for a range image [n_chirps][n_range_bins].
+*  out          : out Centred Doppler spectrum of `n_chirps` elements. May be
+*  `in` if `stride` is 1.
+*  remove_mean  : Removes the mean over chirps before windowing.
+*  window       : Doppler window of `n_chirps` elements or NULL.
+*  n_chirps     : Number of chirps (FFT length), even.
+*
+*******************************************************************************/
+void doppler_column_f32(
+    const ifx_cf64_t *in, uint32_t stride, ifx_cf64_t *out, bool remove_mean,
+    const window_view *window, uint16_t n_chirps
+)
+{
+    const fft_plan *plan = get_fft_plan(FFT_PLAN_COMPLEX, n_chirps);
+    cfloat32_t *col = (cfloat32_t *)out;
+
+    for (int chirp = 0; chirp < n_chirps; ++chirp)
+    {
+        col[chirp] = *(const cfloat32_t *)(in + chirp * stride);
+    }
+    if (remove_mean)
+    {
+        cfloat32_t sum = 0.0f;
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            sum += col[chirp];
+        }
+        sum /= n_chirps;
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            col[chirp] -= sum;
+        }
+    }
+    /* `n_chirps` is even, so mirrored chirps have opposite modulation signs */
+    for (int chirp = 0; chirp < n_chirps / 2; ++chirp)
+    {
+        float32_t w = (window != NULL) ? window->half[chirp] : 1.0f;
+        w = (chirp & 1) ? -w : w;
+        col[chirp] *= w;
+        col[n_chirps - 1 - chirp] *= -w;
+    }
+    arm_cfft_f32(&plan->instance.cfft, (float32_t *)col, 0, 1);
+}
+
+/*******************************************************************************
+* Function Name: range_doppler_image_f32
+********************************************************************************
+* Summary:
+* Turns a range image [n_chirps][n_range_bins] in place into a range-Doppler
+* image with the same layout and the zero Doppler row in the centre (row
+* `n_chirps / 2`). No transpose or fftshift passes and no heap are needed.
+*
+* Parameters:
+*  x            : in Range image, out range-Doppler image.
+*  remove_mean  : Removes the mean over chirps before windowing.
+*  window       : Doppler window of `n_chirps` elements or NULL.
+*  n_range_bins : Number of range bins.
+*  n_chirps     : Number of chirps, at most `RDI_MAX_CHIRPS`.
+*
+*******************************************************************************/
+void range_doppler_image_f32(
+    ifx_cf64_t *x, bool remove_mean, const window_view *window,
+    uint16_t n_range_bins, uint16_t n_chirps
+)
+{
+    ifx_cf64_t column[RDI_MAX_CHIRPS];
+    assert(n_chirps <= RDI_MAX_CHIRPS);
+
+    for (int bin = 0; bin < n_range_bins; ++bin)
     {
-        ((ifx_cf64_t *)out + (chirp * cfg->n_samples / 2))->data[1] = 0.0;
+        doppler_column_f32(x + bin, n_range_bins, column, remove_mean, window, n_chirps);
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            x[chirp * n_range_bins + bin] = column[chirp];
+        }
     }
 }
 
@@ -155,66 +590,216 @@ void range_doppler_transform(
     ifx_f32_t *x, ifx_cf64_t *out, range_doppler_transform_cfg *cfg
 )
 {
-    cfloat32_t* range_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
-    cfloat32_t* doppler_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
-
     range_transform_cfg range_cfg = {
         .n_samples = cfg->n_samples,
         .n_chirps = cfg->n_chirps,
         .remove_mean = cfg->range_remove_mean,
         .window = cfg->range_window
     };
-    range_transform(x, (ifx_cf64_t *)range_array, &range_cfg);
-
-    uint32_t status = ifx_doppler_cfft_f32(
-                          range_array, doppler_array, cfg->doppler_remove_mean, cfg->doppler_window,
-                          cfg->n_samples / 2, cfg->n_chirps
-                      );
-    if (status == IFX_SENSOR_DSP_ARGUMENT_ERROR)
-    {
-        abort();
-    }
+    range_transform(x, out, &range_cfg);
 
-    arm_matrix_instance_f32 doppler_matrix =
-    {
-        cfg->n_samples / 2, cfg->n_chirps, (float32_t *)doppler_array
-    };
-    arm_matrix_instance_f32 out_matrix =
-    {
-        cfg->n_chirps, cfg->n_samples / 2, (float32_t *)out
-    };
-    (void)arm_mat_cmplx_trans_f32(&doppler_matrix, &out_matrix);
-    fftshift_cf64((ifx_cf64_t *)out, cfg->n_chirps * cfg->n_samples / 2);
-
-    free(range_array);
-    free(doppler_array);
+    range_doppler_image_f32(
+        out, cfg->doppler_remove_mean, cfg->doppler_window, cfg->n_samples / 2,
+        cfg->n_chirps
+    );
 }
 
+/*******************************************************************************
+* Function Name: build_complex_range_image
+********************************************************************************
+* Summary:
+* Range images of a de-interleaved frame of raw ADC codes. The ADC
+* normalization is folded into the window, `raw_frame` is not modified.
+*
+* Parameters:
+*  raw_frame  : Raw frame [n_channels][n_chirps][n_samples] in ADC codes.
+*  out        : Range images [n_channels][n_chirps][n_range_bins].
+*  f_cfg      : Frame configuration.
+*  adc_window : Range window with the `1/ADC_NORMALIZATION` factor folded in,
+*  e.g. a view of `WINDOWS.hann_adc`.
+*
+*******************************************************************************/
 void build_complex_range_image(
-    ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg, ifx_f32_t *window
+    const ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg,
+    const window_view *adc_window
 )
 {
     uint16_t src_idx = 0;
     uint16_t dst_idx = 0;
     range_transform_cfg range_transf_cfg =
     {
-        .n_chirps = f_cfg->n_chirps,
-        .n_samples = f_cfg->n_samples,
+        .n_chirps = FRAME_N_CHIRPS(f_cfg),
+        .n_samples = FRAME_N_SAMPLES(f_cfg),
         .remove_mean = true,
-        .window = window
+        .window = adc_window
     };
 
-    uint16_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
-    arm_scale_f32(
-        (float32_t *)raw_frame, 1.0 / (float32_t)ADC_NORMALIZATION,
-        (float32_t *)raw_frame, frame_size
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
+    {
+        range_transform(raw_frame + src_idx, out + dst_idx, &range_transf_cfg);
+        src_idx += FRAME_N_CHIRPS(f_cfg) * FRAME_N_SAMPLES(f_cfg);
+        dst_idx += FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    }
+}
+
+/*******************************************************************************
+* Function Name: build_complex_range_image_u16
+********************************************************************************
+* Summary:
+* Fused range image front-end working directly on the raw radar FIFO data.
+* De-interleaving, ADC normalization, mean removal and windowing are done in a
+* single pass per chirp that writes straight into the batch buffer of the range
+* FFT, so no de-interleaved float copy of the frame is needed.
+*
+* Parameters:
+*  raw_frame    : Raw FIFO frame, samples interleaved over the antennas:
+*  [n_chirps][n_samples][n_channels].
+*  out          : Range images [n_channels][n_chirps][n_range_bins].
+*  f_cfg        : Frame configuration.
+*  adc_window   : Range window with the `1/ADC_NORMALIZATION` factor folded
+*  in (`n_samples` elements).
+*
+*******************************************************************************/
+void build_complex_range_image_u16(
+    const uint16_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg,
+    const window_view *adc_window
+)
+{
+    build_complex_range_chirps_u16(
+        raw_frame, out, f_cfg, 0, FRAME_N_CHIRPS(f_cfg), adc_window, NULL
     );
+}
 
-    for (int ch = 0; ch < f_cfg->n_channels; ++ch)
+/*******************************************************************************
+* Function Name: build_complex_range_chirps_u16
+********************************************************************************
+* Summary:
+* Range FFT of a group of consecutive chirps of a frame, see
+* `build_complex_range_image_u16()`. Used to build the range images chirp group
+* by chirp group while the frame is still being acquired. Optionally
+* accumulates the per range bin sum over the chirps, so the mean over chirps
+* is available once the last chirp of the frame is in.
+*
+* Parameters:
+*  raw_chirps   : Raw FIFO data of the chirp group, samples interleaved over
+*  the antennas: [n_group_chirps][n_samples][n_channels].
+*  out          : Range images [n_channels][n_chirps][n_range_bins] of the
+*  whole frame, only the rows of the chirp group are written.
+*  f_cfg        : Frame configuration.
+*  first_chirp  : Index of the first chirp of the group within the frame.
+*  n_group_chirps : Number of chirps in the group.
+*  adc_window   : Range window with the `1/ADC_NORMALIZATION` factor folded
+*  in (`n_samples` elements).
+*  bin_sum      : Running sum over chirps [n_channels][n_range_bins], reset
+*  when `first_chirp` is 0. May be NULL.
+*
+*******************************************************************************/
+void build_complex_range_chirps_u16(
+    const uint16_t *raw_chirps, ifx_cf64_t *out, frame_cfg *f_cfg,
+    uint16_t first_chirp, uint16_t n_group_chirps,
+    const window_view *adc_window, ifx_cf64_t *bin_sum
+)
+{
+    const range_fft_batch_instance *batch =
+        &get_fft_plan(FFT_PLAN_REAL_BATCH, FRAME_N_SAMPLES(f_cfg))->instance.batch;
+    uint16_t n_channels = FRAME_N_CHANNELS(f_cfg);
+    uint16_t n_samples = FRAME_N_SAMPLES(f_cfg);
+    uint16_t max_batch = range_fft_max_batch(n_samples);
+    uint32_t chirp_stride = n_samples * n_channels;
+    float32_t buf[2 * RANGE_FFT_BATCH_BINS];
+
+    if ((bin_sum != NULL) && (first_chirp == 0))
     {
-        range_transform(raw_frame + src_idx, out + dst_idx, &range_transf_cfg);
-        src_idx += f_cfg->n_chirps * f_cfg->n_samples;
-        dst_idx += f_cfg->n_chirps * f_cfg->n_range_bins;
+        memset(bin_sum, 0, sizeof(ifx_cf64_t) * n_channels * FRAME_N_RANGE_BINS(f_cfg));
+    }
+
+    for (int ch = 0; ch < n_channels; ++ch)
+    {
+        ifx_cf64_t *ch_out = out + ch * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+        for (uint16_t batch_start = 0; batch_start < n_group_chirps; batch_start += max_batch)
+        {
+            uint16_t n_batch = n_group_chirps - batch_start;
+            n_batch = (n_batch < max_batch) ? n_batch : max_batch;
+
+            for (uint16_t chirp = 0; chirp < n_batch; ++chirp)
+            {
+                const uint16_t *src = raw_chirps + (batch_start + chirp) * chirp_stride + ch;
+
+                uint32_t sum = 0;
+                for (int i = 0; i < n_samples; ++i)
+                {
+                    sum += src[i * n_channels];
+                }
+                ifx_f32_t mean = (ifx_f32_t)sum / n_samples;
+
+                uint16_t last = n_samples - 1;
+                for (uint16_t i = 0; i < n_samples / 2; ++i)
+                {
+                    ifx_f32_t w = adc_window->half[i];
+                    _range_fft_batch_store(
+                        buf, batch, n_batch, chirp, i,
+                        ((ifx_f32_t)src[i * n_channels] - mean) * w
+                    );
+                    _range_fft_batch_store(
+                        buf, batch, n_batch, chirp, last - i,
+                        ((ifx_f32_t)src[(last - i) * n_channels] - mean) * w
+                    );
+                }
+            }
+
+            _range_fft_batch_execute(buf, batch, n_samples / 2, n_batch);
+
+            for (uint16_t chirp = 0; chirp < n_batch; ++chirp)
+            {
+                ifx_cf64_t *chirp_out =
+                    ch_out + (first_chirp + batch_start + chirp) * FRAME_N_RANGE_BINS(f_cfg);
+                _range_fft_batch_split(buf, batch, n_samples / 2, n_batch, chirp, chirp_out);
+
+                if (bin_sum != NULL)
+                {
+                    arm_add_f32(
+                        (float32_t *)(bin_sum + ch * FRAME_N_RANGE_BINS(f_cfg)),
+                        (float32_t *)chirp_out,
+                        (float32_t *)(bin_sum + ch * FRAME_N_RANGE_BINS(f_cfg)),
+                        2 * FRAME_N_RANGE_BINS(f_cfg)
+                    );
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: remove_mean_chirps_cf64
+********************************************************************************
+* Summary:
+* Removes the mean over chirps (slow time) of every range bin using sums
+* accumulated by `build_complex_range_chirps_u16()`. Equivalent to
+* `remove_mean_3d_cf64()` over axis 1.
+*
+* Parameters:
+*  x_range : Range images [n_channels][n_chirps][n_range_bins].
+*  bin_sum : Sum over chirps [n_channels][n_range_bins].
+*  f_cfg   : Frame configuration.
+*
+*******************************************************************************/
+void remove_mean_chirps_cf64(
+    ifx_cf64_t *x_range, ifx_cf64_t *bin_sum, const frame_cfg *f_cfg
+)
+{
+    uint32_t len = FRAME_N_CHANNELS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    arm_scale_f32(
+        (float32_t *)bin_sum, 1.0f / FRAME_N_CHIRPS(f_cfg), (float32_t *)bin_sum, 2 * len
+    );
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
+    {
+        ifx_cf64_t *mean = bin_sum + ch * FRAME_N_RANGE_BINS(f_cfg);
+        for (int chirp = 0; chirp < FRAME_N_CHIRPS(f_cfg); ++chirp)
+        {
+            float32_t *row = (float32_t *)(x_range +
+                (ch * FRAME_N_CHIRPS(f_cfg) + chirp) * FRAME_N_RANGE_BINS(f_cfg));
+            arm_sub_f32(row, (float32_t *)mean, row, 2 * FRAME_N_RANGE_BINS(f_cfg));
+        }
     }
 }
 
@@ -224,35 +809,27 @@ void build_complex_rdi(
 {
     uint16_t src_idx = 0;
     uint16_t dst_idx = 0;
-    ifx_f32_t *range_window = (ifx_f32_t*) malloc(sizeof(ifx_f32_t) * f_cfg->n_samples);
-    get_window(&WINDOWS.hann, range_window, f_cfg->n_samples);
-    ifx_f32_t *doppler_window = (ifx_f32_t*) malloc(sizeof(ifx_f32_t) * f_cfg->n_chirps);
-    get_window(&WINDOWS.kaiser_b25, doppler_window, f_cfg->n_chirps);
-    
+    window_view range_window =
+        get_window_view(&WINDOWS.hann_adc, FRAME_N_SAMPLES(f_cfg));
+    window_view doppler_window =
+        get_window_view(&WINDOWS.kaiser_b25, FRAME_N_CHIRPS(f_cfg));
+
     range_doppler_transform_cfg rd_cfg =
     {
-        .n_chirps = f_cfg->n_chirps,
-        .n_samples = f_cfg->n_samples,
+        .n_chirps = FRAME_N_CHIRPS(f_cfg),
+        .n_samples = FRAME_N_SAMPLES(f_cfg),
         .range_remove_mean = true,
         .doppler_remove_mean = true,
-        .range_window = range_window,
-        .doppler_window = doppler_window
+        .range_window = &range_window,
+        .doppler_window = &doppler_window
     };
-    uint16_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
-    arm_scale_f32(
-        (float32_t *)raw_frame, 1.0 / (float32_t)ADC_NORMALIZATION,
-        (float32_t *)raw_frame, frame_size
-    );
 
-    for (int ch = 0; ch < f_cfg->n_channels; ++ch)
+    for (int ch = 0; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
     {
         range_doppler_transform(raw_frame + src_idx, out + dst_idx, &rd_cfg);
-        src_idx += f_cfg->n_chirps * f_cfg->n_samples;
-        dst_idx += f_cfg->n_chirps * f_cfg->n_range_bins;
+        src_idx += FRAME_N_CHIRPS(f_cfg) * FRAME_N_SAMPLES(f_cfg);
+        dst_idx += FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
     }
-
-    free(range_window);
-    free(doppler_window);
 }
 
 void estimate_human(
@@ -264,17 +841,17 @@ void estimate_human(
     /* Look at two rows around 0 velocity (excluding the one in between == 
     n_chirps/2 + 0) */
     uint16_t search_rows[] = {
-        (f_cfg->n_chirps / 2) - 1, (f_cfg->n_chirps / 2) + 1
+        (FRAME_N_CHIRPS(f_cfg) / 2) - 1, (FRAME_N_CHIRPS(f_cfg) / 2) + 1
     };
     uint16_t row;
     for (int row_idx = 0; row_idx < 2; ++row_idx)
     {
-        for (int col = cfg->position_min; col < f_cfg->n_range_bins; ++col)
+        for (int col = cfg->position_min; col < FRAME_N_RANGE_BINS(f_cfg); ++col)
         {
             row = search_rows[row_idx];
-            if (frame_abs_rdi[row * f_cfg->n_range_bins + col] > peak_val)
+            if (frame_abs_rdi[row * FRAME_N_RANGE_BINS(f_cfg) + col] > peak_val)
             {
-                peak_val = frame_abs_rdi[row * f_cfg->n_range_bins + col];
+                peak_val = frame_abs_rdi[row * FRAME_N_RANGE_BINS(f_cfg) + col];
                 peak_range = col;
             }
         }
@@ -310,16 +887,16 @@ cmplx_frame_transpose(ifx_cf64_t *src, ifx_cf64_t *dst, frame_cfg *f_cfg)
 {
     ifx_status status=0;
     uint16_t offset = 0;
-    for (int i = 0; i < f_cfg->n_channels; ++i)
+    for (int i = 0; i < FRAME_N_CHANNELS(f_cfg); ++i)
     {
         status = cmplx_image_transpose(
-                     src + offset, dst + offset, f_cfg->n_chirps, f_cfg->n_range_bins
+                     src + offset, dst + offset, FRAME_N_CHIRPS(f_cfg), FRAME_N_RANGE_BINS(f_cfg)
                  );
         if (status != ARM_MATH_SUCCESS)
         {
             return status;
         }
-        offset += f_cfg->n_chirps * f_cfg->n_range_bins;
+        offset += FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
     }
     return status;
 }
@@ -328,21 +905,63 @@ void mean_rdi_channel_f32(
     ifx_f32_t *abs_rdi, ifx_f32_t *mean, frame_cfg *f_cfg
 )
 {
-
-    uint16_t len = f_cfg->n_chirps * f_cfg->n_range_bins;
-    for (int i = 0; i < len; ++i)
+    /* Channel-outer accumulation over contiguous images, same summation order
+    *  as an element-wise sum over channels */
+    uint16_t len = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    arm_copy_f32((float32_t *)abs_rdi, (float32_t *)mean, len);
+    for (int ch = 1; ch < FRAME_N_CHANNELS(f_cfg); ++ch)
     {
-        mean[i] = 0.0;
-        for (int ch = 0; ch < f_cfg->n_channels; ++ch)
-        {
-            mean[i] += abs_rdi[ch * len + i];
-        }
+        arm_add_f32(
+            (float32_t *)mean, (float32_t *)(abs_rdi + ch * len),
+            (float32_t *)mean, len
+        );
     }
     arm_scale_f32(
-        (float32_t *)mean, 1.0 / f_cfg->n_channels, (float32_t *)mean, len
+        (float32_t *)mean, 1.0 / FRAME_N_CHANNELS(f_cfg), (float32_t *)mean, len
     );
 }
 
+/* Columns per pass of `cmplx_mag_accumulate_rows_f32()`, bounds its stack
+*  buffer. */
+#define MAG_ACCUMULATE_BLOCK (32)
+
+/*******************************************************************************
+* Function Name: cmplx_mag_accumulate_rows_f32
+********************************************************************************
+* Summary:
+* Fused magnitude and reduction over rows: `acc[col] += sum_row |x[row][col]|`.
+* Magnitudes are computed a block of columns at a time into a small stack
+* buffer and added with CMSIS-DSP, so no magnitude image is written. Range and
+* Doppler profiles are built by zeroing `acc`, accumulating every channel and
+* scaling once.
+*
+* Parameters:
+*  x          : First element of the first row.
+*  row_stride : Distance between rows of `x` (in elements).
+*  n_rows     : Number of rows to reduce.
+*  n_cols     : Number of columns (elements of `acc`).
+*  acc        : in/out Accumulator.
+*
+*******************************************************************************/
+void cmplx_mag_accumulate_rows_f32(
+    const ifx_cf64_t *x, uint32_t row_stride, uint16_t n_rows, uint16_t n_cols,
+    ifx_f32_t *acc
+)
+{
+    float32_t mag[MAG_ACCUMULATE_BLOCK];
+    for (int col = 0; col < n_cols; col += MAG_ACCUMULATE_BLOCK)
+    {
+        uint16_t block = n_cols - col;
+        block = (block < MAG_ACCUMULATE_BLOCK) ? block : MAG_ACCUMULATE_BLOCK;
+        for (int row = 0; row < n_rows; ++row)
+        {
+            arm_cmplx_mag_f32(
+                (const float32_t *)(x + row * row_stride + col), mag, block
+            );
+            arm_add_f32((float32_t *)acc + col, mag, (float32_t *)acc + col, block);
+        }
+    }
+}
 
 uint16_t calculate_lower_range_limit(
     uint16_t roi_upper_limit, uint16_t band_max, uint16_t range_min
@@ -381,11 +1000,11 @@ void get_hand_roi(
 {
 
     search_region->row_start = 0;
-    search_region->row_end = f_cfg->n_chirps;
+    search_region->row_end = FRAME_N_CHIRPS(f_cfg);
     search_region->col_start = lower_range_limit;
-    if (upper_range_limit > f_cfg->n_range_bins)
+    if (upper_range_limit > FRAME_N_RANGE_BINS(f_cfg))
     {
-        search_region->col_end = f_cfg->n_range_bins;
+        search_region->col_end = FRAME_N_RANGE_BINS(f_cfg);
     } else
     {
         search_region->col_end = upper_range_limit;
@@ -395,8 +1014,8 @@ void get_hand_roi(
     guard_range = (guard_range < range_width) ? guard_range : range_width;
     human_mask->col_start = search_region->col_end - guard_range;
     human_mask->col_end = search_region->col_end;
-    human_mask->row_start = (f_cfg->n_chirps / 2) - guard_doppler;
-    human_mask->row_end = (f_cfg->n_chirps / 2) + guard_doppler + 1;
+    human_mask->row_start = (FRAME_N_CHIRPS(f_cfg) / 2) - guard_doppler;
+    human_mask->row_end = (FRAME_N_CHIRPS(f_cfg) / 2) + guard_doppler + 1;
 }
 
 void mask_hand_roi(
@@ -407,11 +1026,11 @@ void mask_hand_roi(
     /* Initialize `masked_out` with zeros, let the compiler optimize with memset
     *  if it wants */
     int offset;
-    for (int row = 0; row < f_cfg->n_chirps; ++row)
+    for (int row = 0; row < FRAME_N_CHIRPS(f_cfg); ++row)
     {
-        for (int col = 0; col < f_cfg->n_range_bins; ++col)
+        for (int col = 0; col < FRAME_N_RANGE_BINS(f_cfg); ++col)
         {
-            offset = row * f_cfg->n_range_bins + col;
+            offset = row * FRAME_N_RANGE_BINS(f_cfg) + col;
             *(masked_out + offset) = 0.0;
         }
     }
@@ -422,7 +1041,7 @@ void mask_hand_roi(
         for (int col = search_region->col_start; col < search_region->col_end;
                 ++col)
         {
-            offset = row * f_cfg->n_range_bins + col;
+            offset = row * FRAME_N_RANGE_BINS(f_cfg) + col;
             *(masked_out + offset) = *(mean_abs_rdi + offset);
         }
     }
@@ -431,7 +1050,7 @@ void mask_hand_roi(
     {
         for (int col = human_mask->col_start; col < human_mask->col_end; ++col)
         {
-            offset = row * f_cfg->n_range_bins + col;
+            offset = row * FRAME_N_RANGE_BINS(f_cfg) + col;
             *(masked_out + offset) = 0.0;
         }
     }
@@ -452,8 +1071,9 @@ float get_background_level(
 {
     /* Compute median of positive (non-zero in an absolute rdi) elements in the
     * region of interest. */
-    int len = f_cfg->n_chirps * f_cfg->n_range_bins;
-    ifx_f32_t* tmp = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * len);
+    int len = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    scratch_mark mark = scratch_get_mark();
+    ifx_f32_t* tmp = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * len);
     memcpy(tmp, masked_mean_abs_rdi, len * sizeof(ifx_f32_t));
     qsort((void *)tmp, len, sizeof(ifx_f32_t), compare_ifx_f32);
     /* Find index of first element greater than 0.0 */
@@ -467,7 +1087,7 @@ float get_background_level(
     }
     if (idx == len)
     {
-        free(tmp);
+        scratch_release(mark);
         /* No elements greater than 0.0 => return background_level == 0.0 */
         return 0.0;
     }
@@ -477,14 +1097,14 @@ float get_background_level(
     {
         float ret = (tmp[idx + n_nonzero / 2 - 1] + tmp[idx + n_nonzero / 2]) / 2;
         
-        free(tmp);
+        scratch_release(mark);
 
         return ret;
     }
 
     float ret_val = tmp[idx + n_nonzero / 2];
 
-    free(tmp);
+    scratch_release(mark);
 
     return ret_val;
 }
@@ -494,121 +1114,183 @@ void make_doppler_profile(
     const region *search_region, const frame_cfg *f_cfg
 )
 {
-    /* Mean over range bins in the channel-combined-abs-rdi */
+    /* Mean over range bins in the channel-combined-abs-rdi, the row segments
+    *  of the search region are contiguous */
     uint16_t n_rows = search_region->row_end - search_region->row_start;
     uint16_t n_cols = search_region->col_end - search_region->col_start;
-    uint16_t frame_row, frame_col;
+    const ifx_f32_t *row = mean_abs_rdi +
+        search_region->row_start * FRAME_N_RANGE_BINS(f_cfg) + search_region->col_start;
     for (int local_row = 0; local_row < n_rows; ++local_row)
     {
-        profile[local_row] = 0.0;
-        frame_row = local_row + search_region->row_start;
-        for (int local_col = 0; local_col < n_cols; ++local_col)
-        {
-            frame_col = local_col + search_region->col_start;
-            profile[local_row] +=
-                mean_abs_rdi[frame_row * f_cfg->n_range_bins + frame_col];
-        }
+        arm_mean_f32((float32_t *)row, n_cols, (float32_t *)&profile[local_row]);
+        row += FRAME_N_RANGE_BINS(f_cfg);
     }
-    arm_scale_f32(
-        (float32_t *)profile, 1.0 / n_cols, (float32_t *)profile, n_rows
-    );
 }
 
-typedef struct
+static inline bool peak_greater(
+    const ifx_f32_t *in, uint16_t a, uint16_t b
+)
 {
-    void *el;
-    uint16_t idx;
-} argsort_tuple;
+    return (in[a] > in[b]) || ((in[a] == in[b]) && (a > b));
+}
 
-int compare_argsort_tuples_ifx_f32_t(const void *a, const void *b)
+/* Restores the min-heap property (smallest peak at the root) below `pos`. */
+static void peak_heap_sift_down(
+    const ifx_f32_t *in, uint16_t *heap, uint16_t pos, uint16_t size
+)
 {
-    ifx_f32_t aa = *((ifx_f32_t *)(((argsort_tuple *)a)->el));
-    ifx_f32_t bb = *((ifx_f32_t *)(((argsort_tuple *)b)->el));
-    if (aa > bb)
+    uint16_t el = heap[pos];
+    for (;;)
     {
-        return 1;
-    }
-    if (aa < bb)
-    {
-        return -1;
+        uint16_t child = 2 * pos + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if ((child + 1 < size) && peak_greater(in, heap[child], heap[child + 1]))
+        {
+            child += 1;
+        }
+        if (!peak_greater(in, el, heap[child]))
+        {
+            break;
+        }
+        heap[pos] = heap[child];
+        pos = child;
     }
-    return 0;
+    heap[pos] = el;
 }
 
+/*******************************************************************************
+* Function Name: find_peaks
+********************************************************************************
+* Summary:
+* Selects the indices of the `n_peaks` largest elements of `in`, in
+* descending order of value. Equal values are ordered by descending index.
+* The selection uses a bounded min-heap built in place in `idx`, so it needs
+* no allocation and O(n_elements * log(n_peaks)) comparisons.
+*
+* Parameters:
+*  in         : Input profile.
+*  idx        : out Indices of the peaks, `n_peaks` elements.
+*  n_elements : Number of elements in `in`.
+*  n_peaks    : Number of peaks to select, not more than `n_elements`.
+*
+*******************************************************************************/
 void find_peaks(
     const ifx_f32_t *in, uint16_t *idx, uint16_t n_elements, uint16_t n_peaks
 )
 {
-    /* `idx` array must be preallocated to fit `n_peaks` indices */
-
-    argsort_tuple* indexed = (argsort_tuple*)malloc(sizeof(argsort_tuple) * n_elements);
-    
-    for (int i = 0; i < n_elements; ++i)
+    if (n_peaks == 0)
+    {
+        return;
+    }
+    for (uint16_t i = 0; i < n_peaks; ++i)
     {
-        indexed[i].el = (void *)(in + i);
-        indexed[i].idx = i;
+        idx[i] = i;
     }
-    qsort(
-        indexed, n_elements, sizeof(argsort_tuple), compare_argsort_tuples_ifx_f32_t
-    );
-    for (int i = 0; i < n_peaks; ++i)
+    for (int16_t pos = n_peaks / 2 - 1; pos >= 0; --pos)
+    {
+        peak_heap_sift_down(in, idx, pos, n_peaks);
+    }
+    for (uint16_t i = n_peaks; i < n_elements; ++i)
+    {
+        if (peak_greater(in, i, idx[0]))
+        {
+            idx[0] = i;
+            peak_heap_sift_down(in, idx, 0, n_peaks);
+        }
+    }
+    /* Heap sort: move the smallest remaining peak to the back */
+    for (uint16_t size = n_peaks - 1; size > 0; --size)
     {
-        idx[i] = indexed[n_elements - i - 1].idx;
+        uint16_t tmp = idx[0];
+        idx[0] = idx[size];
+        idx[size] = tmp;
+        peak_heap_sift_down(in, idx, 0, size);
     }
-
-    free(indexed);
 }
 
+/*******************************************************************************
+* Function Name: cluster_peaks
+********************************************************************************
+* Summary:
+* Groups the peaks into clusters of adjacent bins. Peaks are visited in order;
+* a peak adjacent to an already clustered peak joins the cluster of the lowest
+* index, otherwise it starts a new cluster at its own index. The cluster owning
+* each bin is tracked in a table, so every peak is placed in constant time.
+*
+* Parameters:
+*  peaks    : Peak indices as returned by `find_peaks()`, all below
+*  `PEAK_ENGINE_MAX_BINS`.
+*  clusters : out `n_peaks` clusters, each with room for `n_peaks` elements.
+*  Unused clusters have zero elements.
+*  n_peaks  : Number of peaks.
+*
+*******************************************************************************/
 void cluster_peaks(
     const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks
 )
 {
+    uint8_t owner[PEAK_ENGINE_MAX_BINS + 1];
+    memset(owner, PEAK_NO_CLUSTER, sizeof(owner));
+
     for (int i = 0; i < n_peaks; ++i)
     {
         clusters[i].n_elements = 0;
     }
 
-    bool peak_assigned;
-    uint16_t el;
-    uint16_t n_el;
-
     for (int peak_idx = 0; peak_idx < n_peaks; ++peak_idx)
     {
-        peak_assigned = false;
-        for (int cluster_idx = 0; cluster_idx < n_peaks; ++cluster_idx)
+        uint16_t bin = peaks[peak_idx];
+        assert(bin < PEAK_ENGINE_MAX_BINS);
+        uint8_t cluster_idx = owner[bin + 1];
+        if ((bin > 0) && (owner[bin - 1] < cluster_idx))
         {
-            for (int el_idx = 0; el_idx < clusters[cluster_idx].n_elements;
-                    ++el_idx)
-                {
-                el = clusters[cluster_idx].elements[el_idx];
-                if (peaks[peak_idx] - el != 1 && peaks[peak_idx] - el != -1)
-                {
-                    continue; /* check the next element in the cluster */
-                }
-                n_el = clusters[cluster_idx].n_elements;
-                clusters[cluster_idx].elements[n_el] = peaks[peak_idx];
-                clusters[cluster_idx].n_elements += 1;
-                peak_assigned = true;
-                break; /* stop checking elements of the cluster */
-            }
-            if (peak_assigned)
-            {
-                break; /* stop checking other clusters */
-            }
+            cluster_idx = owner[bin - 1];
         }
-        if (!peak_assigned)
+        if (cluster_idx == PEAK_NO_CLUSTER)
         {
-            /* Peak was not assigned to any cluster => initialize a new cluster. */
-            clusters[peak_idx].elements[0] = peaks[peak_idx];
-            clusters[peak_idx].n_elements = 1;
+            /* Peak is not adjacent to any cluster => initialize a new cluster. */
+            cluster_idx = peak_idx;
         }
+        clusters[cluster_idx].elements[clusters[cluster_idx].n_elements] = bin;
+        clusters[cluster_idx].n_elements += 1;
+        owner[bin] = cluster_idx;
+    }
+}
+
+/* Marks the peaks that start a cluster in `cluster_peaks()`. Only the first
+*  element of each cluster is filled in, pointing into `peaks`, which is all
+*  `suggest_hand_detections()` uses. */
+static void cluster_peak_heads(
+    uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks
+)
+{
+    uint32_t seen[(PEAK_ENGINE_MAX_BINS + 32) / 32] = {0};
+
+    for (int peak_idx = 0; peak_idx < n_peaks; ++peak_idx)
+    {
+        uint16_t bin = peaks[peak_idx];
+        uint16_t next = bin + 1;
+        bool adjacent = (seen[next / 32] >> (next % 32)) & 1u;
+        if (bin > 0)
+        {
+            uint16_t prev = bin - 1;
+            adjacent = adjacent || ((seen[prev / 32] >> (prev % 32)) & 1u);
+        }
+        seen[bin / 32] |= 1u << (bin % 32);
+
+        clusters[peak_idx].n_elements = adjacent ? 0 : 1;
+        clusters[peak_idx].elements = peaks + peak_idx;
     }
 }
 
 uint16_t suggest_hand_detections(
     const ifx_f32_t *masked_mean_abs_rdi, uint16_t n_peaks, detection *detections,
     const frame_cfg *f_cfg, const region *search_region,
-    const peak_cluster *clusters, float threshold, float bg_level
+    const peak_cluster *clusters, float threshold, float bg_level,
+    const cfar_map *cfar
 )
 {
     uint16_t n_detections = 0;
@@ -626,7 +1308,7 @@ uint16_t suggest_hand_detections(
         /* Transform doppler_bin from local (ROI) to global (frame) */
         doppler_bin = clusters[i].elements[0] + search_region->row_start;
         search_start = (search_region->row_start + clusters[i].elements[0]) *
-                       f_cfg->n_range_bins +
+                       FRAME_N_RANGE_BINS(f_cfg) +
                        search_region->col_start;
 
         arm_max_f32(
@@ -634,12 +1316,13 @@ uint16_t suggest_hand_detections(
             &search_res_idx
         );
         range_bin = (uint16_t)search_res_idx + search_region->col_start;
-        if (search_res_val > threshold * bg_level)
+        float level = (cfar != NULL) ? cfar_noise_level(cfar, doppler_bin, range_bin) : bg_level;
+        if (search_res_val > threshold * level)
         {
             detections[n_detections].range_bin = range_bin;
             detections[n_detections].doppler_bin = doppler_bin;
             detections[n_detections].value =
-                masked_mean_abs_rdi[doppler_bin * f_cfg->n_range_bins + range_bin];
+                masked_mean_abs_rdi[doppler_bin * FRAME_N_RANGE_BINS(f_cfg) + range_bin];
             n_detections += 1;
         }
     }
@@ -664,7 +1347,7 @@ const detection *pick_fastest_detection(
     const detection *detections, uint16_t n_detections, const frame_cfg *f_cfg
 ) {
     const detection *res = detections;
-    uint16_t mid = f_cfg->n_chirps / 2;
+    uint16_t mid = FRAME_N_CHIRPS(f_cfg) / 2;
     for (int i = 1; i < n_detections; ++i)
     {
         if (abs(detections[i].doppler_bin - mid) > abs(res->doppler_bin - mid))
@@ -698,25 +1381,23 @@ const detection *pick_best_hand_detection(
 detection detect_hand(
     const ifx_f32_t *masked_mean_abs_rdi, const region *search_region,
     const frame_cfg *f_cfg, float bg_level, detection_mode det_mode,
-    float threshold
+    float threshold, const cfar_map *cfar
 )
 {
     uint16_t n_elements = search_region->row_end - search_region->row_start;
-    ifx_f32_t* profile = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * n_elements);
     uint16_t n_peaks = (uint16_t)(0.2 * n_elements);
-    uint16_t* peaks = (uint16_t*)malloc(sizeof(uint16_t) * n_peaks);
-    uint16_t* cluster_elements = (uint16_t*)malloc(sizeof(uint16_t) * (n_peaks* n_peaks));
-    peak_cluster *clusters = (peak_cluster*)malloc(sizeof(peak_cluster) * n_peaks);
-    for (int i = 0; i < n_peaks; ++i) {
-        clusters[i].elements = cluster_elements + i * n_peaks;
-    }
-    detection* detections = (detection*)malloc(sizeof(detection) * n_peaks);
+    assert(n_elements <= PEAK_ENGINE_MAX_BINS);
+    ifx_f32_t profile[PEAK_ENGINE_MAX_BINS];
+    uint16_t peaks[PEAK_ENGINE_MAX_PEAKS];
+    peak_cluster clusters[PEAK_ENGINE_MAX_PEAKS];
+    detection detections[PEAK_ENGINE_MAX_PEAKS];
+
     make_doppler_profile(masked_mean_abs_rdi, profile, search_region, f_cfg);
     find_peaks(profile, peaks, n_elements, n_peaks);
-    cluster_peaks(peaks, clusters, n_peaks);
+    cluster_peak_heads(peaks, clusters, n_peaks);
     uint16_t n_detections = suggest_hand_detections(
                                 masked_mean_abs_rdi, n_peaks, detections, f_cfg, search_region, clusters,
-                                threshold, bg_level
+                                threshold, bg_level, cfar
                             );
     detection ret_d;
     if (n_detections == 0)
@@ -731,12 +1412,6 @@ detection detect_hand(
         ret_d = *pick_best_hand_detection(detections, n_detections, f_cfg, det_mode);
     }
 
-    free(profile);
-    free(peaks);
-    free(cluster_elements);
-    free(clusters);
-    free(detections);
-
     return ret_d;
  
 }
@@ -777,6 +1452,139 @@ float phase_monopulse(float phase0, float phase1)
     return asinf(C0 * d_phase / (2 * PI * FREQ_CENTER * ANTENNA_DISTANCE));
 }
 
+/* atan(t) for 0 <= t <= 1, Abramowitz & Stegun 4.4.49, |error| <= 1e-5 rad */
+static inline float atan_unit_f32(float t)
+{
+    float t2 = t * t;
+    return t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f +
+                t2 * (-0.0851330f + t2 * 0.0208351f))));
+}
+
+/* asin(x) for -1 <= x <= 1, Abramowitz & Stegun 4.4.46, |error| <= 2e-8 rad
+*  (limited by float32 rounding in practice) */
+static inline float asin_f32(float x)
+{
+    float ax = fminf(fabsf(x), 1.0f);
+    float r = (PI / 2) - sqrtf(1.0f - ax) *
+              (1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f +
+               ax * (-0.0501743046f + ax * (0.0308918810f + ax * (-0.0170881256f +
+               ax * (0.0066700901f + ax * -0.0012624911f)))))));
+    return copysignf(r, x);
+}
+
+/*******************************************************************************
+* Function Name: angle_batch_cf64
+********************************************************************************
+* Summary:
+* Phase of a block of complex samples, laid out as
+* `x[ch * channel_stride + chirp * chirp_stride]`. Same as calling `angle()`
+* on every sample, using a polynomial atan2 with a maximum error of 1e-5 rad.
+*
+* Parameters:
+*  x              : Complex input samples.
+*  channel_stride : Distance between channels in `x` (in elements).
+*  chirp_stride   : Distance between chirps in `x` (in elements).
+*  n_channels     : Number of channels.
+*  n_chirps       : Number of chirps.
+*  phases         : out Phases [n_channels][n_chirps] in (-pi, pi].
+*
+* Return:
+*  ARM_MATH_SUCCESS, or ARM_MATH_NANINF if a sample is 0 or not a number.
+*
+*******************************************************************************/
+ifx_status angle_batch_cf64(
+    const ifx_cf64_t *x, uint32_t channel_stride, uint32_t chirp_stride,
+    uint16_t n_channels, uint16_t n_chirps, float *phases
+)
+{
+    for (int ch = 0; ch < n_channels; ++ch)
+    {
+        const ifx_cf64_t *src = x + ch * channel_stride;
+        float *dst = phases + ch * n_chirps;
+        for (int c = 0; c < n_chirps; ++c)
+        {
+            float re = src[c * chirp_stride].data[0];
+            float im = src[c * chirp_stride].data[1];
+            float a_re = fabsf(re);
+            float a_im = fabsf(im);
+            /* Same domain as arm_atan2_f32(): fails on 0 and NaN */
+            if (!((a_re > 0.0f) || ((re == 0.0f) && (a_im > 0.0f))))
+            {
+                return ARM_MATH_NANINF;
+            }
+            float r = (a_im > a_re) ? (PI / 2) - atan_unit_f32(a_re / a_im)
+                                    : atan_unit_f32(a_im / a_re);
+            if (re < 0.0f)
+            {
+                r = PI - r;
+            }
+            dst[c] = signbit(im) ? -r : r;
+        }
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: monopulse_batch_cf64
+********************************************************************************
+* Summary:
+* Batched phase extraction and phase monopulse over a block of chirps of
+* three channels (channel 2 is the reference, channel 0 gives the azimuth and
+* channel 1 the elevation). Matches averaging `get_phase_difference()` over
+* the channels and `phase_monopulse()` over the chirps, with the atan2 error of
+* `angle_batch_cf64()` and a polynomial asin (max. error 2e-8 rad before
+* float32 rounding). No heap is used.
+*
+* Parameters:
+*  x              : Complex input samples, see `angle_batch_cf64()`.
+*  channel_stride : Distance between channels in `x` (in elements).
+*  chirp_stride   : Distance between chirps in `x` (in elements).
+*  n_channels     : Number of channels, at least 3.
+*  n_chirps       : Number of chirps, at least 2.
+*  phases         : Scratch/out phases [n_channels][n_chirps].
+*  out            : out Mean chirp to chirp phase difference (Doppler) and mean
+*  azimuth/elevation.
+*
+* Return:
+*  ARM_MATH_SUCCESS, or ARM_MATH_NANINF if a phase could not be computed.
+*
+*******************************************************************************/
+ifx_status monopulse_batch_cf64(
+    const ifx_cf64_t *x, uint32_t channel_stride, uint32_t chirp_stride,
+    uint16_t n_channels, uint16_t n_chirps, float *phases,
+    monopulse_features *out
+)
+{
+    const float scale = C0 / (2 * PI * FREQ_CENTER * ANTENNA_DISTANCE);
+    ifx_status status = angle_batch_cf64(
+        x, channel_stride, chirp_stride, n_channels, n_chirps, phases
+    );
+    if (status != ARM_MATH_SUCCESS)
+    {
+        return status;
+    }
+
+    float doppler = 0;
+    for (int ch = 0; ch < n_channels; ++ch)
+    {
+        doppler += get_phase_difference(phases[ch * n_chirps + 1], phases[ch * n_chirps]);
+    }
+
+    const float *ref = phases + 2 * n_chirps;
+    float azimuth = 0;
+    float elevation = 0;
+    for (int c = 0; c < n_chirps; ++c)
+    {
+        azimuth += asin_f32(scale * get_phase_difference(ref[c], phases[c]));
+        elevation += asin_f32(scale * get_phase_difference(ref[c], phases[n_chirps + c]));
+    }
+
+    out->doppler = doppler / n_channels;
+    out->azimuth = azimuth / n_chirps;
+    out->elevation = elevation / n_chirps;
+    return ARM_MATH_SUCCESS;
+}
+
 void remove_mean_cf64(cfloat32_t *src, uint16_t n_el, uint16_t step_size)
 {
     cfloat32_t sum = 0.0f;
@@ -784,9 +1592,10 @@ void remove_mean_cf64(cfloat32_t *src, uint16_t n_el, uint16_t step_size)
     {
         sum += src[i * step_size];
     }
+    cfloat32_t mean = sum / n_el;
     for (int i = 0; i < n_el; ++i)
     {
-        src[i * step_size] -= sum / n_el;
+        src[i * step_size] -= mean;
     }
 }
 
@@ -826,75 +1635,136 @@ void remove_mean_3d_cf64(
     }
 }
 
-void algo(
-    algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
-    estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
-    uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
-    uint16_t guard_doppler, detection_mode det_mode, float threshold
+/*******************************************************************************
+* Function Name: algo_scratch_size
+********************************************************************************
+* Summary:
+* Scratch arena bytes needed by `algo()`, which also covers `algo_roi()`:
+* complex and magnitude RDI, mean and masked images and the background sort
+* buffer or the CFAR integral images.
+*
+* Parameters:
+*  f_cfg : Frame configuration.
+*
+* Return:
+*  Size in bytes.
+*
+*******************************************************************************/
+uint32_t algo_scratch_size(const frame_cfg *f_cfg)
+{
+    uint32_t len_img = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    uint32_t len_rdi = FRAME_N_CHANNELS(f_cfg) * len_img;
+    uint32_t background = SCRATCH_ALIGN_SIZE(sizeof(ifx_f32_t) * len_img);
+    if (cfar_scratch_size(f_cfg) > background)
+    {
+        background = cfar_scratch_size(f_cfg);
+    }
+    return SCRATCH_ALIGN_SIZE(sizeof(ifx_cf64_t) * len_rdi) +
+           SCRATCH_ALIGN_SIZE(sizeof(ifx_f32_t) * len_rdi) +
+           2 * SCRATCH_ALIGN_SIZE(sizeof(ifx_f32_t) * len_img) + background;
+}
+
+/*******************************************************************************
+* Function Name: _detect_hand_with_background
+********************************************************************************
+* Summary:
+* Hand detection of `algo()` and `algo_roi()` against the background selected
+* by `cfar`: the median of the positive cells of the search region, or a CFAR
+* noise level per candidate cell.
+*
+* Parameters:
+*  masked_mean_abs_rdi : Channel-combined magnitude image, human masked out,
+*  valid inside `search_region`.
+*  search_region       : Hand search region.
+*  f_cfg               : Frame configuration.
+*  det_mode            : Detection mode.
+*  threshold           : Detection threshold relative to the background.
+*  cfar                : CFAR configuration, NULL for the median background.
+*  bg_level            : out Median background, or with CFAR the noise level
+*  at the detection (0 without detection).
+*
+* Return:
+*  Hand detection, bins set to -1 if there is none.
+*
+*******************************************************************************/
+static detection _detect_hand_with_background(
+    const ifx_f32_t *masked_mean_abs_rdi, const region *search_region,
+    const frame_cfg *f_cfg, detection_mode det_mode, float threshold,
+    const cfar_cfg *cfar, float *bg_level
 )
 {
-    uint16_t rdi_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
-    uint16_t mean_rdi_size = f_cfg->n_chirps * f_cfg->n_range_bins;
-    ifx_cf64_t *rdi = (ifx_cf64_t*)calloc(rdi_size, sizeof(ifx_cf64_t));
-    ifx_f32_t *abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * rdi_size);
-    ifx_f32_t *mean_abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * mean_rdi_size);
-    ifx_f32_t *masked_mean_abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * mean_rdi_size);
+    if ((cfar == NULL) || (cfar->mode == CFAR_MODE_MEDIAN))
+    {
+        *bg_level = get_background_level_roi(masked_mean_abs_rdi, f_cfg, search_region);
+        return detect_hand(
+                   masked_mean_abs_rdi, search_region, f_cfg, *bg_level, det_mode,
+                   threshold, NULL
+               );
+    }
 
-    build_complex_rdi(frame, rdi, f_cfg);
-    arm_cmplx_mag_f32((float32_t *)rdi, (float32_t *)abs_rdi, rdi_size);
-    mean_rdi_channel_f32(abs_rdi, mean_abs_rdi, f_cfg);
-    estimate_human(mean_abs_rdi, f_cfg, h_cfg);
-    uint16_t upper_limit = calculate_upper_range_limit(
-                               h_cfg->position_current, band_min, band_offset, range_min
-                           );
-    uint16_t lower_limit =
-        calculate_lower_range_limit(upper_limit, band_max, range_min);
-    region hand_search;
-    region human_mask;
-    get_hand_roi(
-        &hand_search, &human_mask, f_cfg, lower_limit, upper_limit, guard_range,
-        guard_doppler
-    );
-    mask_hand_roi(
-        mean_abs_rdi, masked_mean_abs_rdi, f_cfg, &hand_search, &human_mask
-    );
-    float bg_level = get_background_level(masked_mean_abs_rdi, f_cfg);
+    scratch_mark mark = scratch_get_mark();
+    cfar_map map;
+    cfar_prepare(&map, masked_mean_abs_rdi, f_cfg, search_region, cfar);
     detection hand = detect_hand(
-                         masked_mean_abs_rdi, &hand_search, f_cfg, bg_level, det_mode, threshold
+                         masked_mean_abs_rdi, search_region, f_cfg, 0.0f, det_mode,
+                         threshold, &map
                      );
-    if (hand.range_bin >= f_cfg->n_range_bins)
+    *bg_level = (hand.range_bin < FRAME_N_RANGE_BINS(f_cfg)) ?
+                cfar_noise_level(&map, hand.doppler_bin, hand.range_bin) : 0.0f;
+    scratch_release(mark);
+    return hand;
+}
+
+/*******************************************************************************
+* Function Name: _algo_hand_features
+********************************************************************************
+* Summary:
+* Common tail of `algo()` and `algo_roi()`: monopulse angles of the detected
+* hand and the output structure.
+*
+* Parameters:
+*  out         : Algorithm output.
+*  rdi         : Complex range-Doppler images [n_channels][n_chirps][n_range_bins],
+*  valid at least at the detection.
+*  f_cfg       : Frame configuration.
+*  h_cfg       : Human position estimator state.
+*  hand        : Hand detection.
+*  bg_level    : Background level.
+*  lower_limit : Lower range limit of the hand search.
+*  upper_limit : Upper range limit of the hand search.
+*
+*******************************************************************************/
+static void _algo_hand_features(
+    algo_output *out, const ifx_cf64_t *rdi, frame_cfg *f_cfg,
+    const estimate_human_cfg *h_cfg, detection hand, float bg_level,
+    uint16_t lower_limit, uint16_t upper_limit
+)
+{
+    if (hand.range_bin >= FRAME_N_RANGE_BINS(f_cfg))
     {
         out->success = false;
-        free(rdi);
-        free(abs_rdi);
-        free(mean_abs_rdi);
-        free(masked_mean_abs_rdi);
         return;
     }
 
+    uint16_t mean_rdi_size = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
     uint16_t bin_idx[3];
     float phases[3];
     for (int i = 0; i < 3; ++i)
     {
-        bin_idx[i] = i * mean_rdi_size + hand.doppler_bin * f_cfg->n_range_bins +
+        bin_idx[i] = i * mean_rdi_size + hand.doppler_bin * FRAME_N_RANGE_BINS(f_cfg) +
                      hand.range_bin;
 
         if (angle(rdi[bin_idx[i]].data[0], rdi[bin_idx[i]].data[1], phases + i) != ARM_MATH_SUCCESS)
         {
             out->success = false;
-            free(rdi);
-            free(abs_rdi);
-            free(mean_abs_rdi);
-            free(masked_mean_abs_rdi);
             return;
         }
     }
 
     float azimuth = phase_monopulse(phases[2], phases[0]);
     float elevation = phase_monopulse(phases[2], phases[1]);
-    /* Phase correction based on Signify measurements */
-    azimuth = azimuth + deg2rad(8.0);
-    elevation = elevation + deg2rad(24.0);
+    azimuth = azimuth + MONOPULSE_AZIMUTH_CORRECTION;
+    elevation = elevation + MONOPULSE_ELEVATION_CORRECTION;
 
     out->success = true;
     out->human_position = h_cfg->position_current;
@@ -907,10 +1777,296 @@ void algo(
     };
     out->lower_limit = lower_limit;
     out->upper_limit = upper_limit;
+}
+
+void algo(
+    algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
+    estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
+    uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    const cfar_cfg *cfar
+)
+{
+    uint16_t rdi_size = FRAME_N_CHANNELS(f_cfg) * FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    uint16_t mean_rdi_size = FRAME_N_CHIRPS(f_cfg) * FRAME_N_RANGE_BINS(f_cfg);
+    scratch_arena_reserve(algo_scratch_size(f_cfg));
+    scratch_mark mark = scratch_get_mark();
+    ifx_cf64_t *rdi = (ifx_cf64_t*)scratch_alloc(sizeof(ifx_cf64_t) * rdi_size);
+    ifx_f32_t *abs_rdi = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * rdi_size);
+    ifx_f32_t *mean_abs_rdi = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * mean_rdi_size);
+    ifx_f32_t *masked_mean_abs_rdi = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * mean_rdi_size);
+
+    build_complex_rdi(frame, rdi, f_cfg);
+    arm_cmplx_mag_f32((float32_t *)rdi, (float32_t *)abs_rdi, rdi_size);
+    mean_rdi_channel_f32(abs_rdi, mean_abs_rdi, f_cfg);
+    estimate_human(mean_abs_rdi, f_cfg, h_cfg);
+    uint16_t upper_limit = calculate_upper_range_limit(
+                               h_cfg->position_current, band_min, band_offset, range_min
+                           );
+    uint16_t lower_limit =
+        calculate_lower_range_limit(upper_limit, band_max, range_min);
+    region hand_search;
+    region human_mask;
+    get_hand_roi(
+        &hand_search, &human_mask, f_cfg, lower_limit, upper_limit, guard_range,
+        guard_doppler
+    );
+    mask_hand_roi(
+        mean_abs_rdi, masked_mean_abs_rdi, f_cfg, &hand_search, &human_mask
+    );
+    float bg_level;
+    detection hand = _detect_hand_with_background(
+                         masked_mean_abs_rdi, &hand_search, f_cfg, det_mode, threshold,
+                         cfar, &bg_level
+                     );
+    _algo_hand_features(
+        out, rdi, f_cfg, h_cfg, hand, bg_level, lower_limit, upper_limit
+    );
+
+    scratch_release(mark);
+}
+
+/*******************************************************************************
+* Function Name: _doppler_near_zero_f32
+********************************************************************************
+* Summary:
+* The two Doppler bins next to zero Doppler of one range bin, i.e. bins
+* `n_chirps / 2 - 1` and `n_chirps / 2 + 1` of `doppler_column_f32()` with mean
+* removal, computed by a direct DFT instead of a full FFT.
+*
+* Parameters:
+*  in       : First chirp of the range bin.
+*  stride   : Distance between chirps in `in` (in elements).
+*  window   : Doppler window of `n_chirps` elements.
+*  twiddle  : exp(-2j * pi * m / n_chirps) for m in [0, n_chirps).
+*  n_chirps : Number of chirps, even.
+*  out      : out Bins `n_chirps / 2 - 1` and `n_chirps / 2 + 1`.
+*
+*******************************************************************************/
+static void _doppler_near_zero_f32(
+    const ifx_cf64_t *in, uint32_t stride, const window_view *window,
+    const ifx_cf64_t *twiddle, uint16_t n_chirps, ifx_cf64_t *out
+)
+{
+    float32_t mean_re = 0.0f;
+    float32_t mean_im = 0.0f;
+    for (int m = 0; m < n_chirps; ++m)
+    {
+        mean_re += in[m * stride].data[0];
+        mean_im += in[m * stride].data[1];
+    }
+    mean_re /= n_chirps;
+    mean_im /= n_chirps;
+
+    /* With the centring modulation, bin n/2 + 1 is frequency +1 and bin
+    *  n/2 - 1 frequency -1, whose twiddle is the conjugate */
+    float32_t below_re = 0.0f, below_im = 0.0f;
+    float32_t above_re = 0.0f, above_im = 0.0f;
+    for (int m = 0; m < n_chirps; ++m)
+    {
+        float32_t w = window->half[(m < n_chirps / 2) ? m : n_chirps - 1 - m];
+        float32_t v_re = (in[m * stride].data[0] - mean_re) * w;
+        float32_t v_im = (in[m * stride].data[1] - mean_im) * w;
+        float32_t t_re = twiddle[m].data[0];
+        float32_t t_im = twiddle[m].data[1];
+        above_re += v_re * t_re - v_im * t_im;
+        above_im += v_re * t_im + v_im * t_re;
+        below_re += v_re * t_re + v_im * t_im;
+        below_im += v_im * t_re - v_re * t_im;
+    }
+    out[0].data[0] = below_re;
+    out[0].data[1] = below_im;
+    out[1].data[0] = above_re;
+    out[1].data[1] = above_im;
+}
+
+/*******************************************************************************
+* Function Name: get_background_level_roi
+********************************************************************************
+* Summary:
+* Same as `get_background_level()` for an image that is only valid inside
+* `search_region`: the median of the positive elements of the region.
+*
+* Parameters:
+*  masked_mean_abs_rdi : Channel-combined magnitude image, human masked out.
+*  f_cfg               : Frame configuration.
+*  search_region       : Valid region of the image.
+*
+* Return:
+*  Background level, 0 if the region has no positive element.
+*
+*******************************************************************************/
+float get_background_level_roi(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    const region *search_region
+)
+{
+    int n_rows = search_region->row_end - search_region->row_start;
+    int n_cols = search_region->col_end - search_region->col_start;
+    if ((n_rows <= 0) || (n_cols <= 0))
+    {
+        return 0.0;
+    }
+    scratch_mark mark = scratch_get_mark();
+    ifx_f32_t* tmp = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * n_rows * n_cols);
+    int n_positive = 0;
+    for (int row = search_region->row_start; row < search_region->row_end; ++row)
+    {
+        const ifx_f32_t *src = masked_mean_abs_rdi + row * FRAME_N_RANGE_BINS(f_cfg);
+        for (int col = search_region->col_start; col < search_region->col_end; ++col)
+        {
+            if (src[col] > 0.0)
+            {
+                tmp[n_positive++] = src[col];
+            }
+        }
+    }
+
+    float ret = 0.0;
+    if (n_positive > 0)
+    {
+        qsort((void *)tmp, n_positive, sizeof(ifx_f32_t), compare_ifx_f32);
+        if (n_positive % 2 == 0)
+        {
+            ret = (tmp[n_positive / 2 - 1] + tmp[n_positive / 2]) / 2;
+        }
+        else
+        {
+            ret = tmp[n_positive / 2];
+        }
+    }
+    scratch_release(mark);
+    return ret;
+}
+
+/*******************************************************************************
+* Function Name: algo_roi
+********************************************************************************
+* Summary:
+* Region of interest variant of `algo()` with the same parameters and results.
+* The range transform still covers the whole frame, but the Doppler
+* transform, magnitudes and the background statistics are only computed
+* where they are used:
+*  - the human position estimate needs the two rows next to zero Doppler from
+*    `h_cfg->position_min` on, computed by direct DFT,
+*  - the hand search needs the columns of the search region only, computed
+*    with full Doppler FFTs.
+* The cost of everything after the range transform scales with the width of
+* the hand search region instead of the number of range bins.
+*
+* Parameters: see `algo()`.
+*
+*******************************************************************************/
+void algo_roi(
+    algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
+    estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
+    uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    const cfar_cfg *cfar
+)
+{
+    uint16_t n_channels = FRAME_N_CHANNELS(f_cfg);
+    uint16_t n_chirps = FRAME_N_CHIRPS(f_cfg);
+    uint16_t n_range_bins = FRAME_N_RANGE_BINS(f_cfg);
+    uint16_t mean_rdi_size = n_chirps * n_range_bins;
+    uint16_t rdi_size = n_channels * mean_rdi_size;
+    float32_t channel_scale = 1.0 / n_channels;
+    assert(n_chirps <= RDI_MAX_CHIRPS);
+
+    scratch_arena_reserve(algo_scratch_size(f_cfg));
+    scratch_mark mark = scratch_get_mark();
+    ifx_cf64_t *rdi = (ifx_cf64_t*)scratch_alloc(sizeof(ifx_cf64_t) * rdi_size);
+    ifx_f32_t *mean_abs_rdi = (ifx_f32_t*)scratch_alloc(sizeof(ifx_f32_t) * mean_rdi_size);
+
+    /* Range images of all channels, the Doppler transform is done in place
+    *  on the columns that are needed */
+    window_view range_window =
+        get_window_view(&WINDOWS.hann_adc, FRAME_N_SAMPLES(f_cfg));
+    window_view doppler_window = get_window_view(&WINDOWS.kaiser_b25, n_chirps);
+    build_complex_range_image(frame, rdi, f_cfg, &range_window);
+
+    /* Human position: rows n_chirps/2 -+ 1 from `position_min` on */
+    ifx_cf64_t twiddle[RDI_MAX_CHIRPS];
+    for (int m = 0; m < n_chirps; ++m)
+    {
+        float32_t phi = 2.0f * PI * m / n_chirps;
+        twiddle[m].data[0] = arm_cos_f32(phi);
+        twiddle[m].data[1] = -arm_sin_f32(phi);
+    }
+    ifx_f32_t *row_below = mean_abs_rdi + (n_chirps / 2 - 1) * n_range_bins;
+    ifx_f32_t *row_above = mean_abs_rdi + (n_chirps / 2 + 1) * n_range_bins;
+    for (int col = h_cfg->position_min; col < n_range_bins; ++col)
+    {
+        ifx_f32_t sum_below = 0.0;
+        ifx_f32_t sum_above = 0.0;
+        for (int ch = 0; ch < n_channels; ++ch)
+        {
+            ifx_cf64_t bins[2];
+            ifx_f32_t mag[2];
+            _doppler_near_zero_f32(
+                rdi + ch * mean_rdi_size + col, n_range_bins, &doppler_window,
+                twiddle, n_chirps, bins
+            );
+            arm_cmplx_mag_f32((float32_t *)bins, mag, 2);
+            sum_below += mag[0];
+            sum_above += mag[1];
+        }
+        row_below[col] = sum_below * channel_scale;
+        row_above[col] = sum_above * channel_scale;
+    }
+    estimate_human(mean_abs_rdi, f_cfg, h_cfg);
+
+    uint16_t upper_limit = calculate_upper_range_limit(
+                               h_cfg->position_current, band_min, band_offset, range_min
+                           );
+    uint16_t lower_limit =
+        calculate_lower_range_limit(upper_limit, band_max, range_min);
+    region hand_search;
+    region human_mask;
+    get_hand_roi(
+        &hand_search, &human_mask, f_cfg, lower_limit, upper_limit, guard_range,
+        guard_doppler
+    );
 
-    free(rdi);
-    free(abs_rdi);
-    free(mean_abs_rdi);
-    free(masked_mean_abs_rdi);
+    /* Hand search: Doppler FFT and channel-combined magnitude of the search
+    *  columns only, the human is masked out in place */
+    ifx_cf64_t column[RDI_MAX_CHIRPS];
+    ifx_f32_t mag[RDI_MAX_CHIRPS];
+    for (int col = hand_search.col_start; col < hand_search.col_end; ++col)
+    {
+        for (int ch = 0; ch < n_channels; ++ch)
+        {
+            ifx_cf64_t *x = rdi + ch * mean_rdi_size + col;
+            doppler_column_f32(x, n_range_bins, column, true, &doppler_window, n_chirps);
+            arm_cmplx_mag_f32((float32_t *)column, mag, n_chirps);
+            for (int chirp = 0; chirp < n_chirps; ++chirp)
+            {
+                x[chirp * n_range_bins] = column[chirp];
+                mean_abs_rdi[chirp * n_range_bins + col] =
+                    (ch == 0) ? mag[chirp] : mean_abs_rdi[chirp * n_range_bins + col] + mag[chirp];
+            }
+        }
+        for (int chirp = 0; chirp < n_chirps; ++chirp)
+        {
+            mean_abs_rdi[chirp * n_range_bins + col] *= channel_scale;
+        }
+    }
+    for (int row = human_mask.row_start; row < human_mask.row_end; ++row)
+    {
+        for (int col = human_mask.col_start; col < human_mask.col_end; ++col)
+        {
+            mean_abs_rdi[row * n_range_bins + col] = 0.0;
+        }
+    }
 
-}
\ No newline at end of file
+    float bg_level;
+    detection hand = _detect_hand_with_background(
+                         mean_abs_rdi, &hand_search, f_cfg, det_mode, threshold, cfar,
+                         &bg_level
+                     );
+    _algo_hand_features(
+        out, rdi, f_cfg, h_cfg, hand, bg_level, lower_limit, upper_limit
+    );
+
+    scratch_release(mark);
+}
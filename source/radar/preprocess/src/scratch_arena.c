@@ -0,0 +1,152 @@
+/******************************************************************************
+* File Name:   scratch_arena.c
+*
+* Description: This file implements the frame scratch arena of the preprocessing
+*   library.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#include "scratch_arena.h"
+#include <stdlib.h>
+
+static scratch_arena arena;
+
+#if defined(PREPROC_HEAP_DEBUG)
+volatile uint32_t preproc_heap_calls = 0;
+#endif
+
+/*******************************************************************************
+* Function Name: scratch_arena_reserve
+********************************************************************************
+* Summary:
+* Makes sure the arena holds at least `capacity` bytes. Only allocates when
+* the arena grows, i.e. at initialization or on the first frame of a larger
+* consumer, never in steady state. Must not be called while scratch memory
+* is in use.
+*
+* Parameters:
+*  capacity : Required size in bytes.
+*
+*******************************************************************************/
+void scratch_arena_reserve(uint32_t capacity)
+{
+    capacity = SCRATCH_ALIGN_SIZE(capacity);
+    if (capacity <= arena.capacity)
+    {
+        return;
+    }
+    if (arena.used != 0)
+    {
+        abort();
+    }
+    PREPROC_FREE(arena.base);
+    /* malloc() alignment is at least SCRATCH_ALIGN on the supported targets */
+    arena.base = (uint8_t *)PREPROC_MALLOC(capacity);
+    if (arena.base == NULL)
+    {
+        abort();
+    }
+    arena.capacity = capacity;
+}
+
+/* Gives the arena memory back to the heap. */
+void scratch_arena_free(void)
+{
+    PREPROC_FREE(arena.base);
+    arena = (scratch_arena){0};
+}
+
+/*******************************************************************************
+* Function Name: scratch_alloc
+********************************************************************************
+* Summary:
+* Takes `size` bytes from the arena. Running out of scratch memory means the
+* arena was reserved for a smaller consumer, which is a fatal error.
+*
+* Parameters:
+*  size : Size in bytes.
+*
+* Return:
+*  Pointer aligned to SCRATCH_ALIGN.
+*
+*******************************************************************************/
+void *scratch_alloc(uint32_t size)
+{
+    size = SCRATCH_ALIGN_SIZE(size);
+    if (size > arena.capacity - arena.used)
+    {
+        abort();
+    }
+    void *ptr = arena.base + arena.used;
+    arena.used += size;
+    if (arena.used > arena.high_water)
+    {
+        arena.high_water = arena.used;
+    }
+    return ptr;
+}
+
+scratch_mark scratch_get_mark(void)
+{
+    return arena.used;
+}
+
+void scratch_release(scratch_mark mark)
+{
+    /* Everything allocated after `mark` is released */
+    arena.used = mark;
+}
+
+void scratch_reset(void)
+{
+    arena.used = 0;
+}
+
+const scratch_arena *scratch_get_arena(void)
+{
+    return &arena;
+}
+
+uint32_t preproc_get_heap_calls(void)
+{
+#if defined(PREPROC_HEAP_DEBUG)
+    return preproc_heap_calls;
+#else
+    return 0;
+#endif
+}
@@ -39,12 +39,14 @@
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
 #include "preprocess.h"
+#include <string.h>
 
 void slice_2d_row_cf64(
     ifx_cf64_t *src, ifx_cf64_t *dst, uint16_t row, uint16_t n_rows,
     uint16_t n_cols
 ) 
 {
+    (void)n_rows;
     memcpy(dst, src + row * n_cols, sizeof(ifx_cf64_t) * n_cols);
 }
 
@@ -45,313 +45,289 @@
 
 const namespace_windows WINDOWS =
 {
-    .hann =
-    {   .s16 =
-        {   0., 0.04322727, 0.1654347, 0.3454915, 0.5522642, 0.75, 0.9045085,
-            0.9890738, 0.9890738, 0.9045085, 0.75, 0.5522642, 0.3454915, 0.1654347,
-            0.04322727, 0. },
-        .s32 = 
+    .hann_adc =
+    {
+        .s16 =
+        {
+            0.00000000e+00, 1.40748136e-06, 5.38655922e-06, 1.12492144e-05,
+            1.79817416e-05, 2.44200237e-05, 2.94508263e-05, 3.22042761e-05
+        },
+        .s32 =
         {
-            0.,          0.010235029, 0.040521093, 0.08961828, 0.15551654,
-            0.235518,    0.32634738,  0.4242861,   0.5253246,  0.6253263,
-            0.7201971,   0.806053,    0.87937903,  0.9371733,  0.9770696,
-            0.9974347,   0.9974347,   0.9770696,   0.9371733,  0.87937903,
-            0.806053,    0.7201971,   0.6253263,   0.5253246,  0.4242861,
-            0.32634738,  0.235518,    0.15551654,  0.08961828, 0.040521093,
-            0.010235029, 0.
+            0.00000000e+00, 1.61251393e-07, 6.38403947e-07, 1.41192299e-06,
+            2.45014053e-06, 3.71055171e-06, 5.14155545e-06, 6.68456596e-06,
+            8.27641270e-06, 9.85192401e-06, 1.13466003e-05, 1.26992472e-05,
+            1.38544892e-05, 1.47650289e-05, 1.53935889e-05, 1.57144386e-05
         },
         .s64 =
-        {   0.,          0.0024846124, 0.0099137565, 0.022213597, 0.039261892,
-            0.060889214, 0.08688061,   0.11697778,   0.15088159,  0.1882551,
-            0.22872686,  0.27189466,   0.3173295,    0.36457977,  0.4131759,
-            0.46263495,  0.51246536,   0.5621719,    0.6112605,   0.65924335,
-            0.70564353,  0.75,         0.79187185,   0.8308429,   0.86652595,
-            0.89856625,  0.92664546,   0.95048445,   0.9698463,   0.9845386,
-            0.9944154,   0.99937844,   0.99937844,   0.9944154,   0.9845386,
-            0.9698463,   0.95048445,   0.92664546,   0.89856625,  0.86652595,
-            0.8308429,   0.79187185,   0.75,         0.70564353,  0.65924335,
-            0.6112605,   0.5621719,    0.51246536,   0.46263495,  0.4131759,
-            0.36457977,  0.3173295,    0.27189466,   0.22872686,  0.1882551,
-            0.15088159,  0.11697778,   0.08688061,   0.060889214, 0.039261892,
-            0.022213597, 0.0099137565, 0.0024846124, 0.},
-        .s128 = 
         {
-            0.00000000e+00, 6.11791893e-04, 2.44567041e-03, 5.49714776e-03,
-            9.75875644e-03, 1.52200676e-02, 2.18677165e-02, 2.96854352e-02,
-            3.86540925e-02, 4.87517405e-02, 5.99536686e-02, 7.22324638e-02,
-            8.55580779e-02, 9.98979008e-02, 1.15216841e-01, 1.31477409e-01,
-            1.48639814e-01, 1.66662057e-01, 1.85500033e-01, 2.05107643e-01,
-            2.25436905e-01, 2.46438068e-01, 2.68059740e-01, 2.90249008e-01,
-            3.12951573e-01, 3.36111876e-01, 3.59673241e-01, 3.83578009e-01,
-            4.07767681e-01, 4.32183061e-01, 4.56764400e-01, 4.81451544e-01,
-            5.06184080e-01, 5.30901482e-01, 5.55543263e-01, 5.80049120e-01,
-            6.04359083e-01, 6.28413663e-01, 6.52153992e-01, 6.75521975e-01,
-            6.98460427e-01, 7.20913213e-01, 7.42825387e-01, 7.64143326e-01,
-            7.84814863e-01, 8.04789410e-01, 8.24018086e-01, 8.42453836e-01,
-            8.60051543e-01, 8.76768145e-01, 8.92562731e-01, 9.07396651e-01,
-            9.21233603e-01, 9.34039725e-01, 9.45783680e-01, 9.56436727e-01,
-            9.65972797e-01, 9.74368554e-01, 9.81603451e-01, 9.87659784e-01,
-            9.92522732e-01, 9.96180394e-01, 9.98623819e-01, 9.99847029e-01,
-            9.99847029e-01, 9.98623819e-01, 9.96180394e-01, 9.92522732e-01,
-            9.87659784e-01, 9.81603451e-01, 9.74368554e-01, 9.65972797e-01,
-            9.56436727e-01, 9.45783680e-01, 9.34039725e-01, 9.21233603e-01,
-            9.07396651e-01, 8.92562731e-01, 8.76768145e-01, 8.60051543e-01,
-            8.42453836e-01, 8.24018086e-01, 8.04789410e-01, 7.84814863e-01,
-            7.64143326e-01, 7.42825387e-01, 7.20913213e-01, 6.98460427e-01,
-            6.75521975e-01, 6.52153992e-01, 6.28413663e-01, 6.04359083e-01,
-            5.80049120e-01, 5.55543263e-01, 5.30901482e-01, 5.06184080e-01,
-            4.81451544e-01, 4.56764400e-01, 4.32183061e-01, 4.07767681e-01,
-            3.83578009e-01, 3.59673241e-01, 3.36111876e-01, 3.12951573e-01,
-            2.90249008e-01, 2.68059740e-01, 2.46438068e-01, 2.25436905e-01,
-            2.05107643e-01, 1.85500033e-01, 1.66662057e-01, 1.48639814e-01,
-            1.31477409e-01, 1.15216841e-01, 9.98979008e-02, 8.55580779e-02,
-            7.22324638e-02, 5.99536686e-02, 4.87517405e-02, 3.86540925e-02,
-            2.96854352e-02, 2.18677165e-02, 1.52200676e-02, 9.75875644e-03,
-            5.49714776e-03, 2.44567041e-03, 6.11791893e-04, 0.00000000e+00
+            0.00000000e+00, 1.92616803e-08, 7.68552937e-08, 1.72208445e-07,
+            3.04373458e-07, 4.72036845e-07, 6.73532270e-07, 9.06857224e-07,
+            1.16969272e-06, 1.45942670e-06, 1.77317963e-06, 2.10783310e-06,
+            2.46006152e-06, 2.82636415e-06, 3.20310028e-06, 3.58652596e-06,
+            3.97283065e-06, 4.35817492e-06, 4.73872888e-06, 5.11071039e-06,
+            5.47042328e-06, 5.81429140e-06, 6.13889824e-06, 6.44101738e-06,
+            6.71764610e-06, 6.96603502e-06, 7.18371575e-06, 7.36852462e-06,
+            7.51862581e-06, 7.63252592e-06, 7.70909446e-06, 7.74757063e-06
+        },
+        .s128 =
+        {
+            0.00000000e+00, 2.35275155e-09, 9.40524902e-09, 2.11402327e-08,
+            3.75289879e-08, 5.85314055e-08, 8.40960865e-08, 1.14160478e-07,
+            1.48651012e-07, 1.87483252e-07, 2.30562208e-07, 2.77782448e-07,
+            3.29028410e-07, 3.84174683e-07, 4.43086321e-07, 5.05619141e-07,
+            5.71620149e-07, 6.40927794e-07, 7.13372515e-07, 7.88776958e-07,
+            8.66956668e-07, 9.47720252e-07, 1.03087018e-06, 1.11620284e-06,
+            1.20350944e-06, 1.29257637e-06, 1.38318569e-06, 1.47511560e-06,
+            1.56814122e-06, 1.66203483e-06, 1.75656658e-06, 1.85150532e-06,
+            1.94661857e-06, 2.04167350e-06, 2.13643784e-06, 2.23067923e-06,
+            2.32416755e-06, 2.41667362e-06, 2.50797098e-06, 2.59783678e-06,
+            2.68605049e-06, 2.77239656e-06, 2.85666374e-06, 2.93864537e-06,
+            3.01814134e-06, 3.09495704e-06, 3.16890419e-06, 3.23980203e-06,
+            3.30747707e-06, 3.37176380e-06, 3.43250463e-06, 3.48955086e-06,
+            3.54276335e-06, 3.59201158e-06, 3.63717481e-06, 3.67814300e-06,
+            3.71481565e-06, 3.74710294e-06, 3.77492597e-06, 3.79821677e-06,
+            3.81691780e-06, 3.83098404e-06, 3.84038094e-06, 3.84508485e-06
         },
-        .s256 = {
-            0.00000000e+00, 1.51774011e-04, 6.07003903e-04, 1.36541331e-03,
-            2.42654180e-03, 3.78974516e-03, 5.45419581e-03, 7.41888327e-03,
-            9.68261477e-03, 1.22440160e-02, 1.51015320e-02, 1.82534279e-02,
-            2.16977902e-02, 2.54325280e-02, 2.94553737e-02, 3.37638853e-02,
-            3.83554469e-02, 4.32272712e-02, 4.83764003e-02, 5.37997084e-02,
-            5.94939029e-02, 6.54555268e-02, 7.16809611e-02, 7.81664261e-02,
-            8.49079846e-02, 9.19015438e-02, 9.91428580e-02, 1.06627531e-01,
-            1.14351019e-01, 1.22308633e-01, 1.30495541e-01, 1.38906775e-01,
-            1.47537227e-01, 1.56381657e-01, 1.65434697e-01, 1.74690850e-01,
-            1.84144497e-01, 1.93789898e-01, 2.03621199e-01, 2.13632430e-01,
-            2.23817514e-01, 2.34170266e-01, 2.44684403e-01, 2.55353542e-01,
-            2.66171204e-01, 2.77130822e-01, 2.88225744e-01, 2.99449233e-01,
-            3.10794475e-01, 3.22254583e-01, 3.33822600e-01, 3.45491503e-01,
-            3.57254207e-01, 3.69103571e-01, 3.81032402e-01, 3.93033458e-01,
-            4.05099453e-01, 4.17223062e-01, 4.29396924e-01, 4.41613649e-01,
-            4.53865820e-01, 4.66145999e-01, 4.78446731e-01, 4.90760548e-01,
-            5.03079973e-01, 5.15397529e-01, 5.27705737e-01, 5.39997126e-01,
-            5.52264232e-01, 5.64499608e-01, 5.76695827e-01, 5.88845485e-01,
-            6.00941205e-01, 6.12975643e-01, 6.24941495e-01, 6.36831495e-01,
-            6.48638425e-01, 6.60355118e-01, 6.71974459e-01, 6.83489396e-01,
-            6.94892937e-01, 7.06178159e-01, 7.17338211e-01, 7.28366318e-01,
-            7.39255785e-01, 7.50000000e-01, 7.60592441e-01, 7.71026678e-01,
-            7.81296376e-01, 7.91395299e-01, 8.01317318e-01, 8.11056408e-01,
-            8.20606657e-01, 8.29962267e-01, 8.39117559e-01, 8.48066973e-01,
-            8.56805077e-01, 8.65326566e-01, 8.73626267e-01, 8.81699141e-01,
-            8.89540287e-01, 8.97144945e-01, 9.04508497e-01, 9.11626474e-01,
-            9.18494554e-01, 9.25108568e-01, 9.31464500e-01, 9.37558491e-01,
-            9.43386843e-01, 9.48946016e-01, 9.54232636e-01, 9.59243493e-01,
-            9.63975545e-01, 9.68425919e-01, 9.72591914e-01, 9.76471000e-01,
-            9.80060823e-01, 9.83359202e-01, 9.86364136e-01, 9.89073800e-01,
-            9.91486550e-01, 9.93600920e-01, 9.95415627e-01, 9.96929568e-01,
-            9.98141826e-01, 9.99051664e-01, 9.99658530e-01, 9.99962055e-01,
-            9.99962055e-01, 9.99658530e-01, 9.99051664e-01, 9.98141826e-01,
-            9.96929568e-01, 9.95415627e-01, 9.93600920e-01, 9.91486550e-01,
-            9.89073800e-01, 9.86364136e-01, 9.83359202e-01, 9.80060823e-01,
-            9.76471000e-01, 9.72591914e-01, 9.68425919e-01, 9.63975545e-01,
-            9.59243493e-01, 9.54232636e-01, 9.48946016e-01, 9.43386843e-01,
-            9.37558491e-01, 9.31464500e-01, 9.25108568e-01, 9.18494554e-01,
-            9.11626474e-01, 9.04508497e-01, 8.97144945e-01, 8.89540287e-01,
-            8.81699141e-01, 8.73626267e-01, 8.65326566e-01, 8.56805077e-01,
-            8.48066973e-01, 8.39117559e-01, 8.29962267e-01, 8.20606657e-01,
-            8.11056408e-01, 8.01317318e-01, 7.91395299e-01, 7.81296376e-01,
-            7.71026678e-01, 7.60592441e-01, 7.50000000e-01, 7.39255785e-01,
-            7.28366318e-01, 7.17338211e-01, 7.06178159e-01, 6.94892937e-01,
-            6.83489396e-01, 6.71974459e-01, 6.60355118e-01, 6.48638425e-01,
-            6.36831495e-01, 6.24941495e-01, 6.12975643e-01, 6.00941205e-01,
-            5.88845485e-01, 5.76695827e-01, 5.64499608e-01, 5.52264232e-01,
-            5.39997126e-01, 5.27705737e-01, 5.15397529e-01, 5.03079973e-01,
-            4.90760548e-01, 4.78446731e-01, 4.66145999e-01, 4.53865820e-01,
-            4.41613649e-01, 4.29396924e-01, 4.17223062e-01, 4.05099453e-01,
-            3.93033458e-01, 3.81032402e-01, 3.69103571e-01, 3.57254207e-01,
-            3.45491503e-01, 3.33822600e-01, 3.22254583e-01, 3.10794475e-01,
-            2.99449233e-01, 2.88225744e-01, 2.77130822e-01, 2.66171204e-01,
-            2.55353542e-01, 2.44684403e-01, 2.34170266e-01, 2.23817514e-01,
-            2.13632430e-01, 2.03621199e-01, 1.93789898e-01, 1.84144497e-01,
-            1.74690850e-01, 1.65434697e-01, 1.56381657e-01, 1.47537227e-01,
-            1.38906775e-01, 1.30495541e-01, 1.22308633e-01, 1.14351019e-01,
-            1.06627531e-01, 9.91428580e-02, 9.19015438e-02, 8.49079846e-02,
-            7.81664261e-02, 7.16809611e-02, 6.54555268e-02, 5.94939029e-02,
-            5.37997084e-02, 4.83764003e-02, 4.32272712e-02, 3.83554469e-02,
-            3.37638853e-02, 2.94553737e-02, 2.54325280e-02, 2.16977902e-02,
-            1.82534279e-02, 1.51015320e-02, 1.22440160e-02, 9.68261477e-03,
-            7.41888327e-03, 5.45419581e-03, 3.78974516e-03, 2.42654180e-03,
-            1.36541331e-03, 6.07003903e-04, 1.51774011e-04, 0.00000000e+00
-        } },
-    .kaiser_b25 = 
+        .s256 =
+        {
+            0.00000000e+00, 2.90692165e-10, 1.16259213e-09, 2.61517075e-09,
+            4.64754590e-09, 7.25848404e-09, 1.04463993e-08, 1.42093572e-08,
+            1.85450730e-08, 2.34509159e-08, 2.89239050e-08, 3.49607170e-08,
+            4.15576906e-08, 4.87108203e-08, 5.64157610e-08, 6.46678373e-08,
+            7.34620329e-08, 8.27930222e-08, 9.26551280e-08, 1.03042368e-07,
+            1.13948438e-07, 1.25366711e-07, 1.37290257e-07, 1.49711852e-07,
+            1.62623920e-07, 1.76018659e-07, 1.89887928e-07, 2.04223284e-07,
+            2.19016059e-07, 2.34257243e-07, 2.49937585e-07, 2.66047607e-07,
+            2.82577474e-07, 2.99517154e-07, 3.16856415e-07, 3.34584684e-07,
+            3.52691217e-07, 3.71165015e-07, 3.89994881e-07, 4.09169360e-07,
+            4.28676799e-07, 4.48505375e-07, 4.68643066e-07, 4.89077649e-07,
+            5.09796678e-07, 5.30787588e-07, 5.52037648e-07, 5.73533953e-07,
+            5.95263430e-07, 6.17212947e-07, 6.39369091e-07, 6.61718502e-07,
+            6.84247539e-07, 7.06942615e-07, 7.29789861e-07, 7.52775406e-07,
+            7.75885383e-07, 7.99105692e-07, 8.22422237e-07, 8.45820864e-07,
+            8.69287419e-07, 8.92807577e-07, 9.16367128e-07, 9.39951747e-07,
+            9.63547109e-07, 9.87138833e-07, 1.01071271e-06, 1.03425430e-06,
+            1.05774950e-06, 1.08118388e-06, 1.10454323e-06, 1.12781345e-06,
+            1.15098032e-06, 1.17402976e-06, 1.19694801e-06, 1.21972084e-06,
+            1.24233463e-06, 1.26477551e-06, 1.28703005e-06, 1.30908450e-06,
+            1.33092567e-06, 1.35254027e-06, 1.37391498e-06, 1.39503709e-06,
+            1.41589362e-06, 1.43647208e-06, 1.45675972e-06, 1.47674439e-06,
+            1.49641380e-06, 1.51575625e-06, 1.53475992e-06, 1.55341309e-06,
+            1.57170473e-06, 1.58962348e-06, 1.60715854e-06, 1.62429933e-06,
+            1.64103540e-06, 1.65735651e-06, 1.67325288e-06, 1.68871486e-06,
+            1.70373301e-06, 1.71829811e-06, 1.73240153e-06, 1.74603451e-06,
+            1.75918899e-06, 1.77185677e-06, 1.78403025e-06, 1.79570202e-06,
+            1.80686504e-06, 1.81751250e-06, 1.82763802e-06, 1.83723523e-06,
+            1.84629857e-06, 1.85482236e-06, 1.86280147e-06, 1.87023102e-06,
+            1.87710657e-06, 1.88342403e-06, 1.88917932e-06, 1.89436912e-06,
+            1.89899026e-06, 1.90303990e-06, 1.90651565e-06, 1.90941523e-06,
+            1.91173717e-06, 1.91347976e-06, 1.91464210e-06, 1.91522327e-06
+        },
+        .gain =
+        {
+            3.25600326e-05, 1.57548545e-05, 7.75238870e-06,
+            3.84567314e-06, 1.91529603e-06
+        }
+    },
+    .kaiser_b25 =
     {
         .s16 =
-        {   1.7317335e-10, 5.1590232e-06, 4.0652708e-04, 7.5431336e-03,
-            5.9185378e-02, 2.4659413e-01, 6.0969925e-01, 9.4696587e-01,
-            9.4696587e-01, 6.0969925e-01, 2.4659413e-01, 5.9185378e-02,
-            7.5431336e-03, 4.0652708e-04, 5.1590232e-06, 1.7317335e-10 },
-        .s32 = 
         {
-            1.73173351e-10, 1.61998003e-07, 4.30531964e-06, 4.76741225e-05,
-            3.23684915e-04, 1.57319242e-03, 5.93495090e-03, 1.82437934e-02,
-            4.71659079e-02, 1.04815245e-01, 2.03354374e-01, 3.48355740e-01,
-            5.31276107e-01, 7.25665569e-01, 8.91398251e-01, 9.87333238e-01,
-            9.87333238e-01, 8.91398251e-01, 7.25665569e-01, 5.31276107e-01,
-            3.48355740e-01, 2.03354374e-01, 1.04815245e-01, 4.71659079e-02,
-            1.82437934e-02, 5.93495090e-03, 1.57319242e-03, 3.23684915e-04,
-            4.76741225e-05, 4.30531964e-06, 1.61998003e-07, 1.73173351e-10
+            4.62931464e-11, 1.37912343e-06, 1.08673870e-04, 2.01645005e-03,
+            1.58215873e-02, 6.59201741e-02, 1.62986368e-01, 2.53145367e-01
+        },
+        .s32 =
+        {
+            2.23999101e-11, 2.09543831e-08, 5.56891507e-07, 6.16663056e-06,
+            4.18685231e-05, 2.03491858e-04, 7.67683727e-04, 2.35982821e-03,
+            6.10089302e-03, 1.35578141e-02, 2.63038147e-02, 4.50596884e-02,
+            6.87203705e-02, 9.38645750e-02, 1.15302034e-01, 1.27711192e-01
         },
         .s64 =
-        {   1.73173351e-10, 1.46225227e-08, 1.51942473e-07,
-            9.02540194e-07, 3.94500830e-06, 1.40544144e-05,
-            4.30646869e-05, 1.17248455e-04, 2.89807038e-04,
-            6.60214573e-04, 1.40169053e-03, 2.79685459e-03,
-            5.27952379e-03, 9.47772898e-03, 1.62497349e-02,
-            2.67018285e-02, 4.21749130e-02, 6.41873330e-02,
-            9.43249911e-02, 1.34076700e-01, 1.84622481e-01,
-            2.46594131e-01, 3.19837958e-01, 4.03217912e-01,
-            4.94498909e-01, 5.90345860e-01, 6.86460674e-01,
-            7.77860403e-01, 8.59278560e-01, 9.25646007e-01,
-            9.72595215e-01, 9.96918797e-01, 9.96918797e-01,
-            9.72595215e-01, 9.25646007e-01, 8.59278560e-01,
-            7.77860403e-01, 6.86460674e-01, 5.90345860e-01,
-            4.94498909e-01, 4.03217912e-01, 3.19837958e-01,
-            2.46594131e-01, 1.84622481e-01, 1.34076700e-01,
-            9.43249911e-02, 6.41873330e-02, 4.21749130e-02,
-            2.67018285e-02, 1.62497349e-02, 9.47772898e-03,
-            5.27952379e-03, 2.79685459e-03, 1.40169053e-03,
-            6.60214573e-04, 2.89807038e-04, 1.17248455e-04,
-            4.30646869e-05, 1.40544144e-05, 3.94500830e-06,
-            9.02540194e-07, 1.51942473e-07, 1.46225227e-08,
-            1.73173351e-10
+        {
+            1.10221780e-11, 9.30697741e-10, 9.67086944e-09, 5.74450887e-08,
+            2.51092814e-07, 8.94538630e-07, 2.74099125e-06, 7.46265687e-06,
+            1.84457058e-05, 4.20214928e-05, 8.92151220e-05, 1.78014845e-04,
+            3.36032361e-04, 6.03240740e-04, 1.03426690e-03, 1.69952423e-03,
+            2.68435874e-03, 4.08541039e-03, 6.00361917e-03, 8.53374507e-03,
+            1.17508955e-02, 1.56952795e-02, 2.03571208e-02, 2.56641060e-02,
+            3.14739831e-02, 3.75744738e-02, 4.36920077e-02, 4.95094433e-02,
+            5.46915606e-02, 5.89157343e-02, 6.19039685e-02, 6.34521171e-02
+        },
+        .s128 =
+        {
+            5.46769444e-12, 8.90340163e-11, 4.51540833e-10, 1.59949176e-09,
+            4.64869432e-09, 1.18481820e-08, 2.74341279e-08, 5.89632130e-08,
+            1.19318884e-07, 2.29632775e-07, 4.23414491e-07, 7.52233291e-07,
+            1.29333978e-06, 2.15964860e-06, 3.51251856e-06, 5.57775593e-06,
+            8.66522350e-06, 1.31923562e-05, 1.97117406e-05, 2.89427608e-05,
+            4.18070304e-05, 5.94670928e-05, 8.33674931e-05, 1.15276947e-04,
+            1.57329996e-04, 2.12066021e-04, 2.82463210e-04, 3.71964765e-04,
+            4.84493998e-04, 6.24455744e-04, 7.96720153e-04, 1.00658659e-03,
+            1.25972426e-03, 1.56208815e-03, 1.91980810e-03, 2.33905204e-03,
+            2.82586180e-03, 3.38596664e-03, 4.02457500e-03, 4.74615116e-03,
+            5.55418199e-03, 6.45094132e-03, 7.43726222e-03, 8.51232279e-03,
+            9.67345852e-03, 1.09160095e-02, 1.22332126e-02, 1.36161465e-02,
+            1.50537333e-02, 1.65328104e-02, 1.80382691e-02, 1.95532590e-02,
+            2.10594665e-02, 2.25374494e-02, 2.39670221e-02, 2.53277048e-02,
+            2.65991762e-02, 2.77617704e-02, 2.87969578e-02, 2.96878200e-02,
+            3.04194987e-02, 3.09795868e-02, 3.13584656e-02, 3.15495655e-02
         },
-        .s128 = 
+        .s256 =
         {
-            1.73173349e-10, 2.81989398e-09, 1.43012448e-08, 5.06592586e-08,
-            1.47233901e-07, 3.75256778e-07, 8.68896386e-07, 1.86748857e-06,
-            3.77907948e-06, 7.27295176e-06, 1.34104245e-05, 2.38248053e-05,
-            4.09627829e-05, 6.84005998e-05, 1.11248826e-04, 1.76659221e-04,
-            2.74445807e-04, 4.17829582e-04, 6.24312177e-04, 9.16677926e-04,
-            1.32411631e-03, 1.88344753e-03, 2.64042324e-03, 3.65106256e-03,
-            4.98297080e-03, 6.71657554e-03, 8.94620261e-03, 1.17809039e-02,
-            1.53449407e-02, 1.97778223e-02, 2.52337980e-02, 3.18807084e-02,
-            3.98981099e-02, 4.94746070e-02, 6.08043492e-02, 7.40826808e-02,
-            8.95009676e-02, 1.07240665e-01, 1.27466735e-01, 1.50320566e-01,
-            1.75912592e-01, 2.04314842e-01, 2.35553689e-01, 2.69603105e-01,
-            3.06378704e-01, 3.45732908e-01, 3.87451510e-01, 4.31251918e-01,
-            4.76783295e-01, 5.23628765e-01, 5.71309784e-01, 6.19292708e-01,
-            6.66997475e-01, 7.13808261e-01, 7.59085868e-01, 8.02181526e-01,
-            8.42451701e-01, 8.79273481e-01, 9.12060017e-01, 9.40275529e-01,
-            9.63449345e-01, 9.81188482e-01, 9.93188313e-01, 9.99240937e-01,
-            9.99240937e-01, 9.93188313e-01, 9.81188482e-01, 9.63449345e-01,
-            9.40275529e-01, 9.12060017e-01, 8.79273481e-01, 8.42451701e-01,
-            8.02181526e-01, 7.59085868e-01, 7.13808261e-01, 6.66997475e-01,
-            6.19292708e-01, 5.71309784e-01, 5.23628765e-01, 4.76783295e-01,
-            4.31251918e-01, 3.87451510e-01, 3.45732908e-01, 3.06378704e-01,
-            2.69603105e-01, 2.35553689e-01, 2.04314842e-01, 1.75912592e-01,
-            1.50320566e-01, 1.27466735e-01, 1.07240665e-01, 8.95009676e-02,
-            7.40826808e-02, 6.08043492e-02, 4.94746070e-02, 3.98981099e-02,
-            3.18807084e-02, 2.52337980e-02, 1.97778223e-02, 1.53449407e-02,
-            1.17809039e-02, 8.94620261e-03, 6.71657554e-03, 4.98297080e-03,
-            3.65106256e-03, 2.64042324e-03, 1.88344753e-03, 1.32411631e-03,
-            9.16677926e-04, 6.24312177e-04, 4.17829582e-04, 2.74445807e-04,
-            1.76659221e-04, 1.11248826e-04, 6.84005998e-05, 4.09627829e-05,
-            2.38248053e-05, 1.34104245e-05, 7.27295176e-06, 3.77907948e-06,
-            1.86748857e-06, 8.68896386e-07, 3.75256778e-07, 1.47233901e-07,
-            5.06592586e-08, 1.43012448e-08, 2.81989398e-09, 1.73173349e-10
+            2.72312620e-12, 1.47151423e-11, 4.40087584e-11, 1.05392410e-10,
+            2.22422955e-10, 4.31277264e-10, 7.85889465e-10, 1.36469847e-09,
+            2.27938912e-09, 3.68607522e-09, 5.79944626e-09, 8.91047414e-09,
+            1.34083598e-08, 1.98074996e-08, 2.87803168e-08, 4.11969268e-08,
+            5.81727129e-08, 8.11249095e-08, 1.11839519e-07, 1.52549859e-07,
+            2.06028162e-07, 2.75691804e-07, 3.65725697e-07, 4.81222344e-07,
+            6.28341525e-07, 8.14491102e-07, 1.04853052e-06, 1.34099855e-06,
+            1.70436761e-06, 2.15332443e-06, 2.70508099e-06, 3.37971278e-06,
+            4.20053084e-06, 5.19448122e-06, 6.39258042e-06, 7.83037649e-06,
+            9.54844563e-06, 1.15929161e-05, 1.40160200e-05, 1.68766710e-05,
+            2.02410611e-05, 2.41832913e-05, 2.87859875e-05, 3.41409650e-05,
+            4.03498598e-05, 4.75247907e-05, 5.57889762e-05, 6.52773742e-05,
+            7.61372576e-05, 8.85287736e-05, 1.02625469e-04, 1.18614706e-04,
+            1.36698087e-04, 1.57091737e-04, 1.80026516e-04, 2.05748118e-04,
+            2.34517109e-04, 2.66608724e-04, 3.02312634e-04, 3.41932435e-04,
+            3.85785272e-04, 4.34200716e-04, 4.87520214e-04, 5.46095660e-04,
+            6.10288116e-04, 6.80466474e-04, 7.57005357e-04, 8.40283581e-04,
+            9.30681650e-04, 1.02857966e-03, 1.13435474e-03, 1.24837807e-03,
+            1.37101219e-03, 1.50260807e-03, 1.64350145e-03, 1.79400994e-03,
+            1.95442932e-03, 2.12503015e-03, 2.30605435e-03, 2.49771075e-03,
+            2.70017283e-03, 2.91357376e-03, 3.13800410e-03, 3.37350764e-03,
+            3.62007832e-03, 3.87765747e-03, 4.14613029e-03, 4.42532403e-03,
+            4.71500540e-03, 5.01487823e-03, 5.32458210e-03, 5.64369187e-03,
+            5.97171532e-03, 6.30809460e-03, 6.65220385e-03, 7.00335298e-03,
+            7.36078667e-03, 7.72368675e-03, 8.09117313e-03, 8.46230891e-03,
+            8.83610081e-03, 9.21150576e-03, 9.58743319e-03, 9.96275060e-03,
+            1.03362873e-02, 1.07068419e-02, 1.10731889e-02, 1.14340819e-02,
+            1.17882630e-02, 1.21344700e-02, 1.24714402e-02, 1.27979219e-02,
+            1.31126801e-02, 1.34145040e-02, 1.37022138e-02, 1.39746694e-02,
+            1.42307756e-02, 1.44694922e-02, 1.46898404e-02, 1.48909036e-02,
+            1.50718428e-02, 1.52318934e-02, 1.53703773e-02, 1.54867033e-02,
+            1.55803720e-02, 1.56509802e-02, 1.56982243e-02, 1.57218967e-02
         },
-        .s256 = 
+        .gain =
         {
-            1.73173349e-10, 9.35788594e-10, 2.79867444e-09, 6.70228086e-09,
-            1.41446724e-08, 2.74264653e-08, 4.99775257e-08, 8.67860647e-08,
-            1.44954515e-07, 2.34410724e-07, 3.68807556e-07, 5.66648930e-07,
-            8.52685631e-07, 1.25962986e-06, 1.83024336e-06, 2.61986017e-06,
-            3.69941109e-06, 5.15902340e-06, 7.11227544e-06, 9.70119158e-06,
-            1.31020686e-05, 1.75322296e-05, 2.32578059e-05, 3.06026502e-05,
-            3.99584871e-05, 5.17964071e-05, 6.66798100e-05, 8.52789014e-05,
-            1.08386838e-04, 1.36937617e-04, 1.72025785e-04, 2.14928043e-04,
-            2.67126794e-04, 3.30335675e-04, 4.06527081e-04, 4.97961679e-04,
-            6.07219858e-04, 7.37235069e-04, 8.91328919e-04, 1.07324791e-03,
-            1.28720161e-03, 1.53790203e-03, 1.83060403e-03, 2.17114620e-03,
-            2.56599216e-03, 3.02227163e-03, 3.54782087e-03, 4.15122206e-03,
-            4.84184087e-03, 5.62986186e-03, 6.52632084e-03, 7.54313367e-03,
-            8.69312064e-03, 9.99002579e-03, 1.14485304e-02, 1.30842599e-02,
-            1.49137831e-02, 1.69546036e-02, 1.92251421e-02, 2.17447088e-02,
-            2.45334660e-02, 2.76123792e-02, 3.10031568e-02, 3.47281778e-02,
-            3.88104072e-02, 4.32732980e-02, 4.81406808e-02, 5.34366404e-02,
-            5.91853791e-02, 6.54110673e-02, 7.21376819e-02, 7.93888325e-02,
-            8.71875770e-02, 9.55562263e-02, 1.04516140e-01, 1.14087513e-01,
-            1.24289159e-01, 1.35138282e-01, 1.46650252e-01, 1.58838374e-01,
-            1.71713657e-01, 1.85284592e-01, 1.99556923e-01, 2.14533436e-01,
-            2.30213750e-01, 2.46594124e-01, 2.63667273e-01, 2.81422206e-01,
-            2.99844077e-01, 3.18914062e-01, 3.38609254e-01, 3.58902584e-01,
-            3.79762774e-01, 4.01154313e-01, 4.23037463e-01, 4.45368302e-01,
-            4.68098792e-01, 4.91176884e-01, 5.14546660e-01, 5.38148497e-01,
-            5.61919283e-01, 5.85792645e-01, 6.09699226e-01, 6.33566984e-01,
-            6.57321522e-01, 6.80886446e-01, 7.04183753e-01, 7.27134228e-01,
-            7.49657881e-01, 7.71674383e-01, 7.93103524e-01, 8.13865683e-01,
-            8.33882302e-01, 8.53076359e-01, 8.71372847e-01, 8.88699243e-01,
-            9.04985972e-01, 9.20166853e-01, 9.34179530e-01, 9.46965887e-01,
-            9.58472431e-01, 9.68650652e-01, 9.77457351e-01, 9.84854935e-01,
-            9.90811669e-01, 9.95301903e-01, 9.98306238e-01, 9.99811668e-01,
-            9.99811668e-01, 9.98306238e-01, 9.95301903e-01, 9.90811669e-01,
-            9.84854935e-01, 9.77457351e-01, 9.68650652e-01, 9.58472431e-01,
-            9.46965887e-01, 9.34179530e-01, 9.20166853e-01, 9.04985972e-01,
-            8.88699243e-01, 8.71372847e-01, 8.53076359e-01, 8.33882302e-01,
-            8.13865683e-01, 7.93103524e-01, 7.71674383e-01, 7.49657881e-01,
-            7.27134228e-01, 7.04183753e-01, 6.80886446e-01, 6.57321522e-01,
-            6.33566984e-01, 6.09699226e-01, 5.85792645e-01, 5.61919283e-01,
-            5.38148497e-01, 5.14546660e-01, 4.91176884e-01, 4.68098792e-01,
-            4.45368302e-01, 4.23037463e-01, 4.01154313e-01, 3.79762774e-01,
-            3.58902584e-01, 3.38609254e-01, 3.18914062e-01, 2.99844077e-01,
-            2.81422206e-01, 2.63667273e-01, 2.46594124e-01, 2.30213750e-01,
-            2.14533436e-01, 1.99556923e-01, 1.85284592e-01, 1.71713657e-01,
-            1.58838374e-01, 1.46650252e-01, 1.35138282e-01, 1.24289159e-01,
-            1.14087513e-01, 1.04516140e-01, 9.55562263e-02, 8.71875770e-02,
-            7.93888325e-02, 7.21376819e-02, 6.54110673e-02, 5.91853791e-02,
-            5.34366404e-02, 4.81406808e-02, 4.32732980e-02, 3.88104072e-02,
-            3.47281778e-02, 3.10031568e-02, 2.76123792e-02, 2.45334660e-02,
-            2.17447088e-02, 1.92251421e-02, 1.69546036e-02, 1.49137831e-02,
-            1.30842599e-02, 1.14485304e-02, 9.99002579e-03, 8.69312064e-03,
-            7.54313367e-03, 6.52632084e-03, 5.62986186e-03, 4.84184087e-03,
-            4.15122206e-03, 3.54782087e-03, 3.02227163e-03, 2.56599216e-03,
-            2.17114620e-03, 1.83060403e-03, 1.53790203e-03, 1.28720161e-03,
-            1.07324791e-03, 8.91328919e-04, 7.37235069e-04, 6.07219858e-04,
-            4.97961679e-04, 4.06527081e-04, 3.30335675e-04, 2.67126794e-04,
-            2.14928043e-04, 1.72025785e-04, 1.36937617e-04, 1.08386838e-04,
-            8.52789014e-05, 6.66798100e-05, 5.17964071e-05, 3.99584871e-05,
-            3.06026502e-05, 2.32578059e-05, 1.75322296e-05, 1.31020686e-05,
-            9.70119158e-06, 7.11227544e-06, 5.15902340e-06, 3.69941109e-06,
-            2.61986017e-06, 1.83024336e-06, 1.25962986e-06, 8.52685631e-07,
-            5.66648930e-07, 3.68807556e-07, 2.34410724e-07, 1.44954515e-07,
-            8.67860647e-08, 4.99775257e-08, 2.74264653e-08, 1.41446724e-08,
-            6.70228086e-09, 2.79867444e-09, 9.35788594e-10, 1.73173349e-10
+            2.67322578e-01, 1.29349635e-01, 6.36482330e-02,
+            3.15735329e-02, 1.57248576e-02
         }
     }
 };
 
-void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size)
+static const ifx_f32_t *select_window(
+    const sized_windows *sw, uint16_t size, ifx_f32_t *gain
+)
 {
     const ifx_f32_t *window;
+    int idx;
     switch (size) 
     {
     case 16:
         window = sw->s16;
+        idx = 0;
         break;
     case 32:
         window = sw->s32;
+        idx = 1;
         break;
     case 64:
         window = sw->s64;
+        idx = 2;
         break;
     case 128:
         window = sw->s128;
+        idx = 3;
         break;
     case 256:
         window = sw->s256;
+        idx = 4;
         break;
     default:
         abort();
     }
+    if (gain != NULL)
+    {
+        *gain = sw->gain[idx];
+    }
+    return window;
+}
+
+/*******************************************************************************
+* Function Name: get_window_view
+********************************************************************************
+* Summary:
+* Returns a view of a window table in flash, nothing is copied.
+*
+* Parameters:
+*  sw   : Window family, e.g. `&WINDOWS.hann_adc`.
+*  size : Window length (16, 32, 64, 128 or 256).
+*
+* Return:
+*  View of the half table.
+*
+*******************************************************************************/
+window_view get_window_view(const sized_windows *sw, uint16_t size)
+{
+    window_view view = {
+        .half = select_window(sw, size, NULL),
+        .size = size
+    };
+    return view;
+}
+
+/*******************************************************************************
+* Function Name: apply_window_f32
+********************************************************************************
+* Summary:
+* Multiplies `x` in place with a window. Each half-table coefficient is loaded
+* once and applied to both mirrored samples.
+*
+* Parameters:
+*  x      : in/out Signal of `window->size` elements.
+*  window : Window view.
+*
+*******************************************************************************/
+void apply_window_f32(ifx_f32_t *x, const window_view *window)
+{
+    uint16_t n = window->size;
+    for (int i = 0; i < n / 2; ++i)
+    {
+        ifx_f32_t w = window->half[i];
+        x[i] *= w;
+        x[n - 1 - i] *= w;
+    }
+}
+
+void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size)
+{
+    /* Full copy of the (pre-scaled) window, for code that needs a contiguous
+    *  window in RAM */
+    const ifx_f32_t *half = select_window(sw, size, NULL);
+
+    for (int i = 0; i < size / 2; ++i)
+    {
+        out[i] = half[i];
+        out[size - 1 - i] = half[i];
+    }
+}
+
+ifx_f32_t get_window_q31(const sized_windows *sw, q31_t *out, uint16_t size)
+{
+    /* Not normalized: the pre-scaling is undone to keep the full q31 range,
+    *  the caller applies `1/sum` */
+    ifx_f32_t gain;
+    const ifx_f32_t *half = select_window(sw, size, &gain);
 
     ifx_f32_t sum = 0;
-    for (int i = 0; i < size; ++i)
+    for (int i = 0; i < size / 2; ++i)
     {
-        sum += window[i];
+        float32_t w = half[i] / gain;
+        arm_float_to_q31(&w, &out[i], 1);
+        out[size - 1 - i] = out[i];
+        sum += 2 * w;
     }
-    arm_scale_f32(
-        (float32_t *)window, 1.0 / (float32_t)sum, (float32_t *)out, size
-    );
+    return sum;
 }
@@ -0,0 +1,297 @@
+/******************************************************************************
+* File Name:   radar_acquisition.c
+*
+* Description: This file implements the asynchronous readout of the radar
+*   FIFO: the FIFO interrupt only starts a transfer into the radar data
+*   manager, the samples are published from the transfer-complete interrupt.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+
+#include "radar_acquisition.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* fifo_irq() and transfer_done() must run at the same interrupt priority, so
+*  that neither preempts the other */
+static struct {
+    radar_acquisition_backend_s backend;
+    radar_acquisition_sink_s sink;
+    uint32_t n_samples;             /* samples per readout */
+    volatile radar_acquisition_state_e state;
+    uint8_t *dst;                   /* sink region of the readout in flight */
+    uint32_t t_irq;                 /* FIFO interrupt of the readout in flight */
+    bool pending;                   /* a FIFO interrupt arrived during the readout */
+    uint32_t t_pending;
+    radar_acquisition_stats_s stats;
+} acq;
+
+/*******************************************************************************
+* Function Name: radar_acquisition_ticks_to_us
+********************************************************************************/
+static uint32_t radar_acquisition_ticks_to_us(uint32_t ticks)
+{
+    return ticks / acq.backend.ticks_per_us;
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_isr_time
+********************************************************************************
+* Summary:
+* Records the time spent in an interrupt handler entered at t_enter.
+*
+*******************************************************************************/
+static void radar_acquisition_isr_time(uint32_t t_enter)
+{
+    uint32_t us = radar_acquisition_ticks_to_us(acq.backend.now(acq.backend.ctx) - t_enter);
+
+    if (us > acq.stats.isr_max_us)
+    {
+        acq.stats.isr_max_us = us;
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_unpack12
+********************************************************************************
+* Summary:
+* Unpacks the 12-bit FIFO samples (3 bytes per 2 samples, big endian) of a
+* committed readout to uint16_t. Works from the end, so samples may be the
+* start of packed for an in-place unpack.
+*
+* Parameters:
+*  packed: packed samples
+*  samples: out unpacked samples, n_samples uint16_t
+*  n_samples: number of samples, even
+*
+*******************************************************************************/
+void radar_acquisition_unpack12(const uint8_t *packed, uint16_t *samples, uint32_t n_samples)
+{
+    for (uint32_t i = n_samples / 2; i-- > 0; )
+    {
+        const uint8_t *in = &packed[3 * i];
+        uint16_t s0 = (uint16_t)(((uint16_t)in[0] << 4) | (in[1] >> 4));
+        uint16_t s1 = (uint16_t)((((uint16_t)in[1] & 0x0FU) << 8) | in[2]);
+        samples[2 * i] = s0;
+        samples[2 * i + 1] = s1;
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_start
+********************************************************************************
+* Summary:
+* Reserves the next region of the sink and starts the readout into it.
+* Without room in the sink the FIFO content is dropped.
+*
+* Parameters:
+*  t_irq: time stamp of the FIFO interrupt served by this readout
+*
+*******************************************************************************/
+static void radar_acquisition_start(uint32_t t_irq)
+{
+    uint8_t *dst;
+
+    if (acq.sink.reserve(&dst, acq.n_samples * sizeof(uint16_t)) != 0)
+    {
+        acq.stats.drops++;
+        acq.backend.reset_fifo(acq.backend.ctx);
+        return;
+    }
+
+    acq.dst = dst;
+    acq.t_irq = t_irq;
+    acq.state = RADAR_ACQUISITION_TRANSFER;
+
+    if (acq.backend.start_read(acq.backend.ctx, dst, (acq.n_samples * 3U) / 2U) != 0)
+    {
+        /* The reserved region is simply not committed */
+        acq.state = RADAR_ACQUISITION_IDLE;
+        acq.stats.errors++;
+        acq.backend.reset_fifo(acq.backend.ctx);
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_init
+********************************************************************************
+* Summary:
+* Sets up the asynchronous readout.
+*
+* Parameters:
+*  backend: SPI/DMA readout of the sensor FIFO
+*  sink: destination of the samples
+*  samples_per_read: samples per FIFO interrupt, even
+*
+* Return:
+*  0 on success, -1 if the parameters are not valid
+*
+*******************************************************************************/
+int32_t radar_acquisition_init(const radar_acquisition_backend_s *backend,
+                               const radar_acquisition_sink_s *sink,
+                               uint32_t samples_per_read)
+{
+    if ((NULL == backend) || (NULL == backend->start_read) || (NULL == backend->reset_fifo) ||
+        (NULL == backend->now) || (0 == backend->ticks_per_us) ||
+        (NULL == sink) || (NULL == sink->reserve) || (NULL == sink->commit) ||
+        (0 == samples_per_read) || ((samples_per_read % 2) != 0))
+    {
+        return -1;
+    }
+
+    acq.backend = *backend;
+    acq.sink = *sink;
+    acq.n_samples = samples_per_read;
+    acq.state = RADAR_ACQUISITION_IDLE;
+    acq.dst = NULL;
+    acq.pending = false;
+    acq.stats = (radar_acquisition_stats_s){0};
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_fifo_irq
+********************************************************************************
+* Summary:
+* To be called from the FIFO interrupt of the sensor. Starts the readout, or
+* queues it if the previous one is still in flight. No sample is copied here.
+*
+*******************************************************************************/
+void radar_acquisition_fifo_irq(void)
+{
+    uint32_t t = acq.backend.now(acq.backend.ctx);
+
+    if (acq.state == RADAR_ACQUISITION_TRANSFER)
+    {
+        if (acq.pending)
+        {
+            acq.stats.overruns++;
+            if (NULL != acq.sink.overrun)
+            {
+                acq.sink.overrun();
+            }
+        }
+        else
+        {
+            acq.pending = true;
+            acq.t_pending = t;
+            acq.stats.queued++;
+        }
+    }
+    else
+    {
+        radar_acquisition_start(t);
+    }
+
+    radar_acquisition_isr_time(t);
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_transfer_done
+********************************************************************************
+* Summary:
+* To be called from the transfer-complete interrupt. Commits the packed
+* samples to the sink, which notifies the subscribers, and starts a queued
+* readout. The subscribers unpack them in task context with
+* radar_acquisition_unpack12().
+*
+* Parameters:
+*  ok: false if the transfer failed
+*
+*******************************************************************************/
+void radar_acquisition_transfer_done(bool ok)
+{
+    uint32_t t = acq.backend.now(acq.backend.ctx);
+
+    if (acq.state != RADAR_ACQUISITION_TRANSFER)
+    {
+        acq.stats.errors++;
+        return;
+    }
+
+    if (ok)
+    {
+        acq.sink.commit(acq.n_samples * sizeof(uint16_t), true);
+
+        uint32_t latency = radar_acquisition_ticks_to_us(acq.backend.now(acq.backend.ctx) - acq.t_irq);
+        acq.stats.latency_last_us = latency;
+        if (latency > acq.stats.latency_max_us)
+        {
+            acq.stats.latency_max_us = latency;
+        }
+        acq.stats.transfers++;
+    }
+    else
+    {
+        acq.stats.errors++;
+        acq.backend.reset_fifo(acq.backend.ctx);
+    }
+
+    acq.state = RADAR_ACQUISITION_IDLE;
+    acq.dst = NULL;
+
+    if (acq.pending)
+    {
+        acq.pending = false;
+        radar_acquisition_start(acq.t_pending);
+    }
+
+    radar_acquisition_isr_time(t);
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_get_state
+********************************************************************************/
+radar_acquisition_state_e radar_acquisition_get_state(void)
+{
+    return acq.state;
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_get_stats
+********************************************************************************
+* Summary:
+* Copies the readout statistics since radar_acquisition_init().
+*
+*******************************************************************************/
+void radar_acquisition_get_stats(radar_acquisition_stats_s *stats)
+{
+    *stats = acq.stats;
+}
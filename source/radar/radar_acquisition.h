@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name:   radar_acquisition.h
+*
+* Description: This file contains the function prototypes and constants used
+*   in radar_acquisition.c and radar_acquisition_fake.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RADAR_ACQUISITION_H_
+#define RADAR_ACQUISITION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+/* Asynchronous FIFO readout of the radar sensor, implemented with SPI and DMA
+*  on target and by radar_acquisition_fake.c on host. */
+typedef struct {
+    /* Start reading n_bytes of packed 12-bit FIFO data into rx without
+    *  blocking. The end of the transfer must be reported with
+    *  radar_acquisition_transfer_done(). Returns 0 if the transfer started. */
+    int32_t (*start_read)(void *ctx, uint8_t *rx, uint32_t n_bytes);
+    /* Drop the content of the sensor FIFO */
+    void (*reset_fifo)(void *ctx);
+    /* Free-running time stamp */
+    uint32_t (*now)(void *ctx);
+    /* Time stamp ticks per microsecond */
+    uint32_t ticks_per_us;
+    void *ctx;
+} radar_acquisition_backend_s;
+
+/* Destination of the samples, usually the reserve() and commit() interfaces
+*  of the radar data manager. A region of n_samples uint16_t is reserved per
+*  readout and committed whole, with the packed samples at its start. */
+typedef struct {
+    int32_t (*reserve)(uint8_t **data, uint32_t size);
+    void (*commit)(uint32_t size, bool from_isr);
+    /* Optional, called for every FIFO interrupt that is lost */
+    void (*overrun)(void);
+} radar_acquisition_sink_s;
+
+typedef enum {
+    RADAR_ACQUISITION_IDLE = 0,     /* waiting for the FIFO interrupt */
+    RADAR_ACQUISITION_TRANSFER = 1  /* a readout is in flight */
+} radar_acquisition_state_e;
+
+typedef struct {
+    uint32_t transfers;     /* readouts committed to the sink */
+    uint32_t queued;        /* FIFO interrupts that arrived during a readout and were served after it */
+    uint32_t overruns;      /* FIFO interrupts lost, a readout and a queued one were pending */
+    uint32_t drops;         /* readouts dropped for lack of space in the sink */
+    uint32_t errors;        /* transfers that failed to start or complete */
+    uint32_t latency_last_us;   /* FIFO interrupt to commit, last readout */
+    uint32_t latency_max_us;    /* FIFO interrupt to commit, worst readout */
+    uint32_t isr_max_us;        /* longest time spent in either interrupt handler */
+} radar_acquisition_stats_s;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int32_t radar_acquisition_init(const radar_acquisition_backend_s *backend,
+                               const radar_acquisition_sink_s *sink,
+                               uint32_t samples_per_read);
+void radar_acquisition_fifo_irq(void);
+void radar_acquisition_transfer_done(bool ok);
+radar_acquisition_state_e radar_acquisition_get_state(void);
+void radar_acquisition_get_stats(radar_acquisition_stats_s *stats);
+void radar_acquisition_unpack12(const uint8_t *packed, uint16_t *samples, uint32_t n_samples);
+
+#ifdef RADAR_ACQUISITION_FAKE
+/* Host-side fake of the SPI/DMA readout with a simulated clock in ns */
+void radar_acquisition_fake_init(radar_acquisition_backend_s *backend, uint32_t spi_hz);
+void radar_acquisition_fake_advance(uint32_t ns);
+uint32_t radar_acquisition_fake_now(void);
+void radar_acquisition_fake_fail_next(void);
+uint32_t radar_acquisition_fake_fifo_resets(void);
+#endif
+
+#endif /* RADAR_ACQUISITION_H_ */
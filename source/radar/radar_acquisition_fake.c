@@ -0,0 +1,185 @@
+/******************************************************************************
+* File Name:   radar_acquisition_fake.c
+*
+* Description: This file implements a host-side fake of the SPI/DMA readout
+*   used by radar_acquisition.c, so that the acquisition state machine and its
+*   latency can be exercised on Linux. Built only with RADAR_ACQUISITION_FAKE.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "radar_acquisition.h"
+
+#ifdef RADAR_ACQUISITION_FAKE
+
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* The fake sensor delivers a running 12-bit sample counter. A transfer
+*  completes n_bytes * 8 SPI clocks after it was started, time only moves with
+*  radar_acquisition_fake_advance(). */
+static struct {
+    uint64_t now_ns;
+    uint32_t spi_hz;
+    bool busy;
+    bool fail_next;
+    uint8_t *rx;
+    uint32_t n_bytes;
+    uint64_t done_ns;
+    uint16_t next_sample;
+    uint32_t fifo_resets;
+} fake;
+
+static uint32_t radar_acquisition_fake_clock(void *ctx)
+{
+    (void)ctx;
+    return (uint32_t)fake.now_ns;
+}
+
+static int32_t radar_acquisition_fake_start_read(void *ctx, uint8_t *rx, uint32_t n_bytes)
+{
+    (void)ctx;
+
+    if (fake.busy)
+    {
+        return -1;
+    }
+
+    fake.busy = true;
+    fake.rx = rx;
+    fake.n_bytes = n_bytes;
+    fake.done_ns = fake.now_ns + ((uint64_t)n_bytes * 8U * 1000000000U) / fake.spi_hz;
+
+    return 0;
+}
+
+static void radar_acquisition_fake_reset_fifo(void *ctx)
+{
+    (void)ctx;
+    fake.fifo_resets++;
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_fake_complete
+********************************************************************************
+* Summary:
+* "DMA" of the transfer in flight: packs the next samples of the fake sensor
+* into rx (3 bytes per 2 samples) and raises the transfer-complete interrupt.
+*
+*******************************************************************************/
+static void radar_acquisition_fake_complete(void)
+{
+    bool ok = !fake.fail_next;
+
+    for (uint32_t i = 0; (i + 3U) <= fake.n_bytes; i += 3U)
+    {
+        uint16_t s0 = fake.next_sample++ & 0x0FFFU;
+        uint16_t s1 = fake.next_sample++ & 0x0FFFU;
+        fake.rx[i] = (uint8_t)(s0 >> 4);
+        fake.rx[i + 1U] = (uint8_t)(((s0 & 0x0FU) << 4) | (s1 >> 8));
+        fake.rx[i + 2U] = (uint8_t)(s1 & 0xFFU);
+    }
+
+    fake.fail_next = false;
+    fake.busy = false;
+    radar_acquisition_transfer_done(ok);
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_fake_init
+********************************************************************************
+* Summary:
+* Resets the fake sensor and fills backend with the fake readout.
+*
+* Parameters:
+*  backend: out Backend to be passed to radar_acquisition_init()
+*  spi_hz: simulated SPI clock
+*
+*******************************************************************************/
+void radar_acquisition_fake_init(radar_acquisition_backend_s *backend, uint32_t spi_hz)
+{
+    memset(&fake, 0, sizeof(fake));
+    fake.spi_hz = spi_hz;
+
+    backend->start_read = radar_acquisition_fake_start_read;
+    backend->reset_fifo = radar_acquisition_fake_reset_fifo;
+    backend->now = radar_acquisition_fake_clock;
+    backend->ticks_per_us = 1000U;
+    backend->ctx = NULL;
+}
+
+/*******************************************************************************
+* Function Name: radar_acquisition_fake_advance
+********************************************************************************
+* Summary:
+* Moves the simulated clock on by ns, completing the transfer in flight when
+* it is due. A transfer started from the completion is completed as well if it
+* is due within the same step.
+*
+*******************************************************************************/
+void radar_acquisition_fake_advance(uint32_t ns)
+{
+    uint64_t end_ns = fake.now_ns + ns;
+
+    while (fake.busy && (fake.done_ns <= end_ns))
+    {
+        fake.now_ns = fake.done_ns;
+        radar_acquisition_fake_complete();
+    }
+
+    fake.now_ns = end_ns;
+}
+
+uint32_t radar_acquisition_fake_now(void)
+{
+    return (uint32_t)fake.now_ns;
+}
+
+/* The next transfer completes with an error */
+void radar_acquisition_fake_fail_next(void)
+{
+    fake.fail_next = true;
+}
+
+uint32_t radar_acquisition_fake_fifo_resets(void)
+{
+    return fake.fifo_resets;
+}
+
+#endif /* RADAR_ACQUISITION_FAKE */
@@ -37,6 +37,7 @@
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
 
+#include <stdbool.h>
 #include <string.h>
 
 #include "xensiv_radar_data_management.h"
@@ -49,6 +50,15 @@
 #endif /* #if defined (__GNUC__) && !defined(__ARMCC_VERSION) */
 #define FREERTOS_AWARE
 
+/* Guards the ring wrap state shared between the run() ISR and the readers */
+#ifdef FREERTOS_AWARE
+#define RDM_ENTER_CRITICAL()    taskENTER_CRITICAL()
+#define RDM_EXIT_CRITICAL()     taskEXIT_CRITICAL()
+#else
+#define RDM_ENTER_CRITICAL()
+#define RDM_EXIT_CRITICAL()
+#endif
+
 //////////////////////////////////////////////////DECLARATION/////////////////////////////////////////////
 #ifdef FREERTOS_AWARE
 
@@ -59,10 +69,18 @@
  */
 typedef struct {
 
-    bool data_read; /*<<indicate and mark if task has read the data*/
+    bool reading; /*<<set while the subscriber holds a slot it has not yet acknowledged*/
+
+    uint32_t slot_size; /*<<size of the held slot, the fill level may change meanwhile*/
 
     TaskHandle_t suscriber_task_handle; /*<<The FREERTOS Task handle representing subscriber task*/
 
+    uint32_t cursor; /*<<stream position of the next slot this subscriber reads*/
+
+    radar_data_policy_e policy; /*<<what happens when the subscriber falls a full ring behind*/
+
+    radar_data_subscriber_stats_s stats; /*<<lag, drop and stall counters*/
+
 }subscribers_task_lists_s;
 
 #endif
@@ -77,14 +95,34 @@ typedef struct {
 
     uint8_t *buffer; /*<< Pointer to heap for FIFO buffer allocation*/
 
-    uint32_t buff_size; /*<< Total size of buffer in bytes FIFO buffer */
+    uint32_t buff_size; /*<< Capacity of the ring in bytes, a power of two */
+
+    uint32_t mask; /*<< buff_size - 1, maps a stream position to a buffer index*/
+
+    uint32_t slack; /*<< Bytes allocated behind the ring for reads that wrap*/
 
     uint32_t samples; /*<< Total number of bytes in FIFO */
 
-    uint32_t head,tail; /*<< front and back positions of the FIFO queue*/
+    uint32_t head,tail; /*<< Free-running stream positions of the oldest retained and the next written byte*/
+
+    uint32_t wrap_pos; /*<< Stream position of the last wrap of the ring by the writer*/
+
+    uint32_t spill; /*<< Bytes written past the end of the ring into the slack at wrap_pos*/
 
     uint32_t fill_level; /*<< FIFO water mark level in bytes*/
 
+    uint32_t depth; /*<< Bytes the writer may run ahead of the oldest protected cursor, at most buff_size*/
+
+    radar_data_manager_stats_s stats; /*<< Readout and overflow counters*/
+
+    radar_data_adaptive_cfg_s adaptive; /*<< Fill level and depth controller, off if period is 0*/
+
+    uint32_t adaptive_readouts; /*<< Readouts in the current controller window*/
+
+    uint32_t adaptive_lag; /*<< Highest subscriber lag in the current controller window*/
+
+    uint32_t adaptive_buffer_full; /*<< buffer_full count at the start of the window*/
+
     uint8_t subscribers; /*<< Number of subscribers (task/callers)*/
 
 #ifdef FREERTOS_AWARE
@@ -93,35 +131,138 @@ typedef struct {
     cb_radar_data_event subscriptions[ACTIVE_SUBSCRIPTION_UB + 1]; /*<<list of all subscriber tasks of type \ref cb_radar_data_event*/
 #endif
 
-    void* (*malloc_func)(size_t size); /*<<Hold reference to consumer supplied memory allocation*/
+    radar_data_manager_s *interface; /*<< Interface instance bound to this state, NULL for a free pool entry*/
 
     void (* free_func)(void* ptr); /*<Hold reference to consumer supplied definition for releasing allocated memory<*/
 
+    bool static_buffer; /*<< The buffer was provided by the caller and is not freed*/
+
 }manager_state_s;
 
 
 //////////////////////////////////////////////////DEFINITIONS //////////////////////////////////////////////////////
-/*Instance of Internal state of radar data manager*/
-static manager_state_s manager;
+#if (RDM_MAX_INSTANCES < 1) || (RDM_MAX_INSTANCES > 8)
+#error "RDM_MAX_INSTANCES must be in the range 1..8"
+#endif
 
-/*Local copy of radar data manager interface instance.
- * This is instantiated by owner of the RDM initialization
- * and supplied during radar_data_manager_init
+/*Pool of internal states of radar data managers.
+ * An entry is bound to the radar data manager interface instance
+ * supplied during radar_data_manager_init
  * */
-static radar_data_manager_s *manager_interface;
+static manager_state_s managers[RDM_MAX_INSTANCES];
+
+/*Consumer supplied platform specific malloc and free, shared by all instances*/
+static void* (*rdm_malloc_func)(size_t size);
+
+static void (* rdm_free_func)(void* ptr);
 
 
 //////////////////////////////////////////////////FUNCTIONAL DEFINITIONS/////////////////////////////////////////////
 
+/*
+ * The buffer is a ring of buff_size (a power of two) bytes followed by slack
+ * bytes. head and tail are free-running stream positions, the buffer index of
+ * a position is (pos & mask). The writer always gets a contiguous region: a
+ * read from in_read_radar_data that starts before the end of the ring may run
+ * on into the slack. Those spilled bytes belong to the start of the next lap
+ * and stay in the slack, the writer continues behind them at index spill.
+ * Nothing is moved or cleared in run(), so a reader finds the stream as
+ *   [index of pos .. end of ring] [slack up to spill] [spill .. ]
+ * which is at most two spans.
+ */
+
+/*
+ * largest power of two not exceeding x
+ */
+static uint32_t
+radar_data_manager_floor_pow2(uint32_t x)
+{
+    uint32_t p = 1;
+
+    while (p <= (x >> 1))
+    {
+        p <<= 1;
+    }
+
+    return p;
+}
+
+/*
+ * locate stream position pos in the buffer, given a snapshot of the wrap state.
+ * Returns the address and in *contiguous the number of the len bytes from pos
+ * that are stored contiguously there.
+ */
+static uint8_t*
+radar_data_manager_locate(manager_state_s *manager, uint32_t pos, uint32_t len,
+        uint32_t wrap_pos, uint32_t spill, uint32_t *contiguous)
+{
+    uint32_t past_wrap = pos - wrap_pos;
+
+    if ((int32_t)past_wrap < 0)
+    {
+        //before the last wrap: the end of the ring continues in the slack
+        uint32_t n = (wrap_pos + spill) - pos;
+        *contiguous = (len < n) ? len : n;
+        return manager->buffer + (pos & manager->mask);
+    }
+
+    if (past_wrap < spill)
+    {
+        //spilled into the slack at the last wrap
+        uint32_t n = spill - past_wrap;
+        *contiguous = (len < n) ? len : n;
+        return manager->buffer + manager->buff_size + past_wrap;
+    }
+
+    uint32_t n = manager->buff_size - (pos & manager->mask);
+    *contiguous = (len < n) ? len : n;
+    return manager->buffer + (pos & manager->mask);
+}
+
+/*
+ * contiguous view of the size bytes from stream position pos.
+ * A slot the writer stored in one piece (the usual case, reads and writes of
+ * equal size) is returned in place. Otherwise the second part is copied
+ * behind the first one: into the slack, or for a slot starting in the slack
+ * the first part is copied down into the unused start of the ring. This runs
+ * in the reader's context, never in run().
+ */
+static uint8_t*
+radar_data_manager_slot(manager_state_s *manager, uint32_t pos, uint32_t size, uint32_t wrap_pos, uint32_t spill)
+{
+    uint32_t n1, n2;
+
+    uint8_t *first = radar_data_manager_locate(manager, pos, size, wrap_pos, spill, &n1);
+
+    if (n1 == size)
+    {
+        return first;
+    }
+
+    uint8_t *second = radar_data_manager_locate(manager, pos + n1, size - n1,
+            wrap_pos, spill, &n2);
+
+    if (first >= (manager->buffer + manager->buff_size))
+    {
+        uint8_t *slot = manager->buffer + (pos & manager->mask);
+        memcpy(slot, first, n1);
+        return slot;
+    }
+
+    memcpy(first + n1, second, n2);
+    return first;
+}
+
+
 /*
  * subscribe to radar data
  */
 #ifdef FREERTOS_AWARE
-int32_t
-radar_data_manager_subscribe(TaskHandle_t subscriber_task)
+static int32_t
+radar_data_manager_subscribe(manager_state_s *manager, TaskHandle_t subscriber_task)
 #else
-int32_t
-radar_data_manager_subscribe(cb_radar_data_event cb)
+static int32_t
+radar_data_manager_subscribe(manager_state_s *manager, cb_radar_data_event cb)
 #endif
 {
     //First check the sanity of parameter
@@ -140,19 +281,19 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
     for (uint8_t subs = 1; subs <= ACTIVE_SUBSCRIPTION_UB; subs++)
     {
         #ifdef FREERTOS_AWARE
-        if (manager.subscriptions[subs].suscriber_task_handle == subscriber_task)
+        if (manager->subscriptions[subs].suscriber_task_handle == subscriber_task)
         {
             return subs;
         }
         #else
-        if (manager.subscriptions[subs] == cb)
+        if (manager->subscriptions[subs] == cb)
         {
             return subs;
         }
         #endif
     }
     //check if active subscriptions limit is reached or buffer in not initialized/RDM deinit etc.
-    if ((manager.subscribers == ACTIVE_SUBSCRIPTION_UB) || (NULL == manager.buffer))
+    if ((manager->subscribers == ACTIVE_SUBSCRIPTION_UB) || (NULL == manager->buffer))
     {
         // Ran out of available subscriptions
         return -2;
@@ -161,28 +302,37 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
     for (uint8_t subs = 1; subs <= ACTIVE_SUBSCRIPTION_UB; subs++)
     {
         #ifdef FREERTOS_AWARE
-        if (manager.subscriptions[subs].suscriber_task_handle == subscriber_task)
+        if (manager->subscriptions[subs].suscriber_task_handle == subscriber_task)
         {
             return subs;
         }
 
-        if (NULL == manager.subscriptions[subs].suscriber_task_handle)
+        if (NULL == manager->subscriptions[subs].suscriber_task_handle)
         {
-            manager.subscriptions[subs].data_read = false;
+            //a new subscriber starts reading at the live data
+            RDM_ENTER_CRITICAL();
 
-            manager.subscriptions[subs].suscriber_task_handle = subscriber_task;
+            memset(&manager->subscriptions[subs], 0, sizeof(subscribers_task_lists_s));
 
-            manager.subscribers++;
+            manager->subscriptions[subs].policy = RDM_POLICY_BLOCK;
+
+            manager->subscriptions[subs].cursor = manager->tail;
+
+            manager->subscriptions[subs].suscriber_task_handle = subscriber_task;
+
+            manager->subscribers++;
+
+            RDM_EXIT_CRITICAL();
 
             return subs;
         }
         #else /* ifdef FREERTOS_AWARE */
 
-        if (NULL == manager.subscriptions[subs])
+        if (NULL == manager->subscriptions[subs])
         {
-            manager.subscriptions[subs]= cb;
+            manager->subscriptions[subs]= cb;
 
-            manager.subscribers++;
+            manager->subscribers++;
 
             return subs;
         }
@@ -197,210 +347,520 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
 /*
  * un-subscribe to radar data
  */
-void
-radar_data_manager_unsubscribe (int32_t subscription_id)
+static void
+radar_data_manager_unsubscribe(manager_state_s *manager, int32_t subscription_id)
 {
-    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (manager.subscribers == 0))
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (manager->subscribers == 0))
     {
         return;
     }
 
 #ifdef FREERTOS_AWARE
-    manager.subscriptions[subscription_id].data_read = false;
-    manager.subscriptions[subscription_id].suscriber_task_handle = NULL;
+    RDM_ENTER_CRITICAL();
+    manager->subscriptions[subscription_id].reading = false;
+    manager->subscriptions[subscription_id].suscriber_task_handle = NULL;
+    RDM_EXIT_CRITICAL();
 #else
 
-    manager.subscriptions[subscription_id]= NULL;
+    manager->subscriptions[subscription_id]= NULL;
 #endif
 
-    manager.subscribers--;
+    manager->subscribers--;
 }
 
 
 /*
- * trigger radar data manager
+ * contiguous space the writer may fill from the tail on: it must not pass the
+ * oldest cursor of a subscriber that blocks or currently holds a slot,
+ * overwrite-oldest subscribers lose slots instead. The slack behind the ring is
+ * included unless the previous spill is still needed.
+ * The subscription holding the oldest protected data is returned in *oldest_sub.
  */
+static uint32_t
+radar_data_manager_write_space(manager_state_s *manager, int32_t *oldest_sub)
+{
 #ifdef FREERTOS_AWARE
-void
-radar_data_manager_run(bool run_from_isr)
+    uint32_t protect = manager->tail;
+    *oldest_sub = 0;
+
+    for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+    {
+        subscribers_task_lists_s *subscriber = &manager->subscriptions[sub];
+
+        if ((NULL != subscriber->suscriber_task_handle) &&
+            ((subscriber->policy == RDM_POLICY_BLOCK) || subscriber->reading) &&
+            ((int32_t)(subscriber->cursor - protect) < 0))
+        {
+            protect = subscriber->cursor;
+            *oldest_sub = sub;
+        }
+    }
 #else
-void
-radar_data_manager_run()
+    uint32_t protect = manager->head;
+    *oldest_sub = 0;
 #endif
+
+    uint32_t index = manager->tail & manager->mask;
+    uint32_t used = manager->tail - protect;
+    uint32_t space = (used < manager->depth) ? (manager->depth - used) : 0;
+    uint32_t room = manager->buff_size - index;
+
+    if ((int32_t)(protect - (manager->wrap_pos + manager->spill)) >= 0)
+    {
+        room += manager->slack;
+    }
+
+    return (space < room) ? space : room;
+}
+
+/*
+ * move the cursors of overwrite-oldest subscribers past the data that a write
+ * of size bytes at the tail overwrites, slot by slot to stay aligned: data more
+ * than a ring behind the new tail, and the previous spill if the slack is
+ * written again. Subscribers holding a slot are never moved.
+ */
+static void
+radar_data_manager_make_room(manager_state_s *manager, uint32_t size)
 {
-    uint32_t samples;
+#ifdef FREERTOS_AWARE
+    uint32_t new_tail = manager->tail + size;
+    uint32_t spill_end = manager->wrap_pos + manager->spill;
+    bool respill = ((manager->tail & manager->mask) + size) > manager->buff_size;
 
-    if (manager.tail < manager.buff_size)
+    for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
     {
+        subscribers_task_lists_s *subscriber = &manager->subscriptions[sub];
 
-        int32_t result = manager_interface->in_read_radar_data((void*)(manager.buffer + manager.tail), &samples,
-                (manager.buff_size - manager.tail));
+        if ((NULL == subscriber->suscriber_task_handle) ||
+            (subscriber->policy != RDM_POLICY_OVERWRITE_OLDEST) || subscriber->reading)
+        {
+            continue;
+        }
 
-        if (result >= 0)
+        while (((int32_t)(new_tail - subscriber->cursor) > (int32_t)manager->buff_size) ||
+               (respill && ((int32_t)(subscriber->cursor - spill_end) < 0)))
         {
-            if ( samples <= (manager.buff_size - manager.tail))
-            {
-                //This implies a successful read
-                manager.tail += samples;
-                manager.samples = manager.tail - manager.head;
-            }
-            else
-            {
-                //handle anomaly
-                //anomaly includes failure to read data
-                //read data size is more than acceptable UB set by RDM etc.
-            }
+            subscriber->cursor += manager->fill_level;
+            subscriber->stats.drops++;
+        }
+    }
+#else
+    (void)manager;
+    (void)size;
+#endif
+}
 
+/*
+ * account for size bytes written at the tail
+ */
+static void
+radar_data_manager_advance(manager_state_s *manager, uint32_t size)
+{
+    uint32_t index = manager->tail & manager->mask;
+
+    if ((index + size) > manager->buff_size)
+    {
+        manager->wrap_pos = manager->tail + (manager->buff_size - index);
+        manager->spill = index + size - manager->buff_size;
+    }
+    manager->tail += size;
+}
+
+/*
+ * fill level and depth controller, run once per readout. Over a window of
+ * adaptive.period readouts it tracks the highest subscriber lag, i.e. how many
+ * slots the slowest consumer is behind. Then
+ *  - the depth grows by a slot if the buffer ran full, and otherwise follows
+ *    the lag plus margin_slots, shrinking one slot per window
+ *  - the fill level grows by fill_step while a consumer is two or more slots
+ *    behind (fewer, larger slots) and shrinks again once all keep up
+ */
+static void
+radar_data_manager_adapt(manager_state_s *manager, uint32_t lag)
+{
+    radar_data_adaptive_cfg_s *cfg = &manager->adaptive;
+
+    if (lag > manager->adaptive_lag)
+    {
+        manager->adaptive_lag = lag;
+    }
+
+    if (++manager->adaptive_readouts < cfg->period)
+    {
+        return;
+    }
+
+    uint32_t fill = manager->fill_level;
+    uint32_t depth = manager->depth;
+    uint32_t lag_slots = (manager->adaptive_lag + fill - 1) / fill;
+    uint32_t want = (lag_slots + cfg->margin_slots) * fill;
+
+    if (want < cfg->min_depth)
+    {
+        want = cfg->min_depth;
+    }
+    if (want > manager->buff_size)
+    {
+        want = manager->buff_size;
+    }
+
+    if (manager->stats.buffer_full != manager->adaptive_buffer_full)
+    {
+        depth += fill;
+    }
+    else if (want > depth)
+    {
+        depth = want;
+    }
+    else if (want < depth)
+    {
+        depth = ((depth - want) > fill) ? (depth - fill) : want;
+    }
+    if (depth > manager->buff_size)
+    {
+        depth = manager->buff_size;
+    }
+
+    if (cfg->max_fill_level > cfg->min_fill_level)
+    {
+        if ((lag_slots >= 2) && ((fill + cfg->fill_step) <= cfg->max_fill_level) &&
+            ((2 * (fill + cfg->fill_step)) <= depth))
+        {
+            fill += cfg->fill_step;
+        }
+        else if ((lag_slots <= 1) && (fill >= (cfg->min_fill_level + cfg->fill_step)))
+        {
+            fill -= cfg->fill_step;
         }
+    }
+
+    if ((depth != manager->depth) || (fill != manager->fill_level))
+    {
+        manager->stats.adaptations++;
+    }
+    manager->depth = depth;
+    manager->fill_level = fill;
+
+    manager->adaptive_readouts = 0;
+    manager->adaptive_lag = 0;
+    manager->adaptive_buffer_full = manager->stats.buffer_full;
+}
+
+/*
+ * update head and the statistics, and notify the subscribers that have a
+ * full slot to read
+ */
+#ifdef FREERTOS_AWARE
+static void
+radar_data_manager_publish(manager_state_s *manager, bool run_from_isr)
+#else
+static void
+radar_data_manager_publish(manager_state_s *manager)
+#endif
+{
+    uint32_t max_lag = 0;
+#ifdef FREERTOS_AWARE
+    uint32_t head = manager->tail;
+
+    for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+    {
+        subscribers_task_lists_s *subscriber = &manager->subscriptions[sub];
+
+        if (NULL == subscriber->suscriber_task_handle)
+        {
+            continue;
+        }
+
+        uint32_t lag = manager->tail - subscriber->cursor;
+        if ((int32_t)lag < 0)
+        {
+            //dropped into a partially written slot
+            lag = 0;
+        }
+        if (lag > subscriber->stats.lag_hwm)
+        {
+            subscriber->stats.lag_hwm = lag;
+        }
+        if (lag > max_lag)
+        {
+            max_lag = lag;
+        }
+
+        if ((int32_t)(subscriber->cursor - head) < 0)
+        {
+            head = subscriber->cursor;
+        }
+    }
+
+    manager->head = head;
+#endif
+    manager->samples = manager->tail - manager->head;
 
+    if (manager->adaptive.period > 0)
+    {
+        radar_data_manager_adapt(manager, max_lag);
     }
 
     //now check if the fill level is attained
-    if (manager.samples >= manager.fill_level)
+    if (manager->samples >= manager->fill_level)
     {
 #ifdef FREERTOS_AWARE
 
-        //now inform all subscribers about available data
+        //now inform the subscribers that have a full slot to read
         for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
         {
-            if (NULL != manager.subscriptions[sub].suscriber_task_handle)
+            if ((NULL != manager->subscriptions[sub].suscriber_task_handle) &&
+                ((int32_t)(manager->tail - manager->subscriptions[sub].cursor) >= (int32_t)manager->fill_level))
             {
 
                 if (run_from_isr)
                 {
                     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-                    vTaskNotifyGiveFromISR(manager.subscriptions[sub].suscriber_task_handle, &xHigherPriorityTaskWoken);
+                    vTaskNotifyGiveFromISR(manager->subscriptions[sub].suscriber_task_handle, &xHigherPriorityTaskWoken);
 
                     /* Context switch needed? */
                     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
                 }
                 else
                 {
-                    xTaskNotifyGive(manager.subscriptions[sub].suscriber_task_handle);
+                    xTaskNotifyGive(manager->subscriptions[sub].suscriber_task_handle);
                 }
 
             }
         }
 
-        // now adjust queue if all the subscribers tasks have consumed the data
-        bool adjust_queue = true;
+#else
+        //now inform all subscribers about available data
+        uint8_t *slot = radar_data_manager_slot(manager, manager->head, manager->fill_level,
+                manager->wrap_pos, manager->spill);
+
         for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
         {
-            if ((NULL != manager.subscriptions[sub].suscriber_task_handle) &&
-                (manager.subscriptions[sub].data_read == false))
+            if (NULL != manager->subscriptions[sub])
             {
-                adjust_queue = false;
+                manager->subscriptions[sub](slot, manager->fill_level);
             }
         }
 
-        if (adjust_queue == true)
-        {
-            // now adjust the queue by fill level
-            // considering reader has read all data till fill level
-            manager.head += manager.fill_level;
+        // now adjust the queue
+        manager->head += manager->fill_level;
+        manager->samples = manager->tail - manager->head;
 
-            //move the buffer to front by amount data already read
-            if (manager.head >0)
-            {
-                uint32_t sz = (manager.tail - manager.head);
+#endif
 
-                //move the buffer for new data
-                memcpy(manager.buffer, (manager.buffer + manager.head), sz);
+    }
+}
 
-                manager.tail = sz;
 
-                manager.head = 0;
+/*
+ * trigger radar data manager
+ */
+#ifdef FREERTOS_AWARE
+static void
+radar_data_manager_run(manager_state_s *manager, bool run_from_isr)
+#else
+static void
+radar_data_manager_run(manager_state_s *manager)
+#endif
+{
+    uint32_t samples;
+    int32_t oldest_sub;
 
+    uint32_t space = radar_data_manager_write_space(manager, &oldest_sub);
 
-            }
-            for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
-            {
+    int32_t result = manager->interface->in_read_radar_data(
+            (void*)(manager->buffer + (manager->tail & manager->mask)), &samples, space);
 
-                if (manager.subscriptions[sub].data_read == true )
-                {
-                    manager.subscriptions[sub].data_read = false;
-                }
-            }
+    if ((result >= 0) && (samples <= space))
+    {
+        //This implies a successful read
+        radar_data_manager_make_room(manager, samples);
+        radar_data_manager_advance(manager, samples);
 
+        manager->stats.readouts++;
+        if (samples < manager->fill_level)
+        {
+            manager->stats.short_reads++;
         }
-
-#else
-        //now inform all subscribers about available data
-        for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+    }
+    else if ((result == RDM_EOP_CANNOT_COMPLETE) && (space < manager->slack))
+    {
+        //the readout did not fit into the buffer and was dropped
+        manager->stats.buffer_full++;
+#ifdef FREERTOS_AWARE
+        //blame the subscriber holding the oldest data
+        if (oldest_sub > 0)
         {
-            if (NULL != manager.subscriptions[sub])
-            {
-                manager.subscriptions[sub](manager.buffer + manager.head, manager.fill_level);
-            }
+            manager->subscriptions[oldest_sub].stats.stalls++;
         }
+#endif
+    }
+    else
+    {
+        //handle anomaly
+        //anomaly includes failure to read data
+        //read data size is more than acceptable UB set by RDM etc.
+        manager->stats.read_errors++;
+    }
 
-        // now adjust the queue
-        manager.head += manager.fill_level;
+#ifdef FREERTOS_AWARE
+    radar_data_manager_publish(manager, run_from_isr);
+#else
+    radar_data_manager_publish(manager);
+#endif
+}
 
-        //move the buffer to front by amount data already read
-        if (manager.head >0)
-        {
-            uint32_t sz = (manager.tail - manager.head);
 
-            //move the buffer for new data
-            memcpy(manager.buffer, (manager.buffer + manager.head), sz);
+#ifdef FREERTOS_AWARE
 
-            manager.tail = sz;
+/*
+ * reserve size contiguous bytes at the tail for an asynchronous write
+ */
+static int32_t
+radar_data_manager_reserve(manager_state_s *manager, uint8_t **data, uint32_t size)
+{
+    int32_t oldest_sub;
 
-            manager.head = 0;
+    if ((NULL == data) || (0 == size))
+    {
+        return -1;
+    }
 
+    if (radar_data_manager_write_space(manager, &oldest_sub) < size)
+    {
+        manager->stats.buffer_full++;
 
+        //no room left, blame the subscriber holding the oldest data
+        if (oldest_sub > 0)
+        {
+            manager->subscriptions[oldest_sub].stats.stalls++;
         }
+        return -2;
+    }
 
+    //the overwritten slots are dropped before the write starts, so no
+    //subscriber can take them while the transfer is running
+    radar_data_manager_make_room(manager, size);
 
+    *data = manager->buffer + (manager->tail & manager->mask);
 
-#endif
-
-    }
-    //finally validate the head and tail of queue
-    if ((manager.tail == manager.buff_size) && (manager.head == manager.tail))
-    {
-        manager.tail = 0;
-        manager.head = 0;
-        manager.samples = 0;
+    return 0;
+}
 
-        //reset the buffer
-        memset((void*)manager.buffer,0,manager.buff_size);
+/*
+ * complete an asynchronous write started with reserve()
+ */
+static void
+radar_data_manager_commit(manager_state_s *manager, uint32_t size, bool from_isr)
+{
+    radar_data_manager_advance(manager, size);
 
+    manager->stats.readouts++;
+    if (size < manager->fill_level)
+    {
+        manager->stats.short_reads++;
     }
 
+    radar_data_manager_publish(manager, from_isr);
 }
 
+#endif
+
 
 #ifdef FREERTOS_AWARE
 
 /*
- * read from RDM data buffer
+ * take the next slot of a subscriber: snapshot its cursor and the wrap state,
+ * and mark the slot as held so that run() does not overwrite it
  */
-int32_t
-radar_data_manager_read_buffer(int32_t subscription_id, uint16_t **data_ptr, uint32_t *size)
+static int32_t
+radar_data_manager_take_slot(manager_state_s *manager, int32_t subscription_id, uint32_t *pos,
+        uint32_t *wrap_pos, uint32_t *spill, uint32_t *slot_size)
 {
+    int32_t result = 0;
+
     if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB))
     {
         return -1;
     }
 
-    if (manager.samples < manager.fill_level)
+    subscribers_task_lists_s *subscriber = &manager->subscriptions[subscription_id];
+
+    RDM_ENTER_CRITICAL();
+    if ((NULL == subscriber->suscriber_task_handle) ||
+        ((int32_t)(manager->tail - subscriber->cursor) < (int32_t)manager->fill_level))
     {
-        return -2;
+        result = -2;
+    }
+    else
+    {
+        if (!subscriber->reading)
+        {
+            subscriber->reading = true;
+            subscriber->slot_size = manager->fill_level;
+        }
+        *pos = subscriber->cursor;
+        *wrap_pos = manager->wrap_pos;
+        *spill = manager->spill;
+        *slot_size = subscriber->slot_size;
+    }
+    RDM_EXIT_CRITICAL();
+
+    return result;
+}
+
+/*
+ * read from RDM data buffer
+ */
+static int32_t
+radar_data_manager_read_buffer(manager_state_s *manager, int32_t subscription_id, uint16_t **data_ptr, uint32_t *size)
+{
+    uint32_t pos, wrap_pos, spill, slot_size;
+
+    int32_t result = radar_data_manager_take_slot(manager, subscription_id, &pos, &wrap_pos, &spill, &slot_size);
+
+    if (result != 0)
+    {
+        return result;
     }
 
-    if (NULL != manager.subscriptions[subscription_id].suscriber_task_handle)
+    *data_ptr = (uint16_t*) radar_data_manager_slot(manager, pos, slot_size, wrap_pos, spill);
+
+    *size = slot_size;
+
+    return 0;
+}
+
+/*
+ * read from RDM data buffer as up to two spans, without copying
+ */
+static int32_t
+radar_data_manager_read_spans(manager_state_s *manager, int32_t subscription_id, radar_data_span_s spans[2])
+{
+    uint32_t pos, wrap_pos, spill, slot_size;
+
+    if (NULL == spans)
     {
-        *data_ptr = (uint16_t*) (manager.buffer + manager.head);
+        return -1;
+    }
 
-        *size = (manager.fill_level);
+    int32_t result = radar_data_manager_take_slot(manager, subscription_id, &pos, &wrap_pos, &spill, &slot_size);
 
+    if (result != 0)
+    {
+        return result;
     }
-    else
+
+    spans[0].data = radar_data_manager_locate(manager, pos, slot_size, wrap_pos, spill,
+            &spans[0].size);
+    spans[1].data = NULL;
+    spans[1].size = 0;
+
+    if (spans[0].size < slot_size)
     {
-        return -2;
+        spans[1].data = radar_data_manager_locate(manager, pos + spans[0].size,
+                slot_size - spans[0].size, wrap_pos, spill, &spans[1].size);
     }
 
     return 0;
@@ -409,33 +869,96 @@ radar_data_manager_read_buffer(int32_t subscription_id, uint16_t **data_ptr, uin
 /*
  * acknowledge the data read
  */
-void
-radar_data_manager_ack_data_read(int32_t subscription_id)
+static void
+radar_data_manager_ack_data_read(manager_state_s *manager, int32_t subscription_id)
 {
     if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB))
     {
         return;
     }
 
-    manager.subscriptions[subscription_id].data_read = true;
+    subscribers_task_lists_s *subscriber = &manager->subscriptions[subscription_id];
+
+    RDM_ENTER_CRITICAL();
+    if (subscriber->reading)
+    {
+        //the slot is consumed, move on to the next one
+        subscriber->cursor += subscriber->slot_size;
+        subscriber->reading = false;
+        subscriber->stats.slots_read++;
+    }
+    RDM_EXIT_CRITICAL();
 
 }
 
+/*
+ * set the overflow policy of a subscriber
+ */
+static int32_t
+radar_data_manager_set_policy(manager_state_s *manager, int32_t subscription_id, radar_data_policy_e policy)
+{
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) ||
+        ((policy != RDM_POLICY_BLOCK) && (policy != RDM_POLICY_OVERWRITE_OLDEST)))
+    {
+        return -1;
+    }
+
+    if (NULL == manager->subscriptions[subscription_id].suscriber_task_handle)
+    {
+        return -2;
+    }
+
+    manager->subscriptions[subscription_id].policy = policy;
+
+    return 0;
+}
+
+/*
+ * get the statistics of a subscriber
+ */
+static int32_t
+radar_data_manager_get_stats(manager_state_s *manager, int32_t subscription_id, radar_data_subscriber_stats_s *stats)
+{
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (NULL == stats))
+    {
+        return -1;
+    }
+
+    subscribers_task_lists_s *subscriber = &manager->subscriptions[subscription_id];
+
+    if (NULL == subscriber->suscriber_task_handle)
+    {
+        return -2;
+    }
+
+    RDM_ENTER_CRITICAL();
+    *stats = subscriber->stats;
+    stats->lag = manager->tail - subscriber->cursor;
+    if ((int32_t)stats->lag < 0)
+    {
+        stats->lag = 0;
+    }
+    RDM_EXIT_CRITICAL();
+
+    return 0;
+}
+
 #endif
 
 
 /*
  * set RDM buffer fill level
  */
-int32_t radar_data_manager_set_fill_level(int32_t fill_level)
+static int32_t radar_data_manager_set_fill_level(manager_state_s *manager, int32_t fill_level)
 {
-    if ((0 == fill_level) ||
-        (fill_level > manager.buff_size))
+    if ((0 >= fill_level) ||
+        ((uint32_t)fill_level > manager->slack) ||
+        ((uint32_t)fill_level > (manager->depth / 2)))
     {
         return -1;
     }
 
-    manager.fill_level = fill_level;
+    manager->fill_level = fill_level;
 
     return 0;
 
@@ -444,9 +967,87 @@ int32_t radar_data_manager_set_fill_level(int32_t fill_level)
 /*
  * get RDM buffer fill level
  */
-int32_t radar_data_manager_get_fill_level(void)
+static int32_t radar_data_manager_get_fill_level(manager_state_s *manager)
+{
+    return manager->fill_level;
+}
+
+/*
+ * count an event reported by the owner of the RDM
+ */
+static void radar_data_manager_report(manager_state_s *manager, radar_data_event_e event)
 {
-    return manager.fill_level;
+    switch (event)
+    {
+        case RDM_EVENT_FIFO_RESET:
+            manager->stats.fifo_resets++;
+            break;
+        case RDM_EVENT_OVERRUN:
+            manager->stats.overruns++;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * get the readout and overflow statistics
+ */
+static void radar_data_manager_get_buffer_stats(manager_state_s *manager, radar_data_manager_stats_s *stats)
+{
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    RDM_ENTER_CRITICAL();
+    *stats = manager->stats;
+    stats->fill_level = manager->fill_level;
+    stats->depth = manager->depth;
+    RDM_EXIT_CRITICAL();
+}
+
+/*
+ * configure the fill level and depth controller
+ */
+static int32_t radar_data_manager_set_adaptive(manager_state_s *manager, const radar_data_adaptive_cfg_s *cfg)
+{
+    if (NULL == cfg)
+    {
+        //off: back to the full ring, the fill level stays where it is
+        RDM_ENTER_CRITICAL();
+        manager->adaptive.period = 0;
+        manager->depth = manager->buff_size;
+        RDM_EXIT_CRITICAL();
+        return 0;
+    }
+
+    if ((0 == cfg->period) || (0 == cfg->min_fill_level) ||
+        (cfg->min_fill_level > cfg->max_fill_level) ||
+        (cfg->max_fill_level > manager->slack) ||
+        ((cfg->max_fill_level > cfg->min_fill_level) && (0 == cfg->fill_step)) ||
+        (cfg->min_depth < (2 * cfg->max_fill_level)) ||
+        (cfg->min_depth > manager->buff_size))
+    {
+        return -1;
+    }
+
+    RDM_ENTER_CRITICAL();
+    manager->adaptive = *cfg;
+    manager->adaptive_readouts = 0;
+    manager->adaptive_lag = 0;
+    manager->adaptive_buffer_full = manager->stats.buffer_full;
+    if (manager->fill_level < cfg->min_fill_level)
+    {
+        manager->fill_level = cfg->min_fill_level;
+    }
+    if (manager->fill_level > cfg->max_fill_level)
+    {
+        manager->fill_level = cfg->max_fill_level;
+    }
+    RDM_EXIT_CRITICAL();
+
+    return 0;
 }
 
 /*
@@ -456,76 +1057,305 @@ void radar_data_manager_set_malloc_free(void* (*malloc_func)(size_t size),
         void (* free_func)(void* ptr))
 {
 
-    manager.malloc_func = malloc_func;
+    rdm_malloc_func = malloc_func;
+
+    rdm_free_func =  free_func;
+
+}
+
+
+/*
+ * The provided interfaces take no instance argument. Every entry n of the pool
+ * therefore gets its own set of trampolines rdm_<n>_*, which call the
+ * implementation with &managers[n], and rdm_<n>_bind() that populates an
+ * interface instance with them.
+ */
+#ifdef FREERTOS_AWARE
+#define RDM_TRAMPOLINES_RTOS(n) \
+static int32_t rdm_##n##_subscribe(TaskHandle_t subscriber_task) \
+{ return radar_data_manager_subscribe(&managers[n], subscriber_task); } \
+static void rdm_##n##_run(bool run_from_isr) \
+{ radar_data_manager_run(&managers[n], run_from_isr); } \
+static int32_t rdm_##n##_read_buffer(int32_t subscription_id, uint16_t **data_ptr, uint32_t *size) \
+{ return radar_data_manager_read_buffer(&managers[n], subscription_id, data_ptr, size); } \
+static int32_t rdm_##n##_read_spans(int32_t subscription_id, radar_data_span_s spans[2]) \
+{ return radar_data_manager_read_spans(&managers[n], subscription_id, spans); } \
+static void rdm_##n##_ack_data_read(int32_t subscription_id) \
+{ radar_data_manager_ack_data_read(&managers[n], subscription_id); } \
+static int32_t rdm_##n##_set_policy(int32_t subscription_id, radar_data_policy_e policy) \
+{ return radar_data_manager_set_policy(&managers[n], subscription_id, policy); } \
+static int32_t rdm_##n##_get_stats(int32_t subscription_id, radar_data_subscriber_stats_s *stats) \
+{ return radar_data_manager_get_stats(&managers[n], subscription_id, stats); } \
+static int32_t rdm_##n##_reserve(uint8_t **data, uint32_t size) \
+{ return radar_data_manager_reserve(&managers[n], data, size); } \
+static void rdm_##n##_commit(uint32_t size, bool from_isr) \
+{ radar_data_manager_commit(&managers[n], size, from_isr); }
+
+#define RDM_BIND_RTOS(n) \
+    mgr_interface->read_from_buffer = rdm_##n##_read_buffer; \
+    mgr_interface->read_spans = rdm_##n##_read_spans; \
+    mgr_interface->set_policy = rdm_##n##_set_policy; \
+    mgr_interface->reserve = rdm_##n##_reserve; \
+    mgr_interface->commit = rdm_##n##_commit; \
+    mgr_interface->get_stats = rdm_##n##_get_stats; \
+    mgr_interface->ack_data_read = rdm_##n##_ack_data_read;
+#else
+#define RDM_TRAMPOLINES_RTOS(n) \
+static int32_t rdm_##n##_subscribe(cb_radar_data_event cb) \
+{ return radar_data_manager_subscribe(&managers[n], cb); } \
+static void rdm_##n##_run(void) \
+{ radar_data_manager_run(&managers[n]); }
+
+#define RDM_BIND_RTOS(n)
+#endif
+
+#define RDM_TRAMPOLINES(n) \
+RDM_TRAMPOLINES_RTOS(n) \
+static void rdm_##n##_unsubscribe(int32_t subscription_id) \
+{ radar_data_manager_unsubscribe(&managers[n], subscription_id); } \
+static int32_t rdm_##n##_set_fill_level(int32_t fill_level) \
+{ return radar_data_manager_set_fill_level(&managers[n], fill_level); } \
+static int32_t rdm_##n##_get_fill_level(void) \
+{ return radar_data_manager_get_fill_level(&managers[n]); } \
+static void rdm_##n##_report(radar_data_event_e event) \
+{ radar_data_manager_report(&managers[n], event); } \
+static void rdm_##n##_get_buffer_stats(radar_data_manager_stats_s *stats) \
+{ radar_data_manager_get_buffer_stats(&managers[n], stats); } \
+static int32_t rdm_##n##_set_adaptive(const radar_data_adaptive_cfg_s *cfg) \
+{ return radar_data_manager_set_adaptive(&managers[n], cfg); } \
+static void rdm_##n##_bind(radar_data_manager_s *mgr_interface) \
+{ \
+    mgr_interface->subscribe = rdm_##n##_subscribe; \
+    mgr_interface->unsubscribe = rdm_##n##_unsubscribe; \
+    mgr_interface->run = rdm_##n##_run; \
+    mgr_interface->set_fill_level = rdm_##n##_set_fill_level; \
+    mgr_interface->get_fill_level = rdm_##n##_get_fill_level; \
+    mgr_interface->report = rdm_##n##_report; \
+    mgr_interface->get_buffer_stats = rdm_##n##_get_buffer_stats; \
+    mgr_interface->set_adaptive = rdm_##n##_set_adaptive; \
+    RDM_BIND_RTOS(n) \
+}
+
+RDM_TRAMPOLINES(0)
+#if RDM_MAX_INSTANCES > 1
+RDM_TRAMPOLINES(1)
+#endif
+#if RDM_MAX_INSTANCES > 2
+RDM_TRAMPOLINES(2)
+#endif
+#if RDM_MAX_INSTANCES > 3
+RDM_TRAMPOLINES(3)
+#endif
+#if RDM_MAX_INSTANCES > 4
+RDM_TRAMPOLINES(4)
+#endif
+#if RDM_MAX_INSTANCES > 5
+RDM_TRAMPOLINES(5)
+#endif
+#if RDM_MAX_INSTANCES > 6
+RDM_TRAMPOLINES(6)
+#endif
+#if RDM_MAX_INSTANCES > 7
+RDM_TRAMPOLINES(7)
+#endif
+
+/*Interface binding of every pool entry*/
+static void (* const rdm_bind[RDM_MAX_INSTANCES])(radar_data_manager_s *mgr_interface) =
+{
+    rdm_0_bind,
+#if RDM_MAX_INSTANCES > 1
+    rdm_1_bind,
+#endif
+#if RDM_MAX_INSTANCES > 2
+    rdm_2_bind,
+#endif
+#if RDM_MAX_INSTANCES > 3
+    rdm_3_bind,
+#endif
+#if RDM_MAX_INSTANCES > 4
+    rdm_4_bind,
+#endif
+#if RDM_MAX_INSTANCES > 5
+    rdm_5_bind,
+#endif
+#if RDM_MAX_INSTANCES > 6
+    rdm_6_bind,
+#endif
+#if RDM_MAX_INSTANCES > 7
+    rdm_7_bind,
+#endif
+};
+
+
+/*
+ * pool entry bound to mgr_interface, NULL if there is none
+ */
+static manager_state_s*
+radar_data_manager_find(radar_data_manager_s* mgr_interface)
+{
+    for (int i = 0; i < RDM_MAX_INSTANCES; i++)
+    {
+        if (managers[i].interface == mgr_interface)
+        {
+            return &managers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * claim a free pool entry for mgr_interface. Returns NULL if mgr_interface is
+ * already initialized or all entries are in use
+ */
+static manager_state_s*
+radar_data_manager_claim(radar_data_manager_s* mgr_interface)
+{
+    manager_state_s *manager = NULL;
+
+    RDM_ENTER_CRITICAL();
+    if (NULL == radar_data_manager_find(mgr_interface))
+    {
+        manager = radar_data_manager_find(NULL);
 
-    manager.free_func =  free_func;
+        if (NULL != manager)
+        {
+            manager->interface = mgr_interface;
+        }
+    }
+    RDM_EXIT_CRITICAL();
 
+    return manager;
 }
 
 
+/*
+ * reset the state around the buffer in manager->buffer and bind the provided
+ * interfaces to it
+ */
+static void
+radar_data_manager_start(manager_state_s *manager, uint32_t ring_size, uint32_t fill_level)
+{
+    manager->fill_level = fill_level;
+
+    manager->buff_size = ring_size;
+
+    manager->mask = ring_size - 1;
+
+    manager->depth = ring_size;
+
+    memset(&manager->stats, 0, sizeof(manager->stats));
+
+    memset(&manager->adaptive, 0, sizeof(manager->adaptive));
+
+    manager->slack = fill_level;
+
+    manager->samples = 0;
+
+    manager->subscribers = 0;
+
+    manager->head = 0;
+    manager->tail = 0;
+
+    manager->wrap_pos = 0;
+    manager->spill = 0;
+
+    rdm_bind[manager - managers](manager->interface);
+}
+
 /*
  * Initialize the RDM
  */
 int32_t
 radar_data_manager_init(radar_data_manager_s* mgr_interface, uint32_t buffer_size, uint32_t fill_level)
 {
-    //first check if RDM is already initialized
-    if (NULL != manager.buffer)
+    if ((NULL == mgr_interface) || (0 == buffer_size) || (0 == fill_level))
     {
-        return -2;
+        return -1;
     }
 
-    if ((NULL == mgr_interface) || (0 == buffer_size) || (0 == fill_level) ||
-        (fill_level > buffer_size))
+    //the ring is the largest power of two within buffer_size, it must hold
+    //one slot being written while the previous one is read
+    uint32_t ring_size = radar_data_manager_floor_pow2(buffer_size);
+
+    if (fill_level > (ring_size / 2))
     {
         return -1;
     }
 
+    //first check if this RDM is already initialized, and take a free instance
+    manager_state_s *manager = radar_data_manager_claim(mgr_interface);
+
+    if (NULL == manager)
+    {
+        return -2;
+    }
+
     //Allocate buffer.
-    if ((NULL == manager.malloc_func) || (NULL == manager.free_func))
+    if ((NULL == rdm_malloc_func) || (NULL == rdm_free_func))
     {
-        manager.malloc_func = malloc;
-        manager.free_func =  free;
+        rdm_malloc_func = malloc;
+        rdm_free_func =  free;
     }
 
-    manager.buffer = (uint8_t*) manager.malloc_func(buffer_size);
+    //one slot of slack behind the ring keeps every write contiguous
+    manager->buffer = (uint8_t*) rdm_malloc_func(ring_size + fill_level);
 
-    if (NULL == manager.buffer)
+    if (NULL == manager->buffer)
     {
+        manager->interface = NULL;
         return -2;
     }
 
-    //reset the buffer
-    memset((void*)manager.buffer,0,buffer_size);
+    manager->free_func = rdm_free_func;
 
-    manager.fill_level = fill_level;
+    //reset the buffer
+    memset((void*)manager->buffer,0,ring_size + fill_level);
 
-    manager.buff_size = buffer_size;
+    manager->static_buffer = false;
 
-    manager.samples = 0;
+    radar_data_manager_start(manager, ring_size, fill_level);
 
-    manager.subscribers = 0;
+    return 0;
+}
 
-    manager.head = 0;
-    manager.tail = 0;
 
-    mgr_interface->subscribe = radar_data_manager_subscribe;
+/*
+ * Initialize the RDM on caller provided storage
+ */
+int32_t
+radar_data_manager_init_static(radar_data_manager_s* mgr_interface, uint8_t *storage,
+                               uint32_t storage_size, uint32_t fill_level)
+{
+    if ((NULL == mgr_interface) || (NULL == storage) || (0 == fill_level) ||
+        (storage_size <= fill_level) ||
+        (0 != ((uintptr_t)storage & (RDM_STORAGE_ALIGN - 1))))
+    {
+        return -1;
+    }
 
-    mgr_interface->unsubscribe = radar_data_manager_unsubscribe;
+    //the storage holds the ring followed by one slot of slack
+    uint32_t ring_size = radar_data_manager_floor_pow2(storage_size - fill_level);
 
-    mgr_interface->run = radar_data_manager_run;
+    if (fill_level > (ring_size / 2))
+    {
+        return -1;
+    }
 
-    mgr_interface->set_fill_level = radar_data_manager_set_fill_level;
+    //first check if this RDM is already initialized, and take a free instance
+    manager_state_s *manager = radar_data_manager_claim(mgr_interface);
 
-    mgr_interface->get_fill_level = radar_data_manager_get_fill_level;
+    if (NULL == manager)
+    {
+        return -2;
+    }
 
-#ifdef FREERTOS_AWARE
-    mgr_interface->read_from_buffer = radar_data_manager_read_buffer;
+    //no reset needed, every byte is written by the radar before it is read
+    manager->buffer = storage;
 
-    mgr_interface->ack_data_read = radar_data_manager_ack_data_read;
-#endif
+    manager->static_buffer = true;
 
-    manager_interface = mgr_interface;
+    radar_data_manager_start(manager, ring_size, fill_level);
 
     return 0;
 }
@@ -534,18 +1364,31 @@ radar_data_manager_init(radar_data_manager_s* mgr_interface, uint32_t buffer_siz
 /*
  * Free RDM
  */
-int32_t radar_data_manager_deinit()
+int32_t radar_data_manager_deinit(radar_data_manager_s* mgr_interface)
 {
+    if (NULL == mgr_interface)
+    {
+        return -1;
+    }
+
+    manager_state_s *manager = radar_data_manager_find(mgr_interface);
 
     //make sure no active subscriptions exist
-    if ((manager.subscribers > 0) || (manager.buffer == NULL))
+    if ((NULL == manager) || (manager->subscribers > 0))
     {
         return -2;
     }
 
-    manager.free_func(manager.buffer);
+    if (!manager->static_buffer)
+    {
+        manager->free_func(manager->buffer);
+    }
 
-    memset(&manager, 0, sizeof(manager_state_s));
+    //the entry is free again once interface is cleared, a concurrent
+    //radar_data_manager_init must not claim it half way through
+    RDM_ENTER_CRITICAL();
+    memset(manager, 0, sizeof(manager_state_s));
+    RDM_EXIT_CRITICAL();
     return 0;
 }
 
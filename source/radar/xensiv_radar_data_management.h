@@ -62,6 +62,42 @@
  */
 #define ACTIVE_SUBSCRIPTION_UB 4
 
+/*
+ * @def RDM_MAX_INSTANCES
+ * Maximum number of radar data managers that are initialized at the same time,
+ * e.g. one per radar front-end or recorded stream (1..8)
+ */
+#ifndef RDM_MAX_INSTANCES
+#define RDM_MAX_INSTANCES 2
+#endif
+
+
+/*
+ * @def RDM_STORAGE_ALIGN
+ * Required alignment in bytes of the storage given to \ref radar_data_manager_init_static,
+ * enough for word wide DMA transfers and a cache line
+ */
+#define RDM_STORAGE_ALIGN 32U
+
+/*
+ * @def RDM_POW2_CEIL(x)
+ * Smallest power of two not below x (x > 0), usable in constant expressions
+ */
+#define RDM_SMEAR1_(v) ((v) | ((v) >> 1))
+#define RDM_SMEAR2_(v) (RDM_SMEAR1_(v) | (RDM_SMEAR1_(v) >> 2))
+#define RDM_SMEAR4_(v) (RDM_SMEAR2_(v) | (RDM_SMEAR2_(v) >> 4))
+#define RDM_SMEAR8_(v) (RDM_SMEAR4_(v) | (RDM_SMEAR4_(v) >> 8))
+#define RDM_SMEAR16_(v) (RDM_SMEAR8_(v) | (RDM_SMEAR8_(v) >> 16))
+#define RDM_POW2_CEIL(x) (RDM_SMEAR16_((uint32_t)(x) - 1U) + 1U)
+
+/*
+ * @def RDM_STORAGE_SIZE(fill_level, slots)
+ * Bytes of storage for \ref radar_data_manager_init_static holding at least slots
+ * slots of fill_level bytes (slots >= 2): the power of two ring plus one slot of slack
+ */
+#define RDM_STORAGE_SIZE(fill_level, slots) \
+    (RDM_POW2_CEIL((uint32_t)(fill_level) * (uint32_t)(slots)) + (uint32_t)(fill_level))
+
 
 /*
  * @def enum radar_data_manager_err_codes_e
@@ -74,7 +110,8 @@ typedef enum
 {
     RDM_SUCCESS =0, /*<<is returned when call is successful*/
     RDM_EPARAM_INVALID = -1, /*<< is returned when parameter values passed is not correct/out of bound etc.*/
-    RDM_EOP_CANNOT_COMPLETE = -2 /*is returned interface cannot complete the requested operation<<*/
+    RDM_EOP_CANNOT_COMPLETE = -2, /*is returned interface cannot complete the requested operation<<*/
+    RDM_EIO = -3 /*<< is returned by <b>in_read_radar_data</b> when the radar device could not be read*/
 
 }radar_data_manager_err_codes_e;
 
@@ -87,6 +124,91 @@ typedef enum
 typedef void (*cb_radar_data_event)(void* data_ptr, uint32_t size);
 
 
+/*
+ * @def enum radar_data_policy_e
+ * What happens when a subscriber falls a full buffer behind the radar data.
+ * Every subscriber reads the shared buffer through its own cursor.
+ */
+typedef enum
+{
+    RDM_POLICY_BLOCK = 0, /*<< no data is overwritten before the subscriber read it, new radar data is dropped instead (default)*/
+    RDM_POLICY_OVERWRITE_OLDEST = 1 /*<< the oldest unread slots of the subscriber are overwritten, other subscribers are never held up*/
+
+}radar_data_policy_e;
+
+
+/*
+ * @typedef typedef struct radar_data_subscriber_stats_s
+ * Per subscriber statistics, see \ref get_stats.
+ */
+typedef struct {
+    uint32_t lag; /*<< Bytes written but not yet read by the subscriber */
+    uint32_t lag_hwm; /*<< Highest lag seen so far in bytes */
+    uint32_t drops; /*<< Slots overwritten before the subscriber read them (RDM_POLICY_OVERWRITE_OLDEST) */
+    uint32_t stalls; /*<< Radar readouts lost because this subscriber held the oldest data of a full buffer */
+    uint32_t slots_read; /*<< Slots read and acknowledged */
+}radar_data_subscriber_stats_s;
+
+
+/*
+ * @def enum radar_data_event_e
+ * Events detected by the owner of the RDM, see \ref report.
+ */
+typedef enum
+{
+    RDM_EVENT_FIFO_RESET = 0, /*<< the content of the radar FIFO was dropped*/
+    RDM_EVENT_OVERRUN = 1 /*<< radar data was lost before it reached the RDM, e.g. a readout came too late*/
+
+}radar_data_event_e;
+
+
+/*
+ * @typedef typedef struct radar_data_manager_stats_s
+ * Readout and overflow statistics of the RDM, see \ref get_buffer_stats.
+ */
+typedef struct {
+    uint32_t readouts; /*<< Readouts stored in the buffer */
+    uint32_t short_reads; /*<< Readouts smaller than the fill level */
+    uint32_t read_errors; /*<< Readouts that failed, or returned more than the allowed number of bytes */
+    uint32_t buffer_full; /*<< Readouts dropped because the buffer had no room */
+    uint32_t fifo_resets; /*<< Reported RDM_EVENT_FIFO_RESET events */
+    uint32_t overruns; /*<< Reported RDM_EVENT_OVERRUN events */
+    uint32_t adaptations; /*<< Changes of fill level or depth made by the controller */
+    uint32_t fill_level; /*<< Current fill level in bytes */
+    uint32_t depth; /*<< Current depth in bytes: how far the writer may run ahead of the readers */
+}radar_data_manager_stats_s;
+
+
+/*
+ * @typedef typedef struct radar_data_adaptive_cfg_s
+ * Configuration of the optional fill level and depth controller, see \ref set_adaptive.
+ * Every period readouts the controller looks at the highest lag of the subscribers:
+ * the depth follows it plus margin_slots (and grows after the buffer ran full), the
+ * fill level grows by fill_step while a subscriber is two or more slots behind and
+ * shrinks back once all of them keep up.
+ * @note fill_step should be a multiple of the readout size so that slots stay aligned
+ *       with the readouts, and the subscribers must accept any slot size in range.
+ */
+typedef struct {
+    uint32_t min_fill_level; /*<< Smallest fill level in bytes */
+    uint32_t max_fill_level; /*<< Largest fill level in bytes, at most the fill level given at init. Equal to min_fill_level keeps it fixed */
+    uint32_t fill_step; /*<< Fill level change in bytes */
+    uint32_t min_depth; /*<< Smallest depth in bytes, at least twice max_fill_level */
+    uint32_t margin_slots; /*<< Slots of depth kept above the observed lag */
+    uint32_t period; /*<< Readouts per controller step */
+}radar_data_adaptive_cfg_s;
+
+
+/*
+ * @typedef typedef struct radar_data_span_s
+ * A contiguous piece of buffered radar data, see \ref read_spans.
+ */
+typedef struct {
+    uint8_t *data; /*<< Start of the span inside the RDM buffer */
+    uint32_t size; /*<< Number of bytes in the span, 0 for an unused span */
+}radar_data_span_s;
+
+
 /*
  * @typedef typedef struct  radar_data_manager_s
  * Radar Data Manager (RDM) interface .
@@ -110,7 +232,10 @@ typedef struct {
  *
  * @return function shall return zero (0) on successful completion of the readout of data.
  *         in case the parameters supplied are not valid it shall return -1 and in case if
- *         operation cannot be complete it shall return -2
+ *         operation cannot be complete it shall return -2. If reading the radar device
+ *         fails it shall return -3 (\ref RDM_EIO)
+ * @note Returning -2 because <b>samples_ub</b> leaves no room for the data is counted as
+ *       buffer full, any other failure as read error.
  */
 int32_t (*in_read_radar_data) (uint16_t* data, uint32_t *num_samples, uint32_t samples_ub);
 
@@ -144,6 +269,9 @@ int32_t (*subscribe)(TaskHandle_t subscriber_task);
  * @param[in] subscription_id subscription id of the subscriber. This ID is provided by RDM on successful subscription
  * @param[out] data_ptr pointer to the internal buffer where the data has to be read from subscriber task
  * @param[out] size number of bytes that are available to read
+ * @note The <b>fill_level</b> bytes at data_ptr are always contiguous. If the writer
+ *       wrapped around the ring in the middle of them, the wrapped part is copied
+ *       behind the rest in the caller's context.
  *
  * @return function shall return zero (0) on successful completion of the readout of data.
  *         in case the parameters supplied are not valid it shall return -1 and in case if
@@ -151,12 +279,54 @@ int32_t (*subscribe)(TaskHandle_t subscriber_task);
  */
 int32_t (*read_from_buffer)(int32_t subscription_id, uint16_t **data_ptr, uint32_t *size);
 
+/** @brief Provided interface:Read radar data from buffer without copying
+ *
+ * Same as <b>read_from_buffer</b>, but the <b>fill_level</b> bytes are returned in place
+ * as at most two spans: spans[0] and, if the data wraps around the ring, spans[1].
+ * Nothing is ever copied.
+ *
+ * @param[in] subscription_id subscription id of the subscriber
+ * @param[out] spans the two spans, spans[1].size is zero if the data is contiguous
+ *
+ * @return function shall return zero (0) on successful completion of the readout of data.
+ *         in case the parameters supplied are not valid it shall return -1 and in case if
+ *         operation cannot be complete it shall return -2
+ */
+int32_t (*read_spans)(int32_t subscription_id, radar_data_span_s spans[2]);
+
+/** @brief Provided interface:Set the overflow policy of a subscriber
+ *
+ * With \ref RDM_POLICY_BLOCK (the default) a slow subscriber holds up the radar data of all
+ * subscribers. A subscriber that can afford to lose data, e.g. a recorder, should use
+ * \ref RDM_POLICY_OVERWRITE_OLDEST so it never stalls the others.
+ *
+ * @param[in] subscription_id subscription id of the subscriber
+ * @param[in] policy the new policy
+ *
+ * @return function shall return zero (0) on success.
+ *         in case the parameters supplied are not valid it shall return -1 and in case if
+ *         there is no such subscription it shall return -2
+ */
+int32_t (*set_policy)(int32_t subscription_id, radar_data_policy_e policy);
+
+/** @brief Provided interface:Get the statistics of a subscriber
+ *
+ * @param[in] subscription_id subscription id of the subscriber
+ * @param[out] stats current lag, lag high-water mark, drop, stall and read counters
+ *
+ * @return function shall return zero (0) on success.
+ *         in case the parameters supplied are not valid it shall return -1 and in case if
+ *         there is no such subscription it shall return -2
+ */
+int32_t (*get_stats)(int32_t subscription_id, radar_data_subscriber_stats_s *stats);
+
 /** @brief Provided interface:Acknowledge to RDM that the subscriber has read the data from buffer
  *
  * Subscriber task shall notify RDM by calling this function, that it has finished reading the data from buffer
- * Once all subscribers finish reading data, RDM would then manage the internal queue accordingly.
- * @note The old data in the buffer will persist until all subscribers acknowledge their respective data reads
- *          However on arrival of new data
+ * Every subscriber has its own read cursor, the acknowledgement moves it on to the next slot.
+ * The space is reused once no subscriber needs the data any more.
+ * @note Until it is acknowledged, a slot returned by <b>read_from_buffer</b> or <b>read_spans</b>
+ *          is never overwritten, whatever the policy of the subscriber
  * @param[in] subscription_id subscribers' identifier
  *
  * @return Nothing
@@ -176,6 +346,34 @@ void (*ack_data_read)(int32_t subscription_id);
  * @return Nothing
  */
 void (*run)(bool run_from_isr);
+
+/** @brief Provided interface:Reserve buffer space for an asynchronous write
+ *
+ * Alternative to <b>run</b> for an owner that fills the buffer itself, e.g. by DMA.
+ * The returned region is contiguous and stays reserved until <b>commit</b>. Slots of
+ * overwrite-oldest subscribers in the region are dropped right away.
+ * Only one write may be outstanding at a time.
+ *
+ * @param[out] data start of the region to be written
+ * @param[in] size number of bytes to be written
+ *
+ * @return function shall return zero (0) on success.
+ *         in case the parameters supplied are not valid it shall return -1 and in case if
+ *         there is not enough free space it shall return -2
+ */
+int32_t (*reserve)(uint8_t **data, uint32_t size);
+
+/** @brief Provided interface:Complete an asynchronous write
+ *
+ * Makes the <b>size</b> bytes written to the region returned by <b>reserve</b> available
+ * and notifies the subscribers, like <b>run</b> does after a read.
+ *
+ * @param[in] size number of bytes written, at most the reserved size
+ * @param[in] from_isr to be set to true if this function is being called from ISR, false otherwise.
+ *
+ * @return Nothing
+ */
+void (*commit)(uint32_t size, bool from_isr);
 #else
 /** @brief Provided interface:Subscribe to radar data buffer
  *
@@ -230,7 +428,8 @@ void (*unsubscribe)(int32_t subscription_id);
 
 /** @brief Provided interface:set fill level for radar data buffer
  *
- * The radar data fill level can be set to a value between 1 to buffer size.
+ * The radar data fill level can be set to a value between 1 and the fill level given
+ * to \ref radar_data_manager_init, and at most half the depth.
  *
  * @param[in] fill_level value for buffer fill level
  *
@@ -249,6 +448,37 @@ int32_t (*set_fill_level)(int32_t fill_level);
  */
 int32_t (*get_fill_level)(void);
 
+/** @brief Provided interface:Report an event detected by the owner
+ *
+ * The owner of the RDM shall report data it loses outside of the RDM, e.g. when
+ * <b>in_read_radar_data</b> resets the radar FIFO. May be called from ISR.
+ *
+ * @param[in] event the event to be counted
+ *
+ * @return Nothing
+ */
+void (*report)(radar_data_event_e event);
+
+/** @brief Provided interface:Get the readout and overflow statistics
+ *
+ * @param[out] stats counters since init, and the current fill level and depth
+ *
+ * @return Nothing
+ */
+void (*get_buffer_stats)(radar_data_manager_stats_s *stats);
+
+/** @brief Provided interface:Configure the fill level and depth controller
+ *
+ * The controller is off after init: the fill level only changes with <b>set_fill_level</b>
+ * and the whole buffer is used.
+ *
+ * @param[in] cfg controller configuration, NULL switches the controller off and restores the full depth
+ *
+ * @return function shall return zero (0) on success.
+ *         in case the configuration is not valid it shall return -1
+ */
+int32_t (*set_adaptive)(const radar_data_adaptive_cfg_s *cfg);
+
 }radar_data_manager_s;
 
 
@@ -278,30 +508,63 @@ void radar_data_manager_set_malloc_free(void* (*malloc_func)(size_t size),
  * This function initializes RDM, and allows consumer to control fill level of the buffer
  * and size of the buffer in bytes. Also, it populates the provided interfaces through manager interface instance
  * and expects the provision of expected interfaces during the initialization.
+ * Every manager interface instance gets its own state, up to \ref RDM_MAX_INSTANCES of them
+ * can be initialized at the same time. The populated interfaces only operate on that state.
  *
  * @param[in,out] manager manager interface type.
- * @param[in] buffer_size size of the buffer to be allocated by RDM in bytes
+ * @param[in] buffer_size size of the buffer in bytes. The ring uses the largest power of two
+ *   within buffer_size, and fill_level bytes are allocated behind it so that the radar data
+ *   is always written contiguously.
  * @param[in] fill_level amount of data to be filled in buffer before RDM issues notifications
- *   to its consumer
+ *   to its consumer, at most half the ring size
  *
  * @return function shall return zero (0) on successful completion of the readout of data.
  *         in case the parameters supplied are not valid it shall return -1 and in case if
- *         operation cannot be complete it shall return -2
+ *         operation cannot be complete (manager already initialized, all \ref RDM_MAX_INSTANCES
+ *         in use or out of memory) it shall return -2
  *
  */
 int32_t radar_data_manager_init(radar_data_manager_s* const manager, uint32_t buffer_size, uint32_t fill_level);
 
 
+/** @brief Initialize radar data manager on caller provided storage
+ *
+ * Same as \ref radar_data_manager_init, but the buffer is supplied by the caller instead of
+ * being allocated, so it can be sized at compile time with \ref RDM_STORAGE_SIZE and placed
+ * in a specific memory section. The storage is not cleared and not freed by \ref radar_data_manager_deinit.
+ *
+ * @param[in,out] manager manager interface type.
+ * @param[in] storage buffer of storage_size bytes aligned to \ref RDM_STORAGE_ALIGN, it must stay
+ *   valid until \ref radar_data_manager_deinit
+ * @param[in] storage_size size of the storage in bytes. The ring uses the largest power of two
+ *   within storage_size - fill_level, the remaining bytes behind it are slack.
+ * @param[in] fill_level amount of data to be filled in buffer before RDM issues notifications
+ *   to its consumer, at most half the ring size
+ *
+ * @return function shall return zero (0) on successful initialization,
+ *         in case the parameters supplied are not valid it shall return -1 and in case
+ *         the manager is already initialized or all \ref RDM_MAX_INSTANCES are in use
+ *         it shall return -2
+ *
+ */
+int32_t radar_data_manager_init_static(radar_data_manager_s* const manager, uint8_t *storage,
+                                       uint32_t storage_size, uint32_t fill_level);
+
+
 /** @brief De-initialize radar data manager
  *
  * This function de-initializes RDM. This causes the RDM to free the internal buffer
+ * (unless it was provided through \ref radar_data_manager_init_static)
  * and resetting the internal state of the RDM
  *
+ * @param[in,out] manager manager interface type, as passed to \ref radar_data_manager_init.
+ *   Its interfaces must not be used any more afterwards
+ *
  * @return function shall return zero (0) on successful completion of the readout of data.
  *         in case the parameters supplied are not valid it shall return -1 and in case if
  *         operation cannot be complete it shall return -2
  *
  */
-int32_t radar_data_manager_deinit();
+int32_t radar_data_manager_deinit(radar_data_manager_s* const manager);
 
 #endif
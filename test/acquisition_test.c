@@ -0,0 +1,517 @@
+/******************************************************************************
+* File Name:   acquisition_test.c
+*
+* Description: This file tests the asynchronous radar FIFO readout of
+*   radar_acquisition.c on the fake SPI/DMA backend of
+*   radar_acquisition_fake.c, feeding the radar data manager like radar.c
+*   does. It checks the order FIFO interrupt -> transfer -> commit ->
+*   subscriber notification, the queued, overrun, drop and error counters and
+*   the latency statistics against the simulated clock, and the unpack of
+*   the 12-bit samples by the subscribers.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "radar_acquisition.h"
+#include "xensiv_radar_data_management.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* One frame per readout, as radar.c without RADAR_CHIRP_STREAMING */
+#define SAMPLES_PER_READ    (3U * 32U * 64U)
+#define FILL_LEVEL          (SAMPLES_PER_READ * 2U)
+#define RDM_BUFFER_SIZE     (65536U)
+#define N_SUBSCRIBERS       (2)
+
+#define SPI_HZ              (12000000U)
+#define FRAME_PERIOD_NS     (30000000U)
+/* Packed 12-bit samples at SPI_HZ: 9216 bytes in 6.144 ms */
+#define TRANSFER_NS         ((uint32_t)(((uint64_t)SAMPLES_PER_READ * 3U / 2U * 8U * 1000000000U) / SPI_HZ))
+#define TRANSFER_US         (TRANSFER_NS / 1000U)
+
+#define MAX_EVENTS          (32)
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef enum {
+    EV_IRQ,
+    EV_RESERVE,
+    EV_COMMIT,
+    EV_NOTIFY,
+    EV_OVERRUN,
+    EV_FIFO_RESET
+} event_type;
+
+typedef struct {
+    event_type type;
+    uint32_t t_ns;
+    /* EV_RESERVE: result, EV_COMMIT/EV_NOTIFY: from ISR, EV_NOTIFY: task */
+    int32_t arg;
+    int32_t task;
+} event;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static radar_data_manager_s mgr;
+static radar_acquisition_backend_s fake_backend;
+static int32_t subscription[N_SUBSCRIBERS];
+/* Stand-ins for the subscriber task handles */
+static int subscriber_task[N_SUBSCRIBERS];
+/* Next sample counter value expected by each subscriber */
+static uint16_t expected_sample[N_SUBSCRIBERS];
+
+static event events[MAX_EVENTS];
+static uint32_t n_events;
+
+static uint32_t n_checks;
+static uint32_t n_failures;
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*   Counts a check and reports it if it failed.
+*
+*******************************************************************************/
+static void check(bool ok, const char *what, int line)
+{
+    n_checks++;
+    if (!ok)
+    {
+        n_failures++;
+        printf("FAIL line %d: %s\n", line, what);
+    }
+}
+
+static void log_event(event_type type, int32_t arg, int32_t task)
+{
+    if (n_events < MAX_EVENTS)
+    {
+        events[n_events].type = type;
+        events[n_events].t_ns = radar_acquisition_fake_now();
+        events[n_events].arg = arg;
+        events[n_events].task = task;
+    }
+    n_events++;
+}
+
+/*******************************************************************************
+* Sink, backend and RTOS hooks: log, then forward like radar.c
+********************************************************************************/
+static int32_t test_reserve(uint8_t **data, uint32_t size)
+{
+    int32_t result = mgr.reserve(data, size);
+    log_event(EV_RESERVE, result, -1);
+    return result;
+}
+
+static void test_commit(uint32_t size, bool from_isr)
+{
+    log_event(EV_COMMIT, from_isr, -1);
+    mgr.commit(size, from_isr);
+}
+
+static void test_overrun(void)
+{
+    log_event(EV_OVERRUN, 0, -1);
+    mgr.report(RDM_EVENT_OVERRUN);
+}
+
+static void test_reset_fifo(void *ctx)
+{
+    log_event(EV_FIFO_RESET, 0, -1);
+    fake_backend.reset_fifo(ctx);
+    mgr.report(RDM_EVENT_FIFO_RESET);
+}
+
+static void test_notify(TaskHandle_t task, bool from_isr)
+{
+    int32_t index = -1;
+
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        if (task == (TaskHandle_t)&subscriber_task[i])
+        {
+            index = i;
+        }
+    }
+    log_event(EV_NOTIFY, from_isr, index);
+}
+
+static void fifo_irq(void)
+{
+    log_event(EV_IRQ, 0, -1);
+    radar_acquisition_fifo_irq();
+}
+
+/*******************************************************************************
+* Function Name: drain
+********************************************************************************
+* Summary:
+*   Reads every available slot of every subscriber, unpacks it as radar_task
+*   does and checks that the samples continue the 12-bit counter of the fake
+*   sensor. Each subscriber unpacks to its own buffer, since they share the
+*   slots.
+*
+* Return:
+*  Number of slots read by the first subscriber.
+*
+*******************************************************************************/
+static uint32_t drain(void)
+{
+    static uint16_t samples[SAMPLES_PER_READ];
+    uint32_t slots = 0;
+
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        uint16_t *data;
+        uint32_t size;
+
+        while (mgr.read_from_buffer(subscription[i], &data, &size) == 0)
+        {
+            bool in_sequence = (size == FILL_LEVEL);
+
+            if (in_sequence)
+            {
+                radar_acquisition_unpack12((const uint8_t *)data, samples, SAMPLES_PER_READ);
+            }
+            for (uint32_t s = 0; in_sequence && (s < size / 2U); ++s)
+            {
+                in_sequence = (samples[s] == (uint16_t)((expected_sample[i] + s) & 0x0FFFU));
+            }
+            CHECK(in_sequence);
+            expected_sample[i] = (uint16_t)((expected_sample[i] + size / 2U) & 0x0FFFU);
+            mgr.ack_data_read(subscription[i]);
+            if (i == 0)
+            {
+                slots++;
+            }
+        }
+    }
+    return slots;
+}
+
+/* A completed readout: commit, then every subscriber notified from the ISR */
+static bool is_delivery(uint32_t first, uint32_t t_ns)
+{
+    bool ok = (n_events >= first + 1U + N_SUBSCRIBERS) &&
+              (events[first].type == EV_COMMIT) && (events[first].arg == 1) &&
+              (events[first].t_ns == t_ns);
+
+    for (uint32_t i = 0; ok && (i < N_SUBSCRIBERS); ++i)
+    {
+        const event *ev = &events[first + 1U + i];
+        ok = (ev->type == EV_NOTIFY) && (ev->arg == 1) && (ev->task == (int32_t)i) &&
+             (ev->t_ns == t_ns);
+    }
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: test_nominal
+********************************************************************************
+* Summary:
+*   One readout per frame: nothing is published before the transfer ends, then
+*   commit and notifications follow within the completion interrupt.
+*
+*******************************************************************************/
+static void test_nominal(void)
+{
+    radar_acquisition_stats_s stats;
+
+    for (uint32_t frame = 0; frame < 8; ++frame)
+    {
+        uint32_t t_irq = radar_acquisition_fake_now();
+
+        n_events = 0;
+        fifo_irq();
+        CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_TRANSFER);
+        CHECK((n_events == 2) && (events[0].type == EV_IRQ) &&
+              (events[1].type == EV_RESERVE) && (events[1].arg == 0));
+
+        radar_acquisition_fake_advance(TRANSFER_NS - 1U);
+        CHECK(n_events == 2);
+        CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_TRANSFER);
+
+        radar_acquisition_fake_advance(1U);
+        CHECK((n_events == 2U + 1U + N_SUBSCRIBERS) && is_delivery(2, t_irq + TRANSFER_NS));
+        CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_IDLE);
+
+        radar_acquisition_get_stats(&stats);
+        CHECK(stats.latency_last_us == TRANSFER_US);
+        CHECK(drain() == 1);
+
+        radar_acquisition_fake_advance(FRAME_PERIOD_NS - TRANSFER_NS);
+    }
+
+    radar_acquisition_get_stats(&stats);
+    CHECK(stats.transfers == 8);
+    CHECK((stats.queued == 0) && (stats.overruns == 0) && (stats.drops == 0) && (stats.errors == 0));
+    CHECK(stats.latency_max_us == TRANSFER_US);
+    /* The handlers take no simulated time */
+    CHECK(stats.isr_max_us == 0);
+}
+
+/*******************************************************************************
+* Function Name: test_queued_and_overrun
+********************************************************************************
+* Summary:
+*   A FIFO interrupt during a transfer is queued and served from the
+*   completion interrupt right after the notifications, its latency counts
+*   from its own interrupt. A third one is an overrun reported to the RDM.
+*
+*******************************************************************************/
+static void test_queued_and_overrun(void)
+{
+    const uint32_t queue_delay_ns = 1000000U;
+    radar_acquisition_stats_s before;
+    radar_acquisition_stats_s stats;
+    radar_data_manager_stats_s rdm_stats;
+    uint32_t t_irq = radar_acquisition_fake_now();
+
+    radar_acquisition_get_stats(&before);
+    n_events = 0;
+    fifo_irq();
+    radar_acquisition_fake_advance(queue_delay_ns);
+    fifo_irq();
+    radar_acquisition_fake_advance(queue_delay_ns);
+    fifo_irq();
+
+    radar_acquisition_get_stats(&stats);
+    CHECK(stats.queued == before.queued + 1U);
+    CHECK(stats.overruns == before.overruns + 1U);
+    /* IRQ, RESERVE, IRQ, IRQ, OVERRUN: only the first one started a transfer */
+    CHECK((n_events == 5) && (events[2].type == EV_IRQ) && (events[3].type == EV_IRQ) &&
+          (events[4].type == EV_OVERRUN));
+    mgr.get_buffer_stats(&rdm_stats);
+    CHECK(rdm_stats.overruns == 1);
+
+    /* First completion: delivery, then the queued readout starts at once */
+    radar_acquisition_fake_advance(TRANSFER_NS - 2U * queue_delay_ns);
+    CHECK(is_delivery(5, t_irq + TRANSFER_NS));
+    CHECK((n_events == 5U + 1U + N_SUBSCRIBERS + 1U) &&
+          (events[5U + 1U + N_SUBSCRIBERS].type == EV_RESERVE) &&
+          (events[5U + 1U + N_SUBSCRIBERS].t_ns == t_irq + TRANSFER_NS));
+    CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_TRANSFER);
+
+    radar_acquisition_fake_advance(TRANSFER_NS);
+    CHECK(is_delivery(5U + 1U + N_SUBSCRIBERS + 1U, t_irq + 2U * TRANSFER_NS));
+    CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_IDLE);
+
+    radar_acquisition_get_stats(&stats);
+    CHECK(stats.transfers == before.transfers + 2U);
+    CHECK(stats.latency_last_us == (2U * TRANSFER_NS - queue_delay_ns) / 1000U);
+    CHECK(stats.latency_max_us == stats.latency_last_us);
+    CHECK(drain() == 2);
+
+    radar_acquisition_fake_advance(FRAME_PERIOD_NS);
+}
+
+/*******************************************************************************
+* Function Name: test_drops
+********************************************************************************
+* Summary:
+*   With subscribers that do not read, the RDM runs full: the readout is
+*   dropped at the interrupt, the FIFO reset and nothing is published.
+*
+*******************************************************************************/
+static void test_drops(void)
+{
+    radar_acquisition_stats_s before;
+    radar_acquisition_stats_s stats;
+    radar_data_manager_stats_s rdm_stats;
+    uint32_t frames = 0;
+
+    radar_acquisition_get_stats(&before);
+    do
+    {
+        n_events = 0;
+        fifo_irq();
+        radar_acquisition_fake_advance(FRAME_PERIOD_NS);
+        radar_acquisition_get_stats(&stats);
+        frames++;
+    } while ((stats.drops == before.drops) && (frames < 16));
+
+    /* The ring holds five readouts, all of them unread */
+    CHECK(frames == (RDM_BUFFER_SIZE / FILL_LEVEL) + 1U);
+    CHECK(stats.drops == before.drops + 1U);
+    CHECK(stats.transfers == before.transfers + frames - 1U);
+    CHECK((n_events == 3) && (events[1].type == EV_RESERVE) && (events[1].arg != 0) &&
+          (events[2].type == EV_FIFO_RESET));
+    CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_IDLE);
+    CHECK(radar_acquisition_fake_fifo_resets() == 1);
+    mgr.get_buffer_stats(&rdm_stats);
+    CHECK(rdm_stats.fifo_resets == 1);
+
+    /* Nothing was lost from the data that made it in */
+    CHECK(drain() == frames - 1U);
+
+    n_events = 0;
+    fifo_irq();
+    radar_acquisition_fake_advance(FRAME_PERIOD_NS);
+    CHECK(is_delivery(2, events[0].t_ns + TRANSFER_NS));
+    CHECK(drain() == 1);
+}
+
+/*******************************************************************************
+* Function Name: test_transfer_error
+********************************************************************************
+* Summary:
+*   A failed transfer is counted, resets the FIFO and publishes nothing.
+*
+*******************************************************************************/
+static void test_transfer_error(void)
+{
+    radar_acquisition_stats_s before;
+    radar_acquisition_stats_s stats;
+    radar_data_manager_stats_s rdm_before;
+    radar_data_manager_stats_s rdm_stats;
+
+    radar_acquisition_get_stats(&before);
+    mgr.get_buffer_stats(&rdm_before);
+
+    n_events = 0;
+    radar_acquisition_fake_fail_next();
+    fifo_irq();
+    radar_acquisition_fake_advance(FRAME_PERIOD_NS);
+
+    radar_acquisition_get_stats(&stats);
+    mgr.get_buffer_stats(&rdm_stats);
+    CHECK(stats.errors == before.errors + 1U);
+    CHECK(stats.transfers == before.transfers);
+    CHECK((n_events == 3) && (events[2].type == EV_FIFO_RESET));
+    CHECK(rdm_stats.readouts == rdm_before.readouts);
+    CHECK(radar_acquisition_get_state() == RADAR_ACQUISITION_IDLE);
+    CHECK(drain() == 0);
+
+    /* The samples of the failed transfer are gone */
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        expected_sample[i] = (uint16_t)((expected_sample[i] + SAMPLES_PER_READ) & 0x0FFFU);
+    }
+
+    n_events = 0;
+    fifo_irq();
+    radar_acquisition_fake_advance(FRAME_PERIOD_NS);
+    CHECK(is_delivery(2, events[0].t_ns + TRANSFER_NS));
+    CHECK(drain() == 1);
+}
+
+/*******************************************************************************
+* Function Name: test_unpack_in_place
+********************************************************************************
+* Summary:
+*   radar_task unpacks the readout in its ring slot, which must give the same
+*   samples as unpacking to a separate buffer.
+*
+*******************************************************************************/
+static void test_unpack_in_place(void)
+{
+    static uint16_t slot[SAMPLES_PER_READ];
+    static uint16_t samples[SAMPLES_PER_READ];
+    uint8_t *packed = (uint8_t *)slot;
+
+    for (uint32_t i = 0; i < SAMPLES_PER_READ / 2U; ++i)
+    {
+        uint16_t s0 = (uint16_t)((7U * i) & 0x0FFFU);
+        uint16_t s1 = (uint16_t)((4095U - i) & 0x0FFFU);
+        packed[3U * i] = (uint8_t)(s0 >> 4);
+        packed[3U * i + 1U] = (uint8_t)(((s0 & 0x0FU) << 4) | (s1 >> 8));
+        packed[3U * i + 2U] = (uint8_t)(s1 & 0xFFU);
+    }
+
+    radar_acquisition_unpack12(packed, samples, SAMPLES_PER_READ);
+    radar_acquisition_unpack12(packed, slot, SAMPLES_PER_READ);
+    CHECK(memcmp(slot, samples, sizeof(slot)) == 0);
+    CHECK((samples[2] == 7U) && (samples[3] == 4094U));
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    radar_acquisition_backend_s backend;
+    const radar_acquisition_sink_s sink = {
+        .reserve = test_reserve,
+        .commit = test_commit,
+        .overrun = test_overrun
+    };
+
+    host_rtos_set_notify_hook(test_notify);
+
+    if (radar_data_manager_init(&mgr, RDM_BUFFER_SIZE, FILL_LEVEL) != 0)
+    {
+        printf("FAIL radar_data_manager_init\n");
+        return 1;
+    }
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        subscription[i] = mgr.subscribe((TaskHandle_t)&subscriber_task[i]);
+    }
+
+    radar_acquisition_fake_init(&fake_backend, SPI_HZ);
+    backend = fake_backend;
+    backend.reset_fifo = test_reset_fifo;
+    if (radar_acquisition_init(&backend, &sink, SAMPLES_PER_READ) != 0)
+    {
+        printf("FAIL radar_acquisition_init\n");
+        return 1;
+    }
+
+    test_nominal();
+    test_queued_and_overrun();
+    test_drops();
+    test_transfer_error();
+    test_unpack_in_place();
+
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        mgr.unsubscribe(subscription[i]);
+    }
+    CHECK(radar_data_manager_deinit(&mgr) == 0);
+
+    printf("acquisition: %u checks, %u failures\n", (unsigned)n_checks, (unsigned)n_failures);
+    return (n_failures == 0) ? 0 : 1;
+}
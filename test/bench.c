@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name:   bench.c
+*
+* Description: This file implements the helpers shared by the host benchmarks: a
+*   nanosecond time stamp and a deterministic pseudo random generator for
+*   their synthetic data.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <time.h>
+
+#include "bench.h"
+
+/* Time stamp in nanoseconds, wraps around every 4.3 s. */
+uint32_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+/* Next value of a linear congruential generator, the high bits are the most
+*  random ones. */
+uint32_t bench_rand(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state;
+}
+
+/* Uniform in [0, 1) */
+float bench_uniform(uint32_t *state)
+{
+    return (float)(bench_rand(state) >> 8) / 16777216.0f;
+}
+
+/*******************************************************************************
+* Function Name: bench_raw_frame
+********************************************************************************
+* Summary:
+*   Fills a raw FIFO frame ([chirp][sample][antenna] 12-bit words) with a
+*   static beat tone, a moving one and a few counts of noise.
+*
+* Parameters:
+*  raw    : out Raw frame.
+*  f_cfg  : Frame configuration.
+*  moving : Amplitude of the moving tone in ADC counts, 0 for a static scene.
+*  state  : Generator state.
+*
+*******************************************************************************/
+void bench_raw_frame(uint16_t *raw, const frame_cfg *f_cfg, float moving, uint32_t *state)
+{
+    uint32_t n_raw = (uint32_t)f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    for (uint32_t i = 0; i < n_raw; ++i)
+    {
+        uint32_t sample = i / f_cfg->n_channels % f_cfg->n_samples;
+        uint32_t chirp = i / f_cfg->n_channels / f_cfg->n_samples;
+        raw[i] = (uint16_t)(2048.0f + 600.0f * sinf(0.4f * sample) +
+                            moving * sinf(0.9f * sample + 0.2f * chirp) +
+                            64.0f * bench_uniform(state));
+    }
+}
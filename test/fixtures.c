@@ -0,0 +1,128 @@
+/******************************************************************************
+* File Name:   fixtures.c
+*
+* Description: This file reads and writes the raw frame fixtures of the host
+*   tests: frames of FIXTURE_FRAME_WORDS 16-bit little endian words as they
+*   come out of the radar FIFO.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "fixtures.h"
+
+/*******************************************************************************
+* Function Name: fixture_write_frame
+********************************************************************************
+* Summary:
+*   Appends one raw frame to a fixture file.
+*
+* Parameters:
+*  out   : Fixture file.
+*  frame : FIXTURE_FRAME_WORDS raw words.
+*
+* Return:
+*  0 on success, -1 on a write error.
+*
+*******************************************************************************/
+int32_t fixture_write_frame(FILE *out, const uint16_t *frame)
+{
+    for (uint32_t i = 0; i < FIXTURE_FRAME_WORDS; ++i)
+    {
+        if ((fputc(frame[i] & 0xFF, out) == EOF) || (fputc(frame[i] >> 8, out) == EOF))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: fixture_read_frame
+********************************************************************************
+* Summary:
+*   Reads the next raw frame of a fixture file.
+*
+* Parameters:
+*  in    : Fixture file.
+*  frame : out FIXTURE_FRAME_WORDS raw words.
+*
+* Return:
+*  1 if a frame was read, 0 at the end of the file, -1 on a truncated frame.
+*
+*******************************************************************************/
+int32_t fixture_read_frame(FILE *in, uint16_t *frame)
+{
+    for (uint32_t i = 0; i < FIXTURE_FRAME_WORDS; ++i)
+    {
+        int lo = fgetc(in);
+        int hi = fgetc(in);
+
+        if ((lo == EOF) || (hi == EOF))
+        {
+            return ((i == 0) && (lo == EOF)) ? 0 : -1;
+        }
+        frame[i] = (uint16_t)(lo | (hi << 8));
+    }
+    return 1;
+}
+
+/*******************************************************************************
+* Function Name: fixture_deinterleave
+********************************************************************************
+* Summary:
+*   Sorts a raw frame by antenna into the float frame taken by `slim_algo`,
+*   `super_slim_algo` and `algo`, like deinterleave_antennas() in radar.c.
+*
+* Parameters:
+*  frame : FIXTURE_FRAME_WORDS raw words.
+*  out   : out Frame, [antenna][chirp][sample].
+*
+*******************************************************************************/
+void fixture_deinterleave(const uint16_t *frame, float *out)
+{
+    uint32_t antenna = 0;
+    uint32_t index = 0;
+
+    for (uint32_t i = 0; i < FIXTURE_FRAME_WORDS; ++i)
+    {
+        out[index + antenna * FIXTURE_N_SAMPLES * FIXTURE_N_CHIRPS] = frame[i];
+        antenna++;
+        if (antenna == FIXTURE_N_CHANNELS)
+        {
+            antenna = 0;
+            index++;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/******************************************************************************
+* File Name:   fixtures.h
+*
+* Description: This file contains the frame geometry and the function prototypes
+*   of the raw frame fixtures in fixtures.c.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RADAR_TEST_FIXTURES_H_
+#define RADAR_TEST_FIXTURES_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "radar_settings.h"
+
+/* Geometry of the fixtures, the one of the application */
+#define FIXTURE_N_CHANNELS  (XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
+#define FIXTURE_N_CHIRPS    (XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME)
+#define FIXTURE_N_SAMPLES   (XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP)
+#define FIXTURE_FRAME_WORDS (FIXTURE_N_CHANNELS * FIXTURE_N_CHIRPS * FIXTURE_N_SAMPLES)
+
+int32_t fixture_write_frame(FILE *out, const uint16_t *frame);
+
+int32_t fixture_read_frame(FILE *in, uint16_t *frame);
+
+void fixture_deinterleave(const uint16_t *frame, float *out);
+
+#endif /* RADAR_TEST_FIXTURES_H_ */
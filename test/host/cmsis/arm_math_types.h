@@ -0,0 +1,92 @@
+/******************************************************************************
+* File Name:   arm_math_types.h
+*
+* Description: This file contains the CMSIS-DSP data types used by the
+*   preprocessing library, for host builds without the CMSIS-DSP sources.
+*   See cmsis_dsp_ref.c.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ARM_MATH_TYPES_H
+#define ARM_MATH_TYPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+typedef float float32_t;
+typedef double float64_t;
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+typedef enum
+{
+    ARM_MATH_SUCCESS                 =  0,  /* No error */
+    ARM_MATH_ARGUMENT_ERROR          = -1,  /* One or more arguments are incorrect */
+    ARM_MATH_LENGTH_ERROR            = -2,  /* Length of data buffer is incorrect */
+    ARM_MATH_SIZE_MISMATCH           = -3,  /* Size of matrices is not compatible with the operation */
+    ARM_MATH_NANINF                  = -4,  /* Not-a-number (NaN) or infinity is generated */
+    ARM_MATH_SINGULAR                = -5,  /* Input matrix is singular and cannot be inverted */
+    ARM_MATH_TEST_FAILURE            = -6,  /* Test Failed */
+    ARM_MATH_DECOMPOSITION_FAILURE   = -7   /* Decomposition Failed */
+} arm_status;
+
+#define PI               3.14159265358979f
+
+#define __STATIC_FORCEINLINE static inline
+
+/* Signed saturation to `bits` bits */
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t val, uint32_t bits)
+{
+    const int32_t max = (int32_t)((1U << (bits - 1U)) - 1U);
+    const int32_t min = -1 - max;
+
+    return (val > max) ? max : ((val < min) ? min : val);
+}
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* ARM_MATH_TYPES_H */
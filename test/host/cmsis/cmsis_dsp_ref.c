@@ -0,0 +1,532 @@
+/******************************************************************************
+* File Name:   cmsis_dsp_ref.c
+*
+* Description: This file implements the subset of CMSIS-DSP used by the
+*   preprocessing library in portable C, for host builds without the
+*   CMSIS-DSP sources. The transforms are computed in double precision with
+*   the output format and scaling of CMSIS-DSP, they are a reference and not
+*   meant for timing.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "arm_math.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Longest transform supported by CMSIS-DSP */
+#define REF_FFT_MAX_LEN     (4096U)
+
+#define REF_PI              (3.14159265358979323846)
+
+
+/*******************************************************************************
+* Function Name: ref_fft
+********************************************************************************
+* Summary:
+*   In place radix-2 FFT of a complex sequence without scaling.
+*
+* Parameters:
+*  re, im: real and imaginary parts
+*  n: length, power of two
+*  inverse: true for the inverse transform
+*
+* Return:
+*  none
+*
+*******************************************************************************/
+static void ref_fft(double *re, double *im, uint32_t n, bool inverse)
+{
+    uint32_t j = 0;
+
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        uint32_t bit = n >> 1;
+        for (; (j & bit) != 0; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j)
+        {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        const double step = (inverse ? 2.0 : -2.0) * REF_PI / len;
+
+        for (uint32_t k = 0; k < len / 2; ++k)
+        {
+            const double wr = cos(step * k);
+            const double wi = sin(step * k);
+
+            for (uint32_t i = k; i < n; i += len)
+            {
+                const uint32_t m = i + len / 2;
+                const double xr = re[m] * wr - im[m] * wi;
+                const double xi = re[m] * wi + im[m] * wr;
+                re[m] = re[i] - xr;
+                im[m] = im[i] - xi;
+                re[i] += xr;
+                im[i] += xi;
+            }
+        }
+    }
+}
+
+static bool ref_fft_len_ok(uint32_t n)
+{
+    return (n >= 2) && (n <= REF_FFT_MAX_LEN) && ((n & (n - 1)) == 0);
+}
+
+static q31_t ref_sat_q31(double v)
+{
+    if (v >= 2147483647.0)
+    {
+        return INT32_MAX;
+    }
+    if (v <= -2147483648.0)
+    {
+        return INT32_MIN;
+    }
+    return (q31_t)v;
+}
+
+static q31_t ref_sat_q63_to_q31(q63_t v)
+{
+    return (v > INT32_MAX) ? INT32_MAX : ((v < INT32_MIN) ? INT32_MIN : (q31_t)v);
+}
+
+/*******************************************************************************
+* Transforms
+********************************************************************************/
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32 *S, uint16_t fftLen)
+{
+    if (!ref_fft_len_ok(fftLen))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    memset(S, 0, sizeof(*S));
+    S->fftLen = fftLen;
+    return ARM_MATH_SUCCESS;
+}
+
+/* Forward transform unscaled, inverse scaled by 1/fftLen */
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    const uint32_t n = S->fftLen;
+    const double scale = ifftFlag ? 1.0 / n : 1.0;
+    double re[REF_FFT_MAX_LEN];
+    double im[REF_FFT_MAX_LEN];
+
+    (void)bitReverseFlag;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        re[i] = p1[2 * i];
+        im[i] = p1[2 * i + 1];
+    }
+    ref_fft(re, im, n, ifftFlag != 0);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        p1[2 * i] = (float32_t)(re[i] * scale);
+        p1[2 * i + 1] = (float32_t)(im[i] * scale);
+    }
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+    if (!ref_fft_len_ok(fftLen) || (fftLen < 32))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    memset(S, 0, sizeof(*S));
+    S->fftLenRFFT = fftLen;
+    S->Sint.fftLen = fftLen / 2;
+    return ARM_MATH_SUCCESS;
+}
+
+/* Forward: fftLen/2 complex bins with the real Nyquist bin packed into the
+*  imaginary part of bin 0. Inverse: the reverse, scaled by 1/fftLen. */
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+    const uint32_t n = S->fftLenRFFT;
+    double re[REF_FFT_MAX_LEN];
+    double im[REF_FFT_MAX_LEN];
+
+    if (ifftFlag == 0)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            re[i] = p[i];
+            im[i] = 0.0;
+        }
+        ref_fft(re, im, n, false);
+        for (uint32_t k = 0; k < n / 2; ++k)
+        {
+            pOut[2 * k] = (float32_t)re[k];
+            pOut[2 * k + 1] = (float32_t)im[k];
+        }
+        pOut[1] = (float32_t)re[n / 2];
+    }
+    else
+    {
+        re[0] = p[0];
+        im[0] = 0.0;
+        re[n / 2] = p[1];
+        im[n / 2] = 0.0;
+        for (uint32_t k = 1; k < n / 2; ++k)
+        {
+            re[k] = p[2 * k];
+            im[k] = p[2 * k + 1];
+            re[n - k] = p[2 * k];
+            im[n - k] = -p[2 * k + 1];
+        }
+        ref_fft(re, im, n, true);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            pOut[i] = (float32_t)(re[i] / n);
+        }
+    }
+}
+
+arm_status arm_cfft_init_q31(arm_cfft_instance_q31 *S, uint16_t fftLen)
+{
+    if (!ref_fft_len_ok(fftLen) || (fftLen < 16))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    memset(S, 0, sizeof(*S));
+    S->fftLen = fftLen;
+    return ARM_MATH_SUCCESS;
+}
+
+/* Both directions are scaled by 1/fftLen, like the CMSIS-DSP q31 CFFT */
+void arm_cfft_q31(const arm_cfft_instance_q31 *S, q31_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    const uint32_t n = S->fftLen;
+    double re[REF_FFT_MAX_LEN];
+    double im[REF_FFT_MAX_LEN];
+
+    (void)bitReverseFlag;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        re[i] = p1[2 * i];
+        im[i] = p1[2 * i + 1];
+    }
+    ref_fft(re, im, n, ifftFlag != 0);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        p1[2 * i] = ref_sat_q31(re[i] / n);
+        p1[2 * i + 1] = ref_sat_q31(im[i] / n);
+    }
+}
+
+arm_status arm_rfft_init_q31(arm_rfft_instance_q31 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag)
+{
+    if (!ref_fft_len_ok(fftLenReal) || (fftLenReal < 32))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    memset(S, 0, sizeof(*S));
+    S->fftLenReal = fftLenReal;
+    S->ifftFlagR = (uint8_t)ifftFlagR;
+    S->bitReverseFlagR = (uint8_t)bitReverseFlag;
+    return ARM_MATH_SUCCESS;
+}
+
+/* Forward: full complex spectrum of 2 * fftLenReal values scaled by
+*  1/fftLenReal. Inverse: real sequence from the full spectrum, unscaled
+*  beyond the 1/fftLenReal of the forward transform. */
+void arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst)
+{
+    const uint32_t n = S->fftLenReal;
+    double re[REF_FFT_MAX_LEN];
+    double im[REF_FFT_MAX_LEN];
+
+    if (S->ifftFlagR == 0)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            re[i] = pSrc[i];
+            im[i] = 0.0;
+        }
+        ref_fft(re, im, n, false);
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            pDst[2 * k] = ref_sat_q31(re[k] / n);
+            pDst[2 * k + 1] = ref_sat_q31(im[k] / n);
+        }
+    }
+    else
+    {
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            re[k] = pSrc[2 * k];
+            im[k] = pSrc[2 * k + 1];
+        }
+        ref_fft(re, im, n, true);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            pDst[i] = ref_sat_q31(re[i]);
+        }
+    }
+}
+
+/*******************************************************************************
+* Basic and complex math
+********************************************************************************/
+void arm_add_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = pSrcA[i] + pSrcB[i];
+    }
+}
+
+void arm_sub_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = pSrcA[i] - pSrcB[i];
+    }
+}
+
+void arm_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = pSrcA[i] * pSrcB[i];
+    }
+}
+
+void arm_mult_q31(const q31_t *pSrcA, const q31_t *pSrcB, q31_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = ref_sat_q63_to_q31(((q63_t)pSrcA[i] * pSrcB[i]) >> 31);
+    }
+}
+
+void arm_scale_f32(const float32_t *pSrc, float32_t scale, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = pSrc[i] * scale;
+    }
+}
+
+void arm_offset_f32(const float32_t *pSrc, float32_t offset, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = pSrc[i] + offset;
+    }
+}
+
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; ++i)
+    {
+        const float32_t re = pSrc[2 * i];
+        const float32_t im = pSrc[2 * i + 1];
+        pDst[i] = sqrtf(re * re + im * im);
+    }
+}
+
+/* 1.15 input, 2.14 output */
+void arm_cmplx_mag_q15(const q15_t *pSrc, q15_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; ++i)
+    {
+        const double re = pSrc[2 * i];
+        const double im = pSrc[2 * i + 1];
+        pDst[i] = (q15_t)(sqrt(re * re + im * im) / 2.0);
+    }
+}
+
+/* 1.31 input, 2.30 output */
+void arm_cmplx_mag_q31(const q31_t *pSrc, q31_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; ++i)
+    {
+        const double re = pSrc[2 * i];
+        const double im = pSrc[2 * i + 1];
+        pDst[i] = (q31_t)(sqrt(re * re + im * im) / 2.0);
+    }
+}
+
+void arm_cmplx_mult_real_q31(const q31_t *pSrcCmplx, const q31_t *pSrcReal, q31_t *pCmplxDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; ++i)
+    {
+        pCmplxDst[2 * i] = ref_sat_q63_to_q31(((q63_t)pSrcCmplx[2 * i] * pSrcReal[i]) >> 31);
+        pCmplxDst[2 * i + 1] = ref_sat_q63_to_q31(((q63_t)pSrcCmplx[2 * i + 1] * pSrcReal[i]) >> 31);
+    }
+}
+
+/*******************************************************************************
+* Fast math
+********************************************************************************/
+float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+float32_t arm_cos_f32(float32_t x)
+{
+    return cosf(x);
+}
+
+arm_status arm_atan2_f32(float32_t y, float32_t x, float32_t *result)
+{
+    *result = atan2f(y, x);
+    return ARM_MATH_SUCCESS;
+}
+
+/*******************************************************************************
+* Matrix
+********************************************************************************/
+arm_status arm_mat_cmplx_trans_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst)
+{
+    const uint16_t rows = pSrc->numRows;
+    const uint16_t cols = pSrc->numCols;
+
+    if ((pDst->numRows != cols) || (pDst->numCols != rows))
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (uint16_t r = 0; r < rows; ++r)
+    {
+        for (uint16_t c = 0; c < cols; ++c)
+        {
+            pDst->pData[2 * (c * rows + r)] = pSrc->pData[2 * (r * cols + c)];
+            pDst->pData[2 * (c * rows + r) + 1] = pSrc->pData[2 * (r * cols + c) + 1];
+        }
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/*******************************************************************************
+* Statistics
+********************************************************************************/
+void arm_mean_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult)
+{
+    float32_t sum = 0.0f;
+
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        sum += pSrc[i];
+    }
+    *pResult = sum / (float32_t)blockSize;
+}
+
+/* First index of the maximum */
+void arm_max_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex)
+{
+    float32_t max = pSrc[0];
+    uint32_t index = 0;
+
+    for (uint32_t i = 1; i < blockSize; ++i)
+    {
+        if (pSrc[i] > max)
+        {
+            max = pSrc[i];
+            index = i;
+        }
+    }
+    *pResult = max;
+    *pIndex = index;
+}
+
+void arm_power_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult)
+{
+    float32_t sum = 0.0f;
+
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        sum += pSrc[i] * pSrc[i];
+    }
+    *pResult = sum;
+}
+
+/*******************************************************************************
+* Support and filtering
+********************************************************************************/
+void arm_copy_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    memcpy(pDst, pSrc, blockSize * sizeof(float32_t));
+}
+
+void arm_fill_f32(float32_t value, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = value;
+    }
+}
+
+void arm_float_to_q31(const float32_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; ++i)
+    {
+        pDst[i] = ref_sat_q31((double)pSrc[i] * 2147483648.0);
+    }
+}
+
+void arm_conv_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen, float32_t *pDst)
+{
+    for (uint32_t k = 0; k < srcALen + srcBLen - 1; ++k)
+    {
+        float32_t sum = 0.0f;
+        for (uint32_t i = 0; i < srcALen; ++i)
+        {
+            if ((k >= i) && ((k - i) < srcBLen))
+            {
+                sum += pSrcA[i] * pSrcB[k - i];
+            }
+        }
+        pDst[k] = sum;
+    }
+}
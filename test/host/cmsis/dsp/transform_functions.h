@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name:   transform_functions.h
+*
+* Description: CMSIS-DSP transforms provided by cmsis_dsp_ref.c. The instances keep
+*   the fields of CMSIS-DSP but only the lengths and flags are used.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TRANSFORM_FUNCTIONS_H
+#define TRANSFORM_FUNCTIONS_H
+
+#include "../arm_math_types.h"
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    uint16_t fftLen;                /* length of the FFT */
+    const float32_t *pTwiddle;      /* unused */
+    const uint16_t *pBitRevTable;   /* unused */
+    uint16_t bitRevLength;          /* unused */
+} arm_cfft_instance_f32;
+
+typedef struct
+{
+    arm_cfft_instance_f32 Sint;     /* complex FFT of half the length */
+    uint16_t fftLenRFFT;            /* length of the real sequence */
+    const float32_t *pTwiddleRFFT;  /* unused */
+} arm_rfft_fast_instance_f32;
+
+typedef struct
+{
+    uint16_t fftLen;                /* length of the FFT */
+    const q31_t *pTwiddle;          /* unused */
+    const uint16_t *pBitRevTable;   /* unused */
+    uint16_t bitRevLength;          /* unused */
+} arm_cfft_instance_q31;
+
+typedef struct
+{
+    uint32_t fftLenReal;            /* length of the real FFT */
+    uint8_t ifftFlagR;              /* 0 forward, 1 inverse */
+    uint8_t bitReverseFlagR;        /* unused, the output is always in order */
+    uint32_t twidCoefRModifier;     /* unused */
+    const q31_t *pTwiddleAReal;     /* unused */
+    const q31_t *pTwiddleBReal;     /* unused */
+    const arm_cfft_instance_q31 *pCfft; /* unused */
+} arm_rfft_instance_q31;
+
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32 *S, uint16_t fftLen);
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+arm_status arm_cfft_init_q31(arm_cfft_instance_q31 *S, uint16_t fftLen);
+void arm_cfft_q31(const arm_cfft_instance_q31 *S, q31_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status arm_rfft_init_q31(arm_rfft_instance_q31 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+void arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst);
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* TRANSFORM_FUNCTIONS_H */
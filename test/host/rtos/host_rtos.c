@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name:   host_rtos.c
+*
+* Description: This file implements the host FreeRTOS stand-in declared in
+*   task.h with POSIX threads.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* PTHREAD_MUTEX_RECURSIVE */
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 700
+#endif
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "task.h"
+
+static pthread_once_t critical_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t critical;
+static volatile host_rtos_notify_hook notify_hook;
+
+/* Critical sections nest like taskENTER_CRITICAL() does */
+static void host_rtos_init_critical(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void host_rtos_enter_critical(void)
+{
+    pthread_once(&critical_once, host_rtos_init_critical);
+    pthread_mutex_lock(&critical);
+}
+
+void host_rtos_exit_critical(void)
+{
+    pthread_mutex_unlock(&critical);
+}
+
+void host_rtos_set_notify_hook(host_rtos_notify_hook hook)
+{
+    notify_hook = hook;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    host_rtos_notify_hook hook = notify_hook;
+
+    if (NULL != hook)
+    {
+        hook(xTaskToNotify, true);
+    }
+    if (NULL != pxHigherPriorityTaskWoken)
+    {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    host_rtos_notify_hook hook = notify_hook;
+
+    if (NULL != hook)
+    {
+        hook(xTaskToNotify, false);
+    }
+    return pdPASS;
+}
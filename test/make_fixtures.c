@@ -0,0 +1,265 @@
+/******************************************************************************
+* File Name:   make_fixtures.c
+*
+* Description: This file generates the synthetic raw radar frame fixtures of the
+*   host tests. Every scenario is written as a sequence of raw FIFO frames
+*   (16-bit little endian words, interleaved [chirp][sample][antenna]), the
+*   same layout as a capture of the radar data manager output, so recorded
+*   frames can be used in their place.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fixtures.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define FIX_PI              (3.14159265358979323846)
+#define MAX_TARGETS         (4)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+/* Point target of one frame. Range in range bins, Doppler in cycles per
+*  chirp (n_chirps/2 bins correspond to 0.5), angles in degrees. */
+typedef struct {
+    double amplitude;
+    double range;
+    double doppler;
+    double azimuth;
+    double elevation;
+} target;
+
+typedef struct {
+    const char *name;
+    uint16_t n_frames;
+    /* Fills the targets of frame `frame`, returns their number */
+    uint16_t (*scene)(uint16_t frame, uint16_t n_frames, target *targets);
+} scenario;
+
+/*******************************************************************************
+* Scenes
+********************************************************************************/
+/* Static clutter of every scene: antenna leakage and a wall */
+static uint16_t add_clutter(target *targets)
+{
+    const target leakage = { 400.0, 0.6, 0.0, 0.0, 0.0 };
+    const target wall = { 120.0, 17.3, 0.0, -10.0, 5.0 };
+
+    targets[0] = leakage;
+    targets[1] = wall;
+    return 2;
+}
+
+static uint16_t scene_static(uint16_t frame, uint16_t n_frames, target *targets)
+{
+    (void)frame;
+    (void)n_frames;
+    return add_clutter(targets);
+}
+
+/* Hand crossing the field of view from left to right at 15 cm */
+static uint16_t scene_swipe(uint16_t frame, uint16_t n_frames, target *targets)
+{
+    const double t = (double)frame / (n_frames - 1);
+    uint16_t n = add_clutter(targets);
+
+    targets[n].amplitude = 180.0;
+    targets[n].range = 6.3;
+    targets[n].doppler = 0.06 - 0.12 * t;
+    targets[n].azimuth = -35.0 + 70.0 * t;
+    targets[n].elevation = 10.0;
+    return n + 1;
+}
+
+/* Hand approaching the sensor */
+static uint16_t scene_push(uint16_t frame, uint16_t n_frames, target *targets)
+{
+    const double t = (double)frame / (n_frames - 1);
+    uint16_t n = add_clutter(targets);
+
+    targets[n].amplitude = 140.0 + 80.0 * t;
+    targets[n].range = 11.7 - 6.0 * t;
+    targets[n].doppler = -0.21;
+    targets[n].azimuth = 5.0;
+    targets[n].elevation = -8.0 + 4.0 * t;
+    return n + 1;
+}
+
+/* Person standing still behind a hand moving up */
+static uint16_t scene_body_hand(uint16_t frame, uint16_t n_frames, target *targets)
+{
+    const double t = (double)frame / (n_frames - 1);
+    uint16_t n = add_clutter(targets);
+
+    targets[n].amplitude = 260.0;
+    targets[n].range = 13.4;
+    targets[n].doppler = 0.01;
+    targets[n].azimuth = 0.0;
+    targets[n].elevation = 0.0;
+    n++;
+    targets[n].amplitude = 160.0;
+    targets[n].range = 5.8;
+    targets[n].doppler = 0.17;
+    targets[n].azimuth = -12.0;
+    targets[n].elevation = -30.0 + 60.0 * t;
+    return n + 1;
+}
+
+static const scenario scenarios[] = {
+    { "static", 4, scene_static },
+    { "swipe", 6, scene_swipe },
+    { "push", 6, scene_push },
+    { "body_hand", 6, scene_body_hand },
+};
+
+/*******************************************************************************
+* Function Name: noise
+********************************************************************************
+* Summary:
+*   Deterministic uniform noise in [-3, 3] ADC counts.
+*
+*******************************************************************************/
+static int32_t noise(uint32_t *state)
+{
+    *state = *state * 1664525U + 1013904223U;
+    return (int32_t)((*state >> 16) % 7U) - 3;
+}
+
+/*******************************************************************************
+* Function Name: render_frame
+********************************************************************************
+* Summary:
+*   Renders the beat signals of the targets into one raw FIFO frame. A target
+*   at range bin r is a tone of r cycles per chirp, its Doppler advances the
+*   phase from chirp to chirp and its angles set the phase of receivers 1 and
+*   2 relative to receiver 3 (see `slim_algo`).
+*
+* Parameters:
+*  frame    : out FIXTURE_FRAME_WORDS raw words.
+*  targets  : Targets of the frame.
+*  n        : Number of targets.
+*  state    : Noise generator state.
+*
+*******************************************************************************/
+static void render_frame(uint16_t *frame, const target *targets, uint16_t n, uint32_t *state)
+{
+    for (uint32_t chirp = 0; chirp < FIXTURE_N_CHIRPS; ++chirp)
+    {
+        for (uint32_t sample = 0; sample < FIXTURE_N_SAMPLES; ++sample)
+        {
+            for (uint32_t ant = 0; ant < FIXTURE_N_CHANNELS; ++ant)
+            {
+                double v = 2048.0;
+
+                for (uint16_t k = 0; k < n; ++k)
+                {
+                    const target *tg = &targets[k];
+                    double phase = 2.0 * FIX_PI * (tg->range * sample / FIXTURE_N_SAMPLES +
+                                                   tg->doppler * chirp);
+                    if (ant == 0)
+                    {
+                        phase += FIX_PI * sin(tg->azimuth * FIX_PI / 180.0);
+                    }
+                    else if (ant == 1)
+                    {
+                        phase += FIX_PI * sin(tg->elevation * FIX_PI / 180.0);
+                    }
+                    v += tg->amplitude * cos(phase);
+                }
+                v += noise(state);
+
+                frame[(chirp * FIXTURE_N_SAMPLES + sample) * FIXTURE_N_CHANNELS + ant] =
+                    (uint16_t)floor(v + 0.5);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Writes <dir>/<scenario>.frames for every scenario.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static uint16_t frame[FIXTURE_FRAME_WORDS];
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <fixture directory>\n", argv[0]);
+        return 2;
+    }
+
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); ++s)
+    {
+        char path[512];
+        uint32_t state = 0x2545F491U + (uint32_t)s;
+        FILE *out;
+
+        snprintf(path, sizeof(path), "%s/%s.frames", argv[1], scenarios[s].name);
+        out = fopen(path, "wb");
+        if (NULL == out)
+        {
+            perror(path);
+            return 1;
+        }
+
+        for (uint16_t f = 0; f < scenarios[s].n_frames; ++f)
+        {
+            target targets[MAX_TARGETS];
+            uint16_t n = scenarios[s].scene(f, scenarios[s].n_frames, targets);
+
+            render_frame(frame, targets, n, &state);
+            if (fixture_write_frame(out, frame) != 0)
+            {
+                perror(path);
+                fclose(out);
+                return 1;
+            }
+        }
+        fclose(out);
+        printf("%s: %u frames\n", path, scenarios[s].n_frames);
+    }
+    return 0;
+}
@@ -0,0 +1,752 @@
+/******************************************************************************
+* File Name:   preproc_bench.c
+*
+* Description: This file runs the preprocessing benchmarks on the host for the
+*   frame geometry of radar_settings.h, and reports how the CFAR hand
+*   detections of `algo` agree with the median background on fixtures.
+*   Host timings use whichever CMSIS-DSP the library is built with; the
+*   reference in host/cmsis is not representative of the target.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "fixtures.h"
+#include "octobertech.h"
+#include "preproc_profile.h"
+#include "preprocess.h"
+#include "scratch_arena.h"
+#include "windows.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Runs per variant, every benchmark reports the best one */
+#define DEFAULT_RUNS            (200)
+
+/* Doppler profiles of the peak benchmark */
+#define PEAK_PROFILES           (64)
+
+/* Motion gate of radar.c, and the static frames of its benchmark */
+#define MIN_RANGE_BIN           (3)
+#define GATE_THRESHOLD          (3.0f)
+#define GATE_HOLD_FRAMES        (33)
+#define GATE_WARMUP_FRAMES      (33)
+#define GATE_FRAMES             (8)
+
+/* Parameters of `algo`, as in preprocess_golden_test.c */
+#define ALGO_BAND_MIN           (3)
+#define ALGO_BAND_MAX           (10)
+#define ALGO_BAND_OFFSET        (4)
+#define ALGO_RANGE_MIN          (2)
+#define ALGO_GUARD_RANGE        (2)
+#define ALGO_GUARD_DOPPLER      (2)
+#define ALGO_THRESHOLD          (1.5f)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+/* Agreement of the hand detections of a CFAR background with the median
+*  background over a series of frames */
+typedef struct {
+    uint32_t frames;
+    uint32_t both;
+    uint32_t same_cell;
+    uint32_t median_only;
+    uint32_t cfar_only;
+} cfar_agreement;
+
+/* Index of a Doppler profile bin for the former `find_peaks()` */
+typedef struct {
+    const ifx_f32_t *el;
+    uint16_t idx;
+} argsort_tuple;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* CFAR window of the background benchmark and of the agreement report */
+static const cfar_cfg cfar_ca = { CFAR_MODE_CA, 1, 1, 4, 2, 0.0f };
+static const cfar_cfg cfar_os = { CFAR_MODE_OS, 1, 1, 4, 2, 0.75f };
+
+/*******************************************************************************
+* Function Name: bench_fft_plans
+********************************************************************************
+* Summary:
+*   FFTs of one frame: a real FFT of `n_samples` per channel and chirp and a
+*   complex FFT of `n_chirps` per channel and range bin. Each transform runs
+*   with its CMSIS-DSP instance initialized for every call, as
+*   `ifx_range_fft_f32()` and `ifx_doppler_cfft_f32()` did, and with the plan
+*   from `get_fft_plan()`.
+*
+*******************************************************************************/
+static void bench_fft_plans(const frame_cfg *f_cfg, uint16_t n_runs)
+{
+    uint16_t n_samples = f_cfg->n_samples;
+    uint16_t n_chirps = f_cfg->n_chirps;
+    uint32_t n_rfft = (uint32_t)f_cfg->n_channels * n_chirps;
+    uint32_t n_cfft = (uint32_t)f_cfg->n_channels * f_cfg->n_range_bins;
+    float32_t *chirp = malloc(sizeof(float32_t) * n_samples);
+    float32_t *column = malloc(sizeof(float32_t) * 2 * n_chirps);
+    /* Input of either transform, they overwrite it */
+    uint32_t work_len = (n_samples > 2 * n_chirps) ? n_samples : 2 * n_chirps;
+    float32_t *work = malloc(sizeof(float32_t) * work_len);
+    float32_t *out = malloc(sizeof(float32_t) * n_samples);
+    uint32_t state = 1;
+
+    if ((chirp == NULL) || (column == NULL) || (work == NULL) || (out == NULL))
+    {
+        abort();
+    }
+    for (uint16_t i = 0; i < n_samples; ++i)
+    {
+        chirp[i] = 1000.0f * sinf(0.3f * i) + 256.0f * bench_uniform(&state);
+    }
+    for (uint16_t i = 0; i < 2 * n_chirps; ++i)
+    {
+        column[i] = bench_uniform(&state) - 0.5f;
+    }
+    const fft_plan *rfft_plan = get_fft_plan(FFT_PLAN_REAL, n_samples);
+    const fft_plan *cfft_plan = get_fft_plan(FFT_PLAN_COMPLEX, n_chirps);
+
+    printf("fft plans %lu x rfft %u + %lu x cfft %u, best of %u [ns/frame]\n",
+           (unsigned long)n_rfft, n_samples, (unsigned long)n_cfft, n_chirps, n_runs);
+    printf("%-8s %10s %10s %10s\n", "", "per call", "cached", "saved");
+
+    /* Variant 0 initializes the instance for every call, 1 uses the plan */
+    uint32_t best[2][2] = {{UINT32_MAX, UINT32_MAX}, {UINT32_MAX, UINT32_MAX}};
+    for (int cached = 0; cached <= 1; ++cached)
+    {
+        arm_rfft_fast_instance_f32 rfft = rfft_plan->instance.rfft;
+        arm_cfft_instance_f32 cfft = cfft_plan->instance.cfft;
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            uint32_t start = bench_now();
+            for (uint32_t i = 0; i < n_rfft; ++i)
+            {
+                memcpy(work, chirp, sizeof(float32_t) * n_samples);
+                if (!cached)
+                {
+                    (void)arm_rfft_fast_init_f32(&rfft, n_samples);
+                }
+                arm_rfft_fast_f32(&rfft, work, out, 0);
+            }
+            uint32_t ns = bench_now() - start;
+            best[0][cached] = (ns < best[0][cached]) ? ns : best[0][cached];
+
+            start = bench_now();
+            for (uint32_t i = 0; i < n_cfft; ++i)
+            {
+                memcpy(work, column, sizeof(float32_t) * 2 * n_chirps);
+                if (!cached)
+                {
+                    (void)arm_cfft_init_f32(&cfft, n_chirps);
+                }
+                arm_cfft_f32(&cfft, work, 0, 1);
+            }
+            ns = bench_now() - start;
+            best[1][cached] = (ns < best[1][cached]) ? ns : best[1][cached];
+        }
+    }
+    printf("rfft %-3u %10lu %10lu %10ld\n", n_samples, (unsigned long)best[0][0],
+           (unsigned long)best[0][1], (long)best[0][0] - (long)best[0][1]);
+    printf("cfft %-3u %10lu %10lu %10ld\n", n_chirps, (unsigned long)best[1][0],
+           (unsigned long)best[1][1], (long)best[1][0] - (long)best[1][1]);
+
+    free(chirp);
+    free(column);
+    free(work);
+    free(out);
+}
+
+/*******************************************************************************
+* Function Name: bench_remove_mean
+********************************************************************************
+* Summary:
+*   Slow-time mean removal on the range images of a synthetic raw frame: the
+*   range FFT followed by the two strided passes of `remove_mean_3d_cf64()`,
+*   and the range FFT accumulating the sums over chirps followed by the
+*   contiguous `remove_mean_chirps_cf64()`. Also prints the largest
+*   difference of the results.
+*
+*******************************************************************************/
+static void bench_remove_mean(const frame_cfg *f_cfg, uint16_t n_runs)
+{
+    frame_cfg cfg = *f_cfg;
+    uint16_t n_channels = cfg.n_channels;
+    uint16_t n_chirps = cfg.n_chirps;
+    uint16_t n_range_bins = cfg.n_range_bins;
+    uint32_t n_raw = (uint32_t)n_channels * n_chirps * cfg.n_samples;
+    uint32_t n_cube = (uint32_t)n_channels * n_chirps * n_range_bins;
+    uint16_t *raw = malloc(sizeof(uint16_t) * n_raw);
+    ifx_cf64_t *cube = malloc(sizeof(ifx_cf64_t) * 2 * n_cube);
+    ifx_cf64_t *bin_sum = malloc(sizeof(ifx_cf64_t) * n_channels * n_range_bins);
+    uint32_t state = 1;
+
+    if ((raw == NULL) || (cube == NULL) || (bin_sum == NULL))
+    {
+        abort();
+    }
+    bench_raw_frame(raw, &cfg, 300.0f, &state);
+    window_view window = get_window_view(&WINDOWS.hann_adc, cfg.n_samples);
+
+    printf("remove mean %ux%ux%u, best of %u [ns/frame]\n",
+           n_channels, n_chirps, n_range_bins, n_runs);
+    printf("%-8s %8s %8s %8s\n", "", "range", "mean", "total");
+
+    /* Variant 0 removes the mean with strided passes, 1 with the sums */
+    static const char *const variant_names[] = {"strided", "fused"};
+    for (int fused = 0; fused <= 1; ++fused)
+    {
+        ifx_cf64_t *x_range = cube + fused * n_cube;
+        uint32_t best_range = UINT32_MAX;
+        uint32_t best_mean = UINT32_MAX;
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            uint32_t start = bench_now();
+            build_complex_range_chirps_u16(
+                raw, x_range, &cfg, 0, n_chirps, &window, fused ? bin_sum : NULL
+            );
+            uint32_t ns = bench_now() - start;
+            best_range = (ns < best_range) ? ns : best_range;
+
+            start = bench_now();
+            if (fused)
+            {
+                remove_mean_chirps_cf64(x_range, bin_sum, &cfg);
+            }
+            else
+            {
+                remove_mean_3d_cf64(x_range, 1, n_channels, n_chirps, n_range_bins);
+            }
+            ns = bench_now() - start;
+            best_mean = (ns < best_mean) ? ns : best_mean;
+        }
+        printf("%-8s %8lu %8lu %8lu\n", variant_names[fused], (unsigned long)best_range,
+               (unsigned long)best_mean, (unsigned long)(best_range + best_mean));
+    }
+
+    float32_t max_diff = 0.0f;
+    float32_t max_abs = 0.0f;
+    const float32_t *strided = (const float32_t *)cube;
+    const float32_t *fused = (const float32_t *)(cube + n_cube);
+    for (uint32_t i = 0; i < 2 * n_cube; ++i)
+    {
+        max_diff = fmaxf(max_diff, fabsf(strided[i] - fused[i]));
+        max_abs = fmaxf(max_abs, fabsf(strided[i]));
+    }
+    printf("max difference %.3g (max magnitude %.3g)\n", (double)max_diff, (double)max_abs);
+
+    free(raw);
+    free(cube);
+    free(bin_sum);
+}
+
+/* Ascending by value, equal values by index, i.e. the order of the stable
+*  sort the former `find_peaks()` relied on */
+static int compare_argsort(const void *a, const void *b)
+{
+    const argsort_tuple *ta = (const argsort_tuple *)a;
+    const argsort_tuple *tb = (const argsort_tuple *)b;
+    if (*ta->el != *tb->el)
+    {
+        return (*ta->el > *tb->el) ? 1 : -1;
+    }
+    return (ta->idx > tb->idx) ? 1 : -1;
+}
+
+/* The former `find_peaks()`: argsort of the whole profile */
+static void find_peaks_qsort(
+    const ifx_f32_t *in, uint16_t *idx, uint16_t n_elements, uint16_t n_peaks
+)
+{
+    argsort_tuple *indexed = malloc(sizeof(argsort_tuple) * n_elements);
+    if (indexed == NULL)
+    {
+        abort();
+    }
+    for (uint16_t i = 0; i < n_elements; ++i)
+    {
+        indexed[i].el = in + i;
+        indexed[i].idx = i;
+    }
+    qsort(indexed, n_elements, sizeof(argsort_tuple), compare_argsort);
+    for (uint16_t i = 0; i < n_peaks; ++i)
+    {
+        idx[i] = indexed[n_elements - i - 1].idx;
+    }
+    free(indexed);
+}
+
+/* The former `cluster_peaks()`: every peak is checked against every element
+*  of every cluster */
+static void cluster_peaks_scan(
+    const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks
+)
+{
+    for (uint16_t i = 0; i < n_peaks; ++i)
+    {
+        clusters[i].n_elements = 0;
+    }
+    for (uint16_t peak_idx = 0; peak_idx < n_peaks; ++peak_idx)
+    {
+        bool peak_assigned = false;
+        for (uint16_t cluster_idx = 0; !peak_assigned && (cluster_idx < n_peaks); ++cluster_idx)
+        {
+            peak_cluster *cluster = &clusters[cluster_idx];
+            for (uint16_t el_idx = 0; el_idx < cluster->n_elements; ++el_idx)
+            {
+                int32_t diff = (int32_t)peaks[peak_idx] - cluster->elements[el_idx];
+                if ((diff == 1) || (diff == -1))
+                {
+                    cluster->elements[cluster->n_elements] = peaks[peak_idx];
+                    cluster->n_elements += 1;
+                    peak_assigned = true;
+                    break;
+                }
+            }
+        }
+        if (!peak_assigned)
+        {
+            clusters[peak_idx].elements[0] = peaks[peak_idx];
+            clusters[peak_idx].n_elements = 1;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_peaks
+********************************************************************************
+* Summary:
+*   Peak selection and clustering of `detect_hand()` on synthetic Doppler
+*   profiles of `n_elements` bins, half of them with many equal values.
+*   Compares `find_peaks()` and `cluster_peaks()` with the former argsort
+*   (malloc and qsort of the whole profile) and cluster scan.
+*
+* Return:
+*  Number of profiles for which the peaks or clusters differ.
+*
+*******************************************************************************/
+static uint32_t bench_peaks(uint16_t n_elements, uint16_t n_runs)
+{
+    /* As `detect_hand()` */
+    uint16_t n_peaks = (uint16_t)(0.2 * n_elements);
+    uint32_t n_idx = (uint32_t)PEAK_PROFILES * n_peaks;
+    ifx_f32_t *profiles = malloc(sizeof(ifx_f32_t) * PEAK_PROFILES * n_elements);
+    uint16_t *peaks = malloc(sizeof(uint16_t) * 2 * n_idx);
+    uint16_t *elements = malloc(sizeof(uint16_t) * 2 * n_idx * n_peaks);
+    peak_cluster *clusters = malloc(sizeof(peak_cluster) * 2 * n_idx);
+    uint32_t state = 1;
+
+    if ((profiles == NULL) || (peaks == NULL) || (elements == NULL) || (clusters == NULL) ||
+        (n_peaks == 0) || (n_elements > PEAK_ENGINE_MAX_BINS))
+    {
+        abort();
+    }
+    for (uint32_t i = 0; i < (uint32_t)PEAK_PROFILES * n_elements; ++i)
+    {
+        /* Odd profiles take one of 8 levels only */
+        uint32_t r = bench_rand(&state);
+        uint32_t level = ((i / n_elements) % 2) ? (r >> 29) : (r >> 8);
+        profiles[i] = 1e-4f * (float)level;
+    }
+    for (uint32_t i = 0; i < 2 * n_idx; ++i)
+    {
+        clusters[i].elements = elements + i * n_peaks;
+    }
+
+    printf("peaks %u bins, top %u, best of %u [ns/profile]\n", n_elements, n_peaks, n_runs);
+    printf("%-8s %8s %8s\n", "", "find", "cluster");
+    static const char *const variant_names[] = {"qsort", "heap"};
+    for (int variant = 0; variant <= 1; ++variant)
+    {
+        uint16_t *variant_peaks = peaks + variant * n_idx;
+        peak_cluster *variant_clusters = clusters + variant * n_idx;
+        uint32_t best_find = UINT32_MAX;
+        uint32_t best_cluster = UINT32_MAX;
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            uint32_t start = bench_now();
+            for (uint16_t p = 0; p < PEAK_PROFILES; ++p)
+            {
+                const ifx_f32_t *in = profiles + p * n_elements;
+                if (variant == 0)
+                {
+                    find_peaks_qsort(in, variant_peaks + p * n_peaks, n_elements, n_peaks);
+                }
+                else
+                {
+                    find_peaks(in, variant_peaks + p * n_peaks, n_elements, n_peaks);
+                }
+            }
+            uint32_t ns = bench_now() - start;
+            best_find = (ns < best_find) ? ns : best_find;
+
+            start = bench_now();
+            for (uint16_t p = 0; p < PEAK_PROFILES; ++p)
+            {
+                const uint16_t *idx = variant_peaks + p * n_peaks;
+                if (variant == 0)
+                {
+                    cluster_peaks_scan(idx, variant_clusters + p * n_peaks, n_peaks);
+                }
+                else
+                {
+                    cluster_peaks(idx, variant_clusters + p * n_peaks, n_peaks);
+                }
+            }
+            ns = bench_now() - start;
+            best_cluster = (ns < best_cluster) ? ns : best_cluster;
+        }
+        printf("%-8s %8lu %8lu\n", variant_names[variant],
+               (unsigned long)(best_find / PEAK_PROFILES),
+               (unsigned long)(best_cluster / PEAK_PROFILES));
+    }
+
+    uint32_t mismatches = 0;
+    for (uint16_t p = 0; p < PEAK_PROFILES; ++p)
+    {
+        bool same = memcmp(peaks + p * n_peaks, peaks + n_idx + p * n_peaks,
+                           sizeof(uint16_t) * n_peaks) == 0;
+        for (uint16_t c = 0; same && (c < n_peaks); ++c)
+        {
+            const peak_cluster *a = &clusters[p * n_peaks + c];
+            const peak_cluster *b = &clusters[n_idx + p * n_peaks + c];
+            same = (a->n_elements == b->n_elements) &&
+                   (memcmp(a->elements, b->elements, sizeof(uint16_t) * a->n_elements) == 0);
+        }
+        mismatches += same ? 0 : 1;
+    }
+    printf("%lu of %u profiles differ\n", (unsigned long)mismatches, PEAK_PROFILES);
+
+    free(profiles);
+    free(peaks);
+    free(elements);
+    free(clusters);
+    return mismatches;
+}
+
+/*******************************************************************************
+* Function Name: bench_background
+********************************************************************************
+* Summary:
+*   Hand detection against the median background and against the CA and OS
+*   CFAR on a synthetic masked image (noise floor and two targets).
+*
+*******************************************************************************/
+static void bench_background(const frame_cfg *f_cfg, uint16_t n_runs)
+{
+    uint16_t n_chirps = f_cfg->n_chirps;
+    uint16_t n_range_bins = f_cfg->n_range_bins;
+    uint32_t len = (uint32_t)n_chirps * n_range_bins;
+    ifx_f32_t *image = malloc(sizeof(ifx_f32_t) * len);
+    uint32_t state = 1;
+
+    if (image == NULL)
+    {
+        abort();
+    }
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        image[i] = 1e-4f * (1.0f + bench_uniform(&state));
+    }
+    image[(n_chirps / 4) * n_range_bins + n_range_bins / 3] = 5e-3f;
+    image[(3 * n_chirps / 4) * n_range_bins + n_range_bins / 2] = 2e-3f;
+    region search = {.row_start = 0, .row_end = n_chirps, .col_start = 0, .col_end = n_range_bins};
+
+    scratch_arena_reserve(algo_scratch_size(f_cfg));
+    printf("background %ux%u, best of %u [ns/frame]\n", n_chirps, n_range_bins, n_runs);
+
+    static const char *const mode_names[] = {"median", "ca-cfar", "os-cfar"};
+    const cfar_cfg *modes[] = {NULL, &cfar_ca, &cfar_os};
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        uint32_t best = UINT32_MAX;
+        detection hand = {0};
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            uint32_t start = bench_now();
+            scratch_mark mark = scratch_get_mark();
+            if (modes[mode] == NULL)
+            {
+                float bg_level = get_background_level_roi(image, f_cfg, &search);
+                hand = detect_hand(image, &search, f_cfg, bg_level, DETECTION_MODE_CLOSEST, 3.0f, NULL);
+            }
+            else
+            {
+                cfar_map map;
+                cfar_prepare(&map, image, f_cfg, &search, modes[mode]);
+                hand = detect_hand(image, &search, f_cfg, 0.0f, DETECTION_MODE_CLOSEST, 3.0f, &map);
+            }
+            scratch_release(mark);
+            uint32_t ns = bench_now() - start;
+            best = (ns < best) ? ns : best;
+        }
+        printf("%-8s %8lu  hand %u/%u\n", mode_names[mode], (unsigned long)best,
+               hand.doppler_bin, hand.range_bin);
+    }
+
+    free(image);
+}
+
+/*******************************************************************************
+* Function Name: bench_motion_gate
+********************************************************************************
+* Summary:
+*   Processing of a static scene after the range FFT by
+*   `slim_algo_from_range_image()` and, once the noise floor is learnt and the
+*   initial hold has run out, by
+*   `slim_algo_gated_from_range_image()` with the gate of radar.c. Then a
+*   frame with a moving target must open the gate.
+*
+* Return:
+*  false if the gate processed a static frame after warm-up or skipped the
+*  moving one.
+*
+*******************************************************************************/
+static bool bench_motion_gate(const frame_cfg *f_cfg, uint16_t n_runs)
+{
+    frame_cfg cfg = *f_cfg;
+    uint32_t n_raw = (uint32_t)cfg.n_channels * cfg.n_chirps * cfg.n_samples;
+    uint16_t *raw = malloc(sizeof(uint16_t) * n_raw * GATE_FRAMES);
+    uint32_t state = 1;
+    slim_algo_output out;
+
+    if (raw == NULL)
+    {
+        abort();
+    }
+    for (uint16_t i = 0; i < GATE_FRAMES; ++i)
+    {
+        bench_raw_frame(raw + i * n_raw, &cfg, 0.0f, &state);
+    }
+    preproc_octobertech_work_arrays arr =
+        new_preproc_octobertech_work_arrays_for(&cfg, PREPROC_VARIANT_SLIM);
+    motion_gate gate = new_motion_gate(GATE_THRESHOLD, GATE_HOLD_FRAMES, GATE_WARMUP_FRAMES);
+
+    /* Learns the noise floor and runs out the initial hold */
+    for (uint16_t i = 0; i < GATE_WARMUP_FRAMES + GATE_HOLD_FRAMES; ++i)
+    {
+        slim_algo_load_raw_frame(raw + (i % GATE_FRAMES) * n_raw, &cfg, &arr);
+        (void)slim_algo_gated_from_range_image(&out, &cfg, MIN_RANGE_BIN, &arr, &gate);
+        scratch_reset();
+    }
+    uint32_t misses = gate.misses;
+
+    printf("motion gate, static scene, best of %u [ns/frame after the range fft]\n", n_runs);
+    static const char *const variant_names[] = {"ungated", "gated"};
+    for (int gated = 0; gated <= 1; ++gated)
+    {
+        uint32_t best = UINT32_MAX;
+        for (uint16_t run = 0; run < n_runs; ++run)
+        {
+            slim_algo_load_raw_frame(raw + (run % GATE_FRAMES) * n_raw, &cfg, &arr);
+            uint32_t start = bench_now();
+            if (gated)
+            {
+                (void)slim_algo_gated_from_range_image(&out, &cfg, MIN_RANGE_BIN, &arr, &gate);
+            }
+            else
+            {
+                slim_algo_from_range_image(&out, &cfg, MIN_RANGE_BIN, &arr);
+            }
+            uint32_t ns = bench_now() - start;
+            best = (ns < best) ? ns : best;
+            scratch_reset();
+        }
+        printf("%-8s %8lu\n", variant_names[gated], (unsigned long)best);
+    }
+    uint32_t processed = gate.misses - misses;
+
+    bench_raw_frame(raw, &cfg, 300.0f, &state);
+    slim_algo_load_raw_frame(raw, &cfg, &arr);
+    bool motion_passed = slim_algo_gated_from_range_image(&out, &cfg, MIN_RANGE_BIN, &arr, &gate);
+    scratch_reset();
+    printf("%lu static frames skipped, %lu processed, moving target %s\n",
+           (unsigned long)gate.hits, (unsigned long)processed,
+           motion_passed ? "processed" : "skipped");
+
+    free_preproc_octobertech_work_arrays(&arr);
+    free(raw);
+    return (processed == 0) && motion_passed;
+}
+
+/* Adds one frame to a CFAR agreement report, `median` and `cfar` are the
+*  results of `algo()` for the same frame with the two backgrounds. */
+static void cfar_agreement_add(
+    cfar_agreement *report, const algo_output *median, const algo_output *cfar
+)
+{
+    report->frames++;
+    if (median->success && cfar->success)
+    {
+        report->both++;
+        if ((median->hand_features.detection.doppler_bin == cfar->hand_features.detection.doppler_bin) &&
+            (median->hand_features.detection.range_bin == cfar->hand_features.detection.range_bin))
+        {
+            report->same_cell++;
+        }
+    }
+    else if (median->success)
+    {
+        report->median_only++;
+    }
+    else if (cfar->success)
+    {
+        report->cfar_only++;
+    }
+}
+
+static void cfar_agreement_print(const char *name, const cfar_agreement *report)
+{
+    uint32_t agree = report->frames - report->median_only - report->cfar_only;
+    printf("%s: %lu frames, %lu agree (%lu detected by both, %lu at the same cell), "
+           "%lu median only, %lu cfar only\n", name,
+           (unsigned long)report->frames, (unsigned long)agree, (unsigned long)report->both,
+           (unsigned long)report->same_cell, (unsigned long)report->median_only,
+           (unsigned long)report->cfar_only);
+}
+
+/*******************************************************************************
+* Function Name: compare_cfar_fixture
+********************************************************************************
+* Summary:
+*   Runs every frame of a fixture through `algo` with the median background
+*   and with the CA and OS CFAR, each tracking the human position on its own,
+*   and adds the detections to the agreement reports.
+*
+* Return:
+*  false if the file cannot be read.
+*
+*******************************************************************************/
+static bool compare_cfar_fixture(const char *path, frame_cfg *f_cfg,
+                                 cfar_agreement *ca_report, cfar_agreement *os_report)
+{
+    static uint16_t raw[FIXTURE_FRAME_WORDS];
+    static float frame[FIXTURE_FRAME_WORDS];
+    estimate_human_cfg h_cfg[3] = {{ 2, -1, 0.1f }, { 2, -1, 0.1f }, { 2, -1, 0.1f }};
+    const cfar_cfg *modes[3] = {NULL, &cfar_ca, &cfar_os};
+    FILE *fixture = fopen(path, "rb");
+    int32_t status;
+
+    if (NULL == fixture)
+    {
+        perror(path);
+        return false;
+    }
+
+    while ((status = fixture_read_frame(fixture, raw)) == 1)
+    {
+        algo_output out[3];
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            /* `algo` consumes its float frame */
+            fixture_deinterleave(raw, frame);
+            algo(&out[mode], frame, f_cfg, &h_cfg[mode], ALGO_BAND_MIN, ALGO_BAND_MAX,
+                 ALGO_BAND_OFFSET, ALGO_RANGE_MIN, ALGO_GUARD_RANGE, ALGO_GUARD_DOPPLER,
+                 DETECTION_MODE_CLOSEST, ALGO_THRESHOLD, modes[mode]);
+        }
+        cfar_agreement_add(ca_report, &out[0], &out[1]);
+        cfar_agreement_add(os_report, &out[0], &out[2]);
+    }
+    fclose(fixture);
+
+    if (status < 0)
+    {
+        printf("%s: truncated frame\n", path);
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   preproc_bench [runs per variant] [fixture.frames...]
+*
+* Return:
+*  0 on success, 1 if the peak engine differs from the former argsort, the
+*  motion gate misjudges a frame or a fixture cannot be read, 2 on a usage
+*  error.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    frame_cfg f_cfg = {
+        .n_channels = FIXTURE_N_CHANNELS,
+        .n_chirps = FIXTURE_N_CHIRPS,
+        .n_samples = FIXTURE_N_SAMPLES,
+        .n_range_bins = FIXTURE_N_SAMPLES / 2
+    };
+    long n_runs = (argc > 1) ? strtol(argv[1], NULL, 10) : DEFAULT_RUNS;
+    cfar_agreement ca_report = {0};
+    cfar_agreement os_report = {0};
+    bool ok = true;
+
+    if ((n_runs <= 0) || (n_runs > UINT16_MAX))
+    {
+        fprintf(stderr, "usage: %s [runs per variant] [fixture.frames...]\n", argv[0]);
+        return 2;
+    }
+
+    init_fft_plans(&f_cfg);
+    preproc_profile_init();
+    bench_fft_plans(&f_cfg, (uint16_t)n_runs);
+    preproc_profile_bench_range_fft(FIXTURE_N_SAMPLES, FIXTURE_N_CHIRPS, (uint16_t)n_runs);
+    bench_remove_mean(&f_cfg, (uint16_t)n_runs);
+    /* The Doppler profile of detect_hand() has one bin per chirp */
+    ok = (bench_peaks(FIXTURE_N_CHIRPS, (uint16_t)n_runs) == 0);
+    bench_background(&f_cfg, (uint16_t)n_runs);
+    ok = bench_motion_gate(&f_cfg, (uint16_t)n_runs) && ok;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        ok = compare_cfar_fixture(argv[i], &f_cfg, &ca_report, &os_report) && ok;
+    }
+    if (argc > 2)
+    {
+        cfar_agreement_print("ca-cfar", &ca_report);
+        cfar_agreement_print("os-cfar", &os_report);
+    }
+    scratch_arena_free();
+    return ok ? 0 : 1;
+}
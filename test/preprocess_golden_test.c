@@ -0,0 +1,516 @@
+/******************************************************************************
+* File Name:   preprocess_golden_test.c
+*
+* Description: This file runs the preprocessing library over a raw frame fixture
+*   and compares `slim_algo`, `super_slim_algo` and `algo` outputs to the
+*   golden vectors of the fixture. Every implementation of an output is
+*   checked: the float32 `slim_algo`, the raw frame and the streamed chirp
+*   group paths, the fixed-point variant within its documented error bound,
+*   `algo` with the CA and OS CFAR, and `algo_roi` against `algo` in every
+*   background mode. With --update the golden file is written from the
+*   float32 reference functions instead.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fixtures.h"
+#include "octobertech.h"
+#include "octobertech_q15.h"
+#include "preprocess.h"
+#include "scratch_arena.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Parameters of the application (see radar.c) */
+#define MIN_RANGE_BIN           (3)
+#define CHIRPS_PER_GROUP        (8)
+
+/* Parameters of `algo` */
+#define ALGO_BAND_MIN           (3)
+#define ALGO_BAND_MAX           (10)
+#define ALGO_BAND_OFFSET        (4)
+#define ALGO_RANGE_MIN          (2)
+#define ALGO_GUARD_RANGE        (2)
+#define ALGO_GUARD_DOPPLER      (2)
+#define ALGO_THRESHOLD          (1.5f)
+
+/* Background modes of `algo`: median, CA-CFAR and OS-CFAR */
+#define ALGO_N_MODES            (3)
+
+/* Float32 paths: same arithmetic in a different order, and CMSIS-DSP
+*  versus the reference transforms of the golden vectors */
+#define F32_VALUE_RTOL          (1e-4f)
+#define F32_VALUE_ATOL          (1e-6f)
+#define F32_ANGLE_ATOL          (1e-4f)
+
+/* Fixed-point path, the error bound documented in octobertech_q15.h. Below
+*  Q15_MIN_VALUE (frames without a hand) the candidates are closer than the
+*  bound, so only the value is compared. */
+#define Q15_VALUE_ATOL          Q15_BOUND_VALUE
+#define Q15_ANGLE_ATOL          Q15_BOUND_ANGLE
+#define Q15_MIN_VALUE           Q15_BOUND_MIN_VALUE
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct {
+    float value_rtol;
+    float value_atol;
+    float angle_atol;
+    /* Bins and angles are only compared for detections above this value */
+    float min_value;
+} tolerance;
+
+typedef struct {
+    slim_algo_output slim;
+    super_slim_algo_output super;
+    algo_output algo[ALGO_N_MODES];
+} frame_outputs;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const tolerance f32_tol = {
+    F32_VALUE_RTOL, F32_VALUE_ATOL, F32_ANGLE_ATOL, 0.0f
+};
+static const tolerance q15_tol = {
+    0.0f, Q15_VALUE_ATOL, Q15_ANGLE_ATOL, Q15_MIN_VALUE
+};
+
+static const cfar_cfg cfar_ca = { CFAR_MODE_CA, 1, 1, 4, 2, 0.0f };
+static const cfar_cfg cfar_os = { CFAR_MODE_OS, 1, 1, 4, 2, 0.75f };
+static const cfar_cfg *const algo_modes[ALGO_N_MODES] = { NULL, &cfar_ca, &cfar_os };
+static const char *const algo_names[ALGO_N_MODES] = { "algo", "algo_ca", "algo_os" };
+static const char *const algo_roi_names[ALGO_N_MODES] = { "algo_roi", "algo_roi_ca", "algo_roi_os" };
+
+static uint32_t n_checks;
+static uint32_t n_failures;
+
+/*******************************************************************************
+* Function Name: close_to
+********************************************************************************
+* Summary:
+*   Compares a value to its expected value within an absolute and a relative
+*   tolerance.
+*
+*******************************************************************************/
+static bool close_to(float actual, float expected, float atol, float rtol)
+{
+    return fabsf(actual - expected) <= (atol + rtol * fabsf(expected));
+}
+
+static void report(bool ok, uint32_t frame, const char *what)
+{
+    n_checks++;
+    if (!ok)
+    {
+        n_failures++;
+        printf("FAIL frame %u: %s\n", (unsigned)frame, what);
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_slim
+********************************************************************************
+* Summary:
+*   Compares a `slim_algo_output` to the golden one.
+*
+*******************************************************************************/
+static void check_slim(uint32_t frame, const char *path, const slim_algo_output *out,
+                       const slim_algo_output *golden, const tolerance *tol)
+{
+    const slim_algo_detection *a = &out->detection;
+    const slim_algo_detection *e = &golden->detection;
+    bool ok = (out->success == golden->success) &&
+              close_to(a->value, e->value, tol->value_atol, tol->value_rtol);
+
+    if (e->value >= tol->min_value)
+    {
+        ok = ok && (a->range_bin == e->range_bin) &&
+             (a->doppler_bin == e->doppler_bin) &&
+             close_to(a->azimuth, e->azimuth, tol->angle_atol, 0.0f) &&
+             close_to(a->elevation, e->elevation, tol->angle_atol, 0.0f);
+    }
+
+    report(ok, frame, path);
+    if (!ok)
+    {
+        printf("  got      %d %u %u %.6f %.6f %.8g\n", out->success, a->range_bin,
+               a->doppler_bin, a->azimuth, a->elevation, a->value);
+        printf("  expected %d %u %u %.6f %.6f %.8g\n", golden->success, e->range_bin,
+               e->doppler_bin, e->azimuth, e->elevation, e->value);
+    }
+}
+
+static void check_super(uint32_t frame, const super_slim_algo_output *out,
+                        const super_slim_algo_output *golden)
+{
+    const super_slim_algo_detection *a = &out->detection;
+    const super_slim_algo_detection *e = &golden->detection;
+    bool ok = (out->success == golden->success) &&
+              (a->range_bin == e->range_bin) &&
+              close_to(a->doppler_bin, e->doppler_bin, F32_ANGLE_ATOL, F32_VALUE_RTOL) &&
+              close_to(a->azimuth, e->azimuth, F32_ANGLE_ATOL, 0.0f) &&
+              close_to(a->elevation, e->elevation, F32_ANGLE_ATOL, 0.0f) &&
+              close_to(a->value, e->value, F32_VALUE_ATOL, F32_VALUE_RTOL);
+
+    report(ok, frame, "super_slim_algo");
+    if (!ok)
+    {
+        printf("  got      %d %u %.6f %.6f %.6f %.8g\n", out->success, a->range_bin,
+               a->doppler_bin, a->azimuth, a->elevation, a->value);
+        printf("  expected %d %u %.6f %.6f %.6f %.8g\n", golden->success, e->range_bin,
+               e->doppler_bin, e->azimuth, e->elevation, e->value);
+    }
+}
+
+static void check_algo(uint32_t frame, const char *path, const algo_output *out,
+                       const algo_output *golden)
+{
+    const hand_features *a = &out->hand_features;
+    const hand_features *e = &golden->hand_features;
+    bool ok = (out->success == golden->success) &&
+              close_to(out->human_position, golden->human_position, F32_ANGLE_ATOL, F32_VALUE_RTOL) &&
+              (out->lower_limit == golden->lower_limit) &&
+              (out->upper_limit == golden->upper_limit) &&
+              close_to(a->bg_level, e->bg_level, F32_VALUE_ATOL, F32_VALUE_RTOL);
+
+    /* The hand features are only set with a detection */
+    if (golden->success)
+    {
+        ok = ok && (a->detection.range_bin == e->detection.range_bin) &&
+             (a->detection.doppler_bin == e->detection.doppler_bin) &&
+             close_to(a->detection.value, e->detection.value, F32_VALUE_ATOL, F32_VALUE_RTOL) &&
+             close_to(a->azimuth, e->azimuth, F32_ANGLE_ATOL, 0.0f) &&
+             close_to(a->elevation, e->elevation, F32_ANGLE_ATOL, 0.0f);
+    }
+
+    report(ok, frame, path);
+    if (!ok)
+    {
+        printf("  got      %d %.4f %u %u %.8g %.6f %.6f %.8g %u %u\n", out->success,
+               out->human_position, a->detection.range_bin, a->detection.doppler_bin,
+               a->detection.value, a->azimuth, a->elevation, a->bg_level,
+               out->lower_limit, out->upper_limit);
+        printf("  expected %d %.4f %u %u %.8g %.6f %.6f %.8g %u %u\n", golden->success,
+               golden->human_position, e->detection.range_bin, e->detection.doppler_bin,
+               e->detection.value, e->azimuth, e->elevation, e->bg_level,
+               golden->lower_limit, golden->upper_limit);
+    }
+}
+
+/*******************************************************************************
+* Function Name: check_range_sum_storage
+********************************************************************************
+* Summary:
+*   `x_range_sum` is filled by the radar task while either algorithm may run,
+*   so it must not share storage with any other work array.
+*
+*******************************************************************************/
+static void check_range_sum_storage(const preproc_octobertech_work_arrays *arr,
+                                    const frame_cfg *f_cfg)
+{
+    uint32_t n_cch = f_cfg->n_channels * f_cfg->n_chirps;
+    uint32_t n_hfr = n_cch * f_cfg->n_range_bins;
+    const struct {
+        const void *data;
+        size_t size;
+    } others[] = {
+        { arr->x_range, n_hfr * sizeof(ifx_cf64_t) },
+        { arr->x_range_keep, n_hfr * sizeof(ifx_cf64_t) },
+        { arr->x_doppler, n_cch * sizeof(ifx_cf64_t) },
+        { arr->phases, n_cch * sizeof(ifx_f32_t) },
+        { arr->doppler_profile, f_cfg->n_chirps * sizeof(ifx_f32_t) },
+        { arr->range_profile, f_cfg->n_range_bins * sizeof(ifx_f32_t) },
+    };
+    const uint8_t *sum = (const uint8_t *)arr->x_range_sum;
+    size_t sum_size = f_cfg->n_channels * f_cfg->n_range_bins * sizeof(ifx_cf64_t);
+    bool ok = (sum != NULL);
+
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); ++i)
+    {
+        const uint8_t *other = (const uint8_t *)others[i].data;
+        if ((other != NULL) && (sum < other + others[i].size) && (other < sum + sum_size))
+        {
+            ok = false;
+        }
+    }
+    report(ok, 0, "x_range_sum storage");
+}
+
+/*******************************************************************************
+* Function Name: write_golden / read_golden
+********************************************************************************
+* Summary:
+*   Golden vectors are text, one block of five lines per frame:
+*     slim    success range_bin doppler_bin azimuth elevation value
+*     super   success range_bin doppler_bin azimuth elevation value
+*     algo    success human_position range_bin doppler_bin value azimuth
+*             elevation bg_level lower_limit upper_limit
+*     algo_ca as algo, with the CA-CFAR background
+*     algo_os as algo, with the OS-CFAR background
+*
+*******************************************************************************/
+static void write_golden(FILE *out, const frame_outputs *o)
+{
+    const slim_algo_detection *s = &o->slim.detection;
+    const super_slim_algo_detection *u = &o->super.detection;
+
+    fprintf(out, "slim %d %u %u %.9g %.9g %.9g\n", o->slim.success, s->range_bin,
+            s->doppler_bin, s->azimuth, s->elevation, s->value);
+    fprintf(out, "super %d %u %.9g %.9g %.9g %.9g\n", o->super.success, u->range_bin,
+            u->doppler_bin, u->azimuth, u->elevation, u->value);
+    for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+    {
+        const algo_output *a = &o->algo[mode];
+        const hand_features *h = &a->hand_features;
+        fprintf(out, "%s %d %.9g %u %u %.9g %.9g %.9g %.9g %u %u\n", algo_names[mode],
+                a->success, a->human_position, h->detection.range_bin,
+                h->detection.doppler_bin, h->detection.value, h->azimuth, h->elevation,
+                h->bg_level, a->lower_limit, a->upper_limit);
+    }
+}
+
+static bool read_golden(FILE *in, frame_outputs *o)
+{
+    slim_algo_detection *s = &o->slim.detection;
+    super_slim_algo_detection *u = &o->super.detection;
+    int slim_success, super_success;
+    unsigned s_range, s_doppler, u_range;
+    char name[16];
+
+    memset(o, 0, sizeof(*o));
+    if ((fscanf(in, " slim %d %u %u %f %f %f", &slim_success, &s_range, &s_doppler,
+                &s->azimuth, &s->elevation, &s->value) != 6) ||
+        (fscanf(in, " super %d %u %f %f %f %f", &super_success, &u_range,
+                &u->doppler_bin, &u->azimuth, &u->elevation, &u->value) != 6))
+    {
+        return false;
+    }
+    o->slim.success = (slim_success != 0);
+    s->range_bin = (uint16_t)s_range;
+    s->doppler_bin = (uint16_t)s_doppler;
+    o->super.success = (super_success != 0);
+    u->range_bin = (uint16_t)u_range;
+
+    for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+    {
+        algo_output *a = &o->algo[mode];
+        hand_features *h = &a->hand_features;
+        int success;
+        unsigned range, doppler, lower, upper;
+        if ((fscanf(in, " %15s %d %f %u %u %f %f %f %f %u %u", name, &success,
+                    &a->human_position, &range, &doppler, &h->detection.value,
+                    &h->azimuth, &h->elevation, &h->bg_level, &lower, &upper) != 11) ||
+            (strcmp(name, algo_names[mode]) != 0))
+        {
+            return false;
+        }
+        a->success = (success != 0);
+        h->detection.range_bin = (uint16_t)range;
+        h->detection.doppler_bin = (uint16_t)doppler;
+        a->lower_limit = (uint16_t)lower;
+        a->upper_limit = (uint16_t)upper;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   preprocess_golden_test <fixture.frames> <fixture.golden> [--update]
+*
+* Return:
+*  0 if all outputs match, 1 on a mismatch, 2 on a usage or file error.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static uint16_t raw[FIXTURE_FRAME_WORDS];
+    static float frame[FIXTURE_FRAME_WORDS];
+    frame_cfg f_cfg = {
+        .n_channels = FIXTURE_N_CHANNELS,
+        .n_chirps = FIXTURE_N_CHIRPS,
+        .n_samples = FIXTURE_N_SAMPLES,
+        .n_range_bins = FIXTURE_N_SAMPLES / 2
+    };
+    /* `algo` and `algo_roi` track the human position from frame to frame,
+    *  separately in every background mode */
+    estimate_human_cfg h_cfg[ALGO_N_MODES];
+    estimate_human_cfg h_cfg_roi[ALGO_N_MODES];
+    bool update = (argc == 4) && (strcmp(argv[3], "--update") == 0);
+    FILE *fixture;
+    FILE *golden;
+    int32_t status;
+    uint32_t n_frames = 0;
+
+    if ((argc != 3) && !update)
+    {
+        fprintf(stderr, "usage: %s <fixture.frames> <fixture.golden> [--update]\n", argv[0]);
+        return 2;
+    }
+
+    fixture = fopen(argv[1], "rb");
+    golden = fopen(argv[2], update ? "w" : "r");
+    if ((NULL == fixture) || (NULL == golden))
+    {
+        perror((NULL == fixture) ? argv[1] : argv[2]);
+        return 2;
+    }
+
+    preproc_octobertech_work_arrays arr = new_preproc_octobertech_work_arrays(&f_cfg);
+    preproc_octobertech_q15_work_arrays arr_q15 = new_preproc_octobertech_q15_work_arrays(&f_cfg);
+    check_range_sum_storage(&arr, &f_cfg);
+    for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+    {
+        h_cfg[mode] = (estimate_human_cfg){ 2, -1, 0.1f };
+        h_cfg_roi[mode] = h_cfg[mode];
+    }
+
+    while ((status = fixture_read_frame(fixture, raw)) == 1)
+    {
+        frame_outputs ref;
+        frame_outputs expected;
+        slim_algo_output out;
+        algo_output algo_out;
+
+        /* Without a detection `algo` only sets `success`, the other fields
+        *  of the outputs stay zero */
+        memset(&ref, 0, sizeof(ref));
+
+        /* Reference functions, each consumes its float frame */
+        fixture_deinterleave(raw, frame);
+        slim_algo(&ref.slim, frame, &f_cfg, MIN_RANGE_BIN, &arr);
+        fixture_deinterleave(raw, frame);
+        super_slim_algo(&ref.super, frame, &f_cfg, MIN_RANGE_BIN, &arr);
+        for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+        {
+            fixture_deinterleave(raw, frame);
+            algo(&ref.algo[mode], frame, &f_cfg, &h_cfg[mode], ALGO_BAND_MIN, ALGO_BAND_MAX,
+                 ALGO_BAND_OFFSET, ALGO_RANGE_MIN, ALGO_GUARD_RANGE, ALGO_GUARD_DOPPLER,
+                 DETECTION_MODE_CLOSEST, ALGO_THRESHOLD, algo_modes[mode]);
+        }
+
+        if (update)
+        {
+            write_golden(golden, &ref);
+            n_frames++;
+            continue;
+        }
+
+        if (!read_golden(golden, &expected))
+        {
+            printf("FAIL frame %u: no golden vector\n", (unsigned)n_frames);
+            n_failures++;
+            break;
+        }
+
+        check_slim(n_frames, "slim_algo", &ref.slim, &expected.slim, &f32_tol);
+        check_super(n_frames, &ref.super, &expected.super);
+        for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+        {
+            check_algo(n_frames, algo_names[mode], &ref.algo[mode], &expected.algo[mode]);
+        }
+
+        /* Raw frame and streamed chirp groups, as run by radar.c */
+        slim_algo_load_raw_frame(raw, &f_cfg, &arr);
+        slim_algo_from_range_image(&out, &f_cfg, MIN_RANGE_BIN, &arr);
+        check_slim(n_frames, "slim_algo_load_raw_frame", &out, &expected.slim, &f32_tol);
+
+        for (uint16_t chirp = 0; chirp < FIXTURE_N_CHIRPS; chirp += CHIRPS_PER_GROUP)
+        {
+            slim_algo_push_chirps(raw + chirp * FIXTURE_N_SAMPLES * FIXTURE_N_CHANNELS,
+                                  chirp, CHIRPS_PER_GROUP, &f_cfg, &arr);
+        }
+        slim_algo_from_range_image(&out, &f_cfg, MIN_RANGE_BIN, &arr);
+        check_slim(n_frames, "slim_algo_push_chirps", &out, &expected.slim, &f32_tol);
+
+        /* Fixed point, both entry points */
+        slim_algo_q15_load_raw_frame(raw, &f_cfg, &arr_q15);
+        slim_algo_q15_from_range_image(&out, &f_cfg, MIN_RANGE_BIN, &arr_q15);
+        check_slim(n_frames, "slim_algo_q15_load_raw_frame", &out, &expected.slim, &q15_tol);
+
+        for (uint16_t chirp = 0; chirp < FIXTURE_N_CHIRPS; chirp += CHIRPS_PER_GROUP)
+        {
+            slim_algo_q15_push_chirps(raw + chirp * FIXTURE_N_SAMPLES * FIXTURE_N_CHANNELS,
+                                      chirp, CHIRPS_PER_GROUP, &f_cfg, &arr_q15);
+        }
+        slim_algo_q15_from_range_image(&out, &f_cfg, MIN_RANGE_BIN, &arr_q15);
+        check_slim(n_frames, "slim_algo_q15_push_chirps", &out, &expected.slim, &q15_tol);
+
+        /* The CFAR windows are clipped to the search region, so `algo_roi`
+        *  gives exactly the output of `algo` in every mode */
+        for (int mode = 0; mode < ALGO_N_MODES; ++mode)
+        {
+            fixture_deinterleave(raw, frame);
+            memset(&algo_out, 0, sizeof(algo_out));
+            algo_roi(&algo_out, frame, &f_cfg, &h_cfg_roi[mode], ALGO_BAND_MIN, ALGO_BAND_MAX,
+                     ALGO_BAND_OFFSET, ALGO_RANGE_MIN, ALGO_GUARD_RANGE, ALGO_GUARD_DOPPLER,
+                     DETECTION_MODE_CLOSEST, ALGO_THRESHOLD, algo_modes[mode]);
+            check_algo(n_frames, algo_roi_names[mode], &algo_out, &expected.algo[mode]);
+            report(memcmp(&algo_out, &ref.algo[mode], sizeof(algo_out)) == 0, n_frames,
+                   algo_roi_names[mode]);
+        }
+
+        n_frames++;
+    }
+
+    free_preproc_octobertech_q15_work_arrays(&arr_q15);
+    free_preproc_octobertech_work_arrays(&arr);
+    scratch_arena_free();
+    fclose(fixture);
+    fclose(golden);
+
+    if (status < 0)
+    {
+        printf("FAIL %s: truncated frame after %u frames\n", argv[1], (unsigned)n_frames);
+        return 2;
+    }
+    if (update)
+    {
+        printf("%s: %u frames written\n", argv[2], (unsigned)n_frames);
+        return 0;
+    }
+    printf("%s: %u frames, %u checks, %u failures\n", argv[1], (unsigned)n_frames,
+           (unsigned)n_checks, (unsigned)n_failures);
+    return ((n_failures == 0) && (n_frames > 0)) ? 0 : 1;
+}
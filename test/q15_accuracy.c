@@ -0,0 +1,256 @@
+/******************************************************************************
+* File Name:   q15_accuracy.c
+*
+* Description: This file compares the fixed-point slim_algo with the float32
+*   one on recorded or synthetic radar frames and reports the error against
+*   the bound documented in octobertech_q15.h.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "fixtures.h"
+#include "octobertech.h"
+#include "octobertech_q15.h"
+#include "scratch_arena.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define MIN_RANGE_BIN           (3)
+#define CHIRPS_PER_GROUP        (8)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+/* Error of the fixed-point `slim_algo` against the float32 one over a series
+*  of frames, see the bound in octobertech_q15.h. Bins and angles are only
+*  bounded for detections above Q15_BOUND_MIN_VALUE ("strong" frames). */
+typedef struct {
+    uint32_t frames;
+    uint32_t success_mismatch;
+    uint32_t value_over_bound;
+    uint32_t strong;
+    uint32_t bin_mismatch;
+    uint32_t angle_over_bound;
+    float max_value_error;
+    float max_angle_error;
+} q15_error_report;
+
+/*******************************************************************************
+* Function Name: q15_error_add
+********************************************************************************
+* Summary:
+*   Adds one frame to a fixed-point error report, `f32` and `q15` are the
+*   results of the float32 and the fixed-point `slim_algo` for the same frame.
+*
+* Parameters:
+*  report : Report to update, zero initialized before the first frame.
+*  f32    : Output of the float32 `slim_algo`.
+*  q15    : Output of the fixed-point `slim_algo`.
+*
+*******************************************************************************/
+static void q15_error_add(
+    q15_error_report *report, const slim_algo_output *f32, const slim_algo_output *q15
+)
+{
+    const slim_algo_detection *ref = &f32->detection;
+    const slim_algo_detection *fix = &q15->detection;
+    float value_error = fabsf(fix->value - ref->value);
+
+    report->frames++;
+    if (f32->success != q15->success)
+    {
+        report->success_mismatch++;
+    }
+    if (value_error > report->max_value_error)
+    {
+        report->max_value_error = value_error;
+    }
+    if (value_error >= Q15_BOUND_VALUE)
+    {
+        report->value_over_bound++;
+    }
+
+    if (ref->value <= Q15_BOUND_MIN_VALUE)
+    {
+        return;
+    }
+    report->strong++;
+    if ((fix->range_bin != ref->range_bin) || (fix->doppler_bin != ref->doppler_bin))
+    {
+        report->bin_mismatch++;
+    }
+    float angle_error = fmaxf(fabsf(fix->azimuth - ref->azimuth),
+                              fabsf(fix->elevation - ref->elevation));
+    if (angle_error > report->max_angle_error)
+    {
+        report->max_angle_error = angle_error;
+    }
+    if (angle_error >= Q15_BOUND_ANGLE)
+    {
+        report->angle_over_bound++;
+    }
+}
+
+static bool q15_error_within_bound(const q15_error_report *report)
+{
+    return (report->success_mismatch == 0) && (report->value_over_bound == 0) &&
+           (report->bin_mismatch == 0) && (report->angle_over_bound == 0);
+}
+
+static void q15_error_print(const q15_error_report *report)
+{
+    printf("q15 error: %lu frames, %lu success mismatches, value max %.3g (bound %.3g), "
+           "%lu over\n",
+           (unsigned long)report->frames, (unsigned long)report->success_mismatch,
+           (double)report->max_value_error, (double)Q15_BOUND_VALUE,
+           (unsigned long)report->value_over_bound);
+    printf("  %lu frames with value > %.3g: %lu bin mismatches, angle max %.3g rad "
+           "(bound %.3g), %lu over\n",
+           (unsigned long)report->strong, (double)Q15_BOUND_MIN_VALUE,
+           (unsigned long)report->bin_mismatch, (double)report->max_angle_error,
+           (double)Q15_BOUND_ANGLE, (unsigned long)report->angle_over_bound);
+}
+
+/*******************************************************************************
+* Function Name: compare_fixture
+********************************************************************************
+* Summary:
+*   Runs every frame of a fixture through the float32 and the fixed-point
+*   `slim_algo`, both fed the raw frame like radar.c does, and adds the
+*   outputs to the reports. The fixed-point streaming path is compared too.
+*
+* Return:
+*  Number of frames, -1 if the file cannot be read.
+*
+*******************************************************************************/
+static int32_t compare_fixture(const char *path, q15_error_report *frame_report,
+                               q15_error_report *stream_report, frame_cfg *f_cfg,
+                               preproc_octobertech_work_arrays *arr,
+                               preproc_octobertech_q15_work_arrays *arr_q15)
+{
+    static uint16_t raw[FIXTURE_FRAME_WORDS];
+    FILE *fixture = fopen(path, "rb");
+    int32_t n_frames = 0;
+    int32_t status;
+
+    if (NULL == fixture)
+    {
+        perror(path);
+        return -1;
+    }
+
+    while ((status = fixture_read_frame(fixture, raw)) == 1)
+    {
+        slim_algo_output f32;
+        slim_algo_output q15;
+
+        slim_algo_load_raw_frame(raw, f_cfg, arr);
+        slim_algo_from_range_image(&f32, f_cfg, MIN_RANGE_BIN, arr);
+
+        slim_algo_q15_load_raw_frame(raw, f_cfg, arr_q15);
+        slim_algo_q15_from_range_image(&q15, f_cfg, MIN_RANGE_BIN, arr_q15);
+        q15_error_add(frame_report, &f32, &q15);
+
+        for (uint16_t chirp = 0; chirp < FIXTURE_N_CHIRPS; chirp += CHIRPS_PER_GROUP)
+        {
+            slim_algo_q15_push_chirps(raw + chirp * FIXTURE_N_SAMPLES * FIXTURE_N_CHANNELS,
+                                      chirp, CHIRPS_PER_GROUP, f_cfg, arr_q15);
+        }
+        slim_algo_q15_from_range_image(&q15, f_cfg, MIN_RANGE_BIN, arr_q15);
+        q15_error_add(stream_report, &f32, &q15);
+
+        n_frames++;
+    }
+    fclose(fixture);
+
+    if (status < 0)
+    {
+        printf("%s: truncated frame after %d frames\n", path, (int)n_frames);
+        return -1;
+    }
+    return n_frames;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************/
+int main(int argc, char *argv[])
+{
+    frame_cfg f_cfg = {
+        .n_channels = FIXTURE_N_CHANNELS,
+        .n_chirps = FIXTURE_N_CHIRPS,
+        .n_samples = FIXTURE_N_SAMPLES,
+        .n_range_bins = FIXTURE_N_SAMPLES / 2
+    };
+    q15_error_report frame_report = {0};
+    q15_error_report stream_report = {0};
+    bool ok = true;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <fixture.frames>...\n", argv[0]);
+        return 2;
+    }
+
+    preproc_octobertech_work_arrays arr = new_preproc_octobertech_work_arrays(&f_cfg);
+    preproc_octobertech_q15_work_arrays arr_q15 = new_preproc_octobertech_q15_work_arrays(&f_cfg);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (compare_fixture(argv[i], &frame_report, &stream_report, &f_cfg, &arr, &arr_q15) < 0)
+        {
+            ok = false;
+        }
+    }
+
+    free_preproc_octobertech_q15_work_arrays(&arr_q15);
+    free_preproc_octobertech_work_arrays(&arr);
+    scratch_arena_free();
+
+    printf("slim_algo_q15_load_raw_frame\n");
+    q15_error_print(&frame_report);
+    printf("slim_algo_q15_push_chirps\n");
+    q15_error_print(&stream_report);
+
+    ok = ok && q15_error_within_bound(&frame_report) &&
+         q15_error_within_bound(&stream_report);
+    printf("%s\n", ok ? "within the bound of octobertech_q15.h" : "FAIL: bound exceeded");
+    return ok ? 0 : 1;
+}
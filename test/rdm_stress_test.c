@@ -0,0 +1,522 @@
+/******************************************************************************
+* File Name:   rdm_stress_test.c
+*
+* Description: This file stress tests the radar data manager with several
+*   instances used from concurrent threads. More workers than
+*   RDM_MAX_INSTANCES initialize, feed, read and de-initialize their own manager
+*   for a number of rounds, so the entries of the instance pool are claimed and
+*   released concurrently. Every readout carries a pattern of its worker, round
+*   and sequence number that the subscribers check.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* sem_t, clock_gettime() and posix_memalign() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "task.h"
+#include "xensiv_radar_data_management.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* More workers than pool entries, so that some of them find the pool full */
+#define N_WORKERS           (RDM_MAX_INSTANCES + 2)
+#define N_SUBSCRIBERS       (2)
+#define N_ROUNDS            (8U)
+#define READOUTS_PER_ROUND  (400U)
+
+#define FILL_LEVEL          (4096U)
+#define WORDS_PER_READOUT   (FILL_LEVEL / 4U)
+#define RING_SLOTS          (8U)
+#define BUFFER_SIZE         (FILL_LEVEL * RING_SLOTS)
+#define STORAGE_SIZE        RDM_STORAGE_SIZE(FILL_LEVEL, RING_SLOTS)
+
+/* Give up on a pool entry that does not come free, e.g. one leaked by deinit */
+#define POOL_TIMEOUT_S      (10.0)
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+/*******************************************************************************
+* Types
+********************************************************************************/
+typedef struct worker_s worker_s;
+
+/* A subscriber task: a thread woken by the notifications of its manager */
+typedef struct {
+    worker_s *worker;
+    radar_data_policy_e policy;
+    int32_t id;
+    sem_t wake;
+    pthread_t thread;
+    uint32_t slots;         /* Slots read in the round */
+    uint32_t last;          /* Sequence number of the last slot read */
+    uint32_t notifications;
+} subscriber_s;
+
+/* Owns one manager and writes its readouts, like the radar interrupt */
+struct worker_s {
+    uint32_t index;
+    radar_data_manager_s mgr;
+    uint8_t *storage;
+    uint32_t salt;          /* Of the current round */
+    uint32_t written;       /* Readouts stored in the current round */
+    bool done;              /* All readouts of the round are stored */
+    subscriber_s sub[N_SUBSCRIBERS];
+    uint32_t pool_full;     /* Initializations that found the pool full */
+    pthread_t thread;
+};
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static worker_s workers[N_WORKERS];
+/* The worker of the calling thread, for write_readout() */
+static pthread_key_t writer_key;
+
+static pthread_mutex_t test_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t live_instances;
+static uint32_t max_live_instances;
+static uint32_t n_checks;
+static uint32_t n_failures;
+
+/*******************************************************************************
+* Function Name: check
+********************************************************************************
+* Summary:
+*   Counts a check and reports it if it failed. Called from every thread.
+*
+*******************************************************************************/
+static void check(bool ok, const char *what, int line)
+{
+    pthread_mutex_lock(&test_lock);
+    n_checks++;
+    if (!ok)
+    {
+        n_failures++;
+        printf("FAIL line %d: %s\n", line, what);
+    }
+    pthread_mutex_unlock(&test_lock);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Word i of readout seq: unique per worker and round */
+static uint32_t pattern(uint32_t salt, uint32_t seq, uint32_t i)
+{
+    return (seq * WORDS_PER_READOUT + i) ^ salt;
+}
+
+static void count_live(int32_t delta)
+{
+    pthread_mutex_lock(&test_lock);
+    live_instances += (uint32_t)delta;
+    if (live_instances > max_live_instances)
+    {
+        max_live_instances = live_instances;
+    }
+    pthread_mutex_unlock(&test_lock);
+}
+
+/*******************************************************************************
+* Radar and RTOS stand-ins
+********************************************************************************/
+/* in_read_radar_data of every manager: one readout of the calling worker */
+static int32_t write_readout(uint16_t *data, uint32_t *num_samples, uint32_t samples_ub)
+{
+    worker_s *worker = (worker_s *)pthread_getspecific(writer_key);
+    uint32_t *words = (uint32_t *)data;
+
+    if (samples_ub < FILL_LEVEL)
+    {
+        *num_samples = 0;
+        return RDM_EOP_CANNOT_COMPLETE;
+    }
+
+    for (uint32_t i = 0; i < WORDS_PER_READOUT; ++i)
+    {
+        words[i] = pattern(worker->salt, worker->written, i);
+    }
+    worker->written++;
+    *num_samples = FILL_LEVEL;
+    return 0;
+}
+
+/* The task handles are the subscribers */
+static void notify(TaskHandle_t task, bool from_isr)
+{
+    subscriber_s *subscriber = (subscriber_s *)task;
+
+    (void)from_isr;
+    subscriber->notifications++;
+    sem_post(&subscriber->wake);
+}
+
+/*******************************************************************************
+* Function Name: drain
+********************************************************************************
+* Summary:
+*   Reads every available slot of a subscriber and checks its pattern. A
+*   blocking subscriber must see every readout in sequence, an overwrite-oldest
+*   one readouts in increasing order.
+*
+* Return:
+*  Number of slots read.
+*
+*******************************************************************************/
+static uint32_t drain(subscriber_s *subscriber)
+{
+    worker_s *worker = subscriber->worker;
+    uint32_t slots = 0;
+    uint16_t *data;
+    uint32_t size;
+
+    while (worker->mgr.read_from_buffer(subscriber->id, &data, &size) == 0)
+    {
+        const uint32_t *words = (const uint32_t *)data;
+        uint32_t seq = (words[0] ^ worker->salt) / WORDS_PER_READOUT;
+        bool intact = (size == FILL_LEVEL) && (seq < READOUTS_PER_ROUND);
+
+        for (uint32_t i = 0; intact && (i < WORDS_PER_READOUT); ++i)
+        {
+            intact = (words[i] == pattern(worker->salt, seq, i));
+        }
+        CHECK(intact);
+        if (subscriber->policy == RDM_POLICY_BLOCK)
+        {
+            CHECK(seq == subscriber->slots);
+        }
+        else
+        {
+            CHECK((subscriber->slots == 0) || (seq > subscriber->last));
+        }
+        subscriber->last = seq;
+        subscriber->slots++;
+        slots++;
+        worker->mgr.ack_data_read(subscriber->id);
+
+        /* Fall behind now and then, so that the buffer runs full */
+        if ((subscriber->policy == RDM_POLICY_BLOCK) && ((seq % 16U) == 0))
+        {
+            sched_yield();
+        }
+    }
+    return slots;
+}
+
+static bool round_done(worker_s *worker)
+{
+    bool done;
+
+    taskENTER_CRITICAL();
+    done = worker->done;
+    taskEXIT_CRITICAL();
+    return done;
+}
+
+static void *subscriber_task(void *arg)
+{
+    subscriber_s *subscriber = (subscriber_s *)arg;
+
+    for (;;)
+    {
+        bool done = round_done(subscriber->worker);
+
+        if (drain(subscriber) == 0)
+        {
+            if (done)
+            {
+                break;
+            }
+            sem_wait(&subscriber->wake);
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: open_manager
+********************************************************************************
+* Summary:
+*   Initializes the manager of a worker, on allocated storage in even rounds
+*   and on the worker's own storage in odd ones. Retries while all pool
+*   entries are in use.
+*
+*******************************************************************************/
+static bool open_manager(worker_s *worker, uint32_t round)
+{
+    double t_start = now_s();
+    int32_t result;
+
+    for (;;)
+    {
+        if ((round % 2U) == 0)
+        {
+            result = radar_data_manager_init(&worker->mgr, BUFFER_SIZE, FILL_LEVEL);
+        }
+        else
+        {
+            result = radar_data_manager_init_static(&worker->mgr, worker->storage,
+                                                    STORAGE_SIZE, FILL_LEVEL);
+        }
+        if ((result != -2) || ((now_s() - t_start) > POOL_TIMEOUT_S))
+        {
+            break;
+        }
+        worker->pool_full++;
+        sched_yield();
+    }
+
+    CHECK(result == 0);
+    if (result == 0)
+    {
+        count_live(1);
+    }
+    return (result == 0);
+}
+
+/*******************************************************************************
+* Function Name: run_round
+********************************************************************************
+* Summary:
+*   Writes READOUTS_PER_ROUND readouts to a blocking and an overwrite-oldest
+*   subscriber and checks the statistics of the manager afterwards.
+*
+*******************************************************************************/
+static void run_round(worker_s *worker)
+{
+    radar_data_manager_stats_s stats;
+
+    worker->written = 0;
+    worker->done = false;
+
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        subscriber_s *subscriber = &worker->sub[i];
+
+        subscriber->slots = 0;
+        subscriber->notifications = 0;
+        sem_init(&subscriber->wake, 0, 0);
+        subscriber->id = worker->mgr.subscribe((TaskHandle_t)subscriber);
+        CHECK(subscriber->id > 0);
+        CHECK(worker->mgr.set_policy(subscriber->id, subscriber->policy) == 0);
+        pthread_create(&subscriber->thread, NULL, subscriber_task, subscriber);
+    }
+
+    while (worker->written < READOUTS_PER_ROUND)
+    {
+        uint32_t written = worker->written;
+
+        /* An interrupt is not preempted by the subscriber tasks */
+        taskENTER_CRITICAL();
+        worker->mgr.run(true);
+        taskEXIT_CRITICAL();
+
+        if (worker->written == written)
+        {
+            sched_yield();
+        }
+    }
+
+    taskENTER_CRITICAL();
+    worker->done = true;
+    taskEXIT_CRITICAL();
+
+    for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+    {
+        subscriber_s *subscriber = &worker->sub[i];
+        radar_data_subscriber_stats_s sub_stats;
+
+        sem_post(&subscriber->wake);
+        pthread_join(subscriber->thread, NULL);
+        sem_destroy(&subscriber->wake);
+
+        CHECK(worker->mgr.get_stats(subscriber->id, &sub_stats) == 0);
+        CHECK(sub_stats.slots_read == subscriber->slots);
+        CHECK(sub_stats.lag == 0);
+        CHECK(subscriber->notifications > 0);
+        if (subscriber->policy == RDM_POLICY_BLOCK)
+        {
+            CHECK(subscriber->slots == READOUTS_PER_ROUND);
+            CHECK(sub_stats.drops == 0);
+        }
+        else
+        {
+            CHECK(subscriber->slots + sub_stats.drops == READOUTS_PER_ROUND);
+        }
+        worker->mgr.unsubscribe(subscriber->id);
+    }
+
+    worker->mgr.get_buffer_stats(&stats);
+    CHECK(stats.readouts == READOUTS_PER_ROUND);
+    CHECK(stats.read_errors == 0);
+}
+
+static void *worker_task(void *arg)
+{
+    worker_s *worker = (worker_s *)arg;
+
+    pthread_setspecific(writer_key, worker);
+
+    for (uint32_t round = 0; round < N_ROUNDS; ++round)
+    {
+        worker->salt = (worker->index + 1U) * 0x9E3779B9U + round * 0x85EBCA6BU;
+        if (!open_manager(worker, round))
+        {
+            break;
+        }
+
+        run_round(worker);
+
+        count_live(-1);
+        CHECK(radar_data_manager_deinit(&worker->mgr) == 0);
+        /* The entry is gone, a second deinit must not find it */
+        CHECK(radar_data_manager_deinit(&worker->mgr) == -2);
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_pool
+********************************************************************************
+* Summary:
+*   Single threaded: all RDM_MAX_INSTANCES entries can be used at the same
+*   time, one more or a second init of the same interface is refused, and an
+*   entry released by deinit can be claimed again.
+*
+*******************************************************************************/
+static void test_pool(void)
+{
+    radar_data_manager_s mgr[RDM_MAX_INSTANCES + 1];
+
+    memset(mgr, 0, sizeof(mgr));
+    for (int32_t i = 0; i <= RDM_MAX_INSTANCES; ++i)
+    {
+        mgr[i].in_read_radar_data = write_readout;
+    }
+
+    for (int32_t i = 0; i < RDM_MAX_INSTANCES; ++i)
+    {
+        CHECK(radar_data_manager_init(&mgr[i], BUFFER_SIZE, FILL_LEVEL) == 0);
+    }
+    CHECK(radar_data_manager_init(&mgr[RDM_MAX_INSTANCES], BUFFER_SIZE, FILL_LEVEL) == -2);
+    CHECK(radar_data_manager_init(&mgr[0], BUFFER_SIZE, FILL_LEVEL) == -2);
+
+    CHECK(radar_data_manager_deinit(&mgr[0]) == 0);
+    CHECK(radar_data_manager_init(&mgr[RDM_MAX_INSTANCES], BUFFER_SIZE, FILL_LEVEL) == 0);
+    CHECK(radar_data_manager_init(&mgr[0], BUFFER_SIZE, FILL_LEVEL) == -2);
+
+    for (int32_t i = 1; i <= RDM_MAX_INSTANCES; ++i)
+    {
+        CHECK(radar_data_manager_deinit(&mgr[i]) == 0);
+    }
+    CHECK(radar_data_manager_deinit(&mgr[0]) == -2);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************/
+int main(void)
+{
+    uint32_t pool_full = 0;
+    double t_start;
+    double elapsed;
+    double mbytes;
+
+    pthread_key_create(&writer_key, NULL);
+    host_rtos_set_notify_hook(notify);
+
+    test_pool();
+
+    for (uint32_t w = 0; w < N_WORKERS; ++w)
+    {
+        worker_s *worker = &workers[w];
+        void *storage = NULL;
+
+        CHECK(posix_memalign(&storage, RDM_STORAGE_ALIGN, STORAGE_SIZE) == 0);
+        worker->index = w;
+        worker->storage = (uint8_t *)storage;
+        worker->mgr.in_read_radar_data = write_readout;
+        worker->sub[0].policy = RDM_POLICY_BLOCK;
+        worker->sub[1].policy = RDM_POLICY_OVERWRITE_OLDEST;
+        for (int32_t i = 0; i < N_SUBSCRIBERS; ++i)
+        {
+            worker->sub[i].worker = worker;
+        }
+    }
+
+    t_start = now_s();
+    for (uint32_t w = 0; w < N_WORKERS; ++w)
+    {
+        pthread_create(&workers[w].thread, NULL, worker_task, &workers[w]);
+    }
+    for (uint32_t w = 0; w < N_WORKERS; ++w)
+    {
+        pthread_join(workers[w].thread, NULL);
+        pool_full += workers[w].pool_full;
+        free(workers[w].storage);
+    }
+    elapsed = now_s() - t_start;
+
+    CHECK(live_instances == 0);
+    CHECK(max_live_instances <= RDM_MAX_INSTANCES);
+
+    /* Every entry must be free again */
+    test_pool();
+
+    mbytes = (double)N_WORKERS * N_ROUNDS * READOUTS_PER_ROUND * FILL_LEVEL / 1e6;
+    printf("rdm_stress: %d workers on %d instances, %u rounds of %u readouts, "
+           "pool full %u times, at most %u live\n",
+           N_WORKERS, RDM_MAX_INSTANCES, (unsigned)N_ROUNDS, (unsigned)READOUTS_PER_ROUND,
+           (unsigned)pool_full, (unsigned)max_live_instances);
+    printf("rdm_stress: %.1f MB in %.3f s, %.0f MB/s\n", mbytes, elapsed, mbytes / elapsed);
+    printf("rdm_stress: %u checks, %u failures\n", (unsigned)n_checks, (unsigned)n_failures);
+    return (n_failures == 0) ? 0 : 1;
+}